@@ -0,0 +1,192 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace WW
+{
+namespace bench
+{
+
+/**
+ * @brief 延迟直方图
+ * @details 与HdrHistogram相同的对数线性分桶：值按最高位分组，每组再等分为固定个数的子桶，
+ * 任何量级的值相对误差都不超过1/2^(SUB_BUCKET_BITS-1)。记录一个值只需要一次取最高位和一次自增，
+ * 多个线程各自记录，结束后再合并
+ */
+class latency_histogram
+{
+public:
+    static constexpr int SUB_BUCKET_BITS = 10;                                      // 子桶位数，相对误差约0.2%
+    static constexpr std::uint64_t SUB_BUCKET_HALF = 1ull << (SUB_BUCKET_BITS - 1); // 每组的子桶个数
+    static constexpr std::size_t BUCKET_COUNT = (66 - SUB_BUCKET_BITS) * SUB_BUCKET_HALF;
+
+private:
+    std::vector<std::uint64_t> _Counts;     // 每个桶的计数
+    std::uint64_t _Total;                   // 记录的个数
+    std::uint64_t _Sum;                     // 记录的值之和
+    std::uint64_t _Min;                     // 最小值
+    std::uint64_t _Max;                     // 最大值
+
+public:
+    latency_histogram()
+        : _Counts(BUCKET_COUNT, 0)
+        , _Total(0)
+        , _Sum(0)
+        , _Min(static_cast<std::uint64_t>(-1))
+        , _Max(0)
+    {
+    }
+
+public:
+    /**
+     * @brief 记录一个值
+     * @param _Value 值
+     */
+    void record(std::uint64_t _Value) noexcept
+    {
+        ++_Counts[_Index_of(_Value)];
+        ++_Total;
+        _Sum += _Value;
+        _Min = _Value < _Min ? _Value : _Min;
+        _Max = _Value > _Max ? _Value : _Max;
+    }
+
+    /**
+     * @brief 合并另一个直方图
+     * @param _Other 直方图
+     */
+    void merge(const latency_histogram & _Other) noexcept
+    {
+        for (std::size_t _Index = 0; _Index < BUCKET_COUNT; ++_Index) {
+            _Counts[_Index] += _Other._Counts[_Index];
+        }
+
+        _Total += _Other._Total;
+        _Sum += _Other._Sum;
+        _Min = _Other._Min < _Min ? _Other._Min : _Min;
+        _Max = _Other._Max > _Max ? _Other._Max : _Max;
+    }
+
+    /**
+     * @brief 获取记录的个数
+     * @return 个数
+     */
+    std::uint64_t count() const noexcept
+    {
+        return _Total;
+    }
+
+    /**
+     * @brief 获取最小值
+     * @return 最小值，没有记录时为0
+     */
+    std::uint64_t min() const noexcept
+    {
+        return _Total == 0 ? 0 : _Min;
+    }
+
+    /**
+     * @brief 获取最大值
+     * @return 最大值
+     */
+    std::uint64_t max() const noexcept
+    {
+        return _Max;
+    }
+
+    /**
+     * @brief 获取平均值
+     * @return 平均值
+     */
+    double mean() const noexcept
+    {
+        return _Total == 0 ? 0.0 : static_cast<double>(_Sum) / static_cast<double>(_Total);
+    }
+
+    /**
+     * @brief 获取百分位数
+     * @details 返回第一个累计计数达到要求的桶所能表示的最大值，与HdrHistogram一致，不会低估
+     * @param _Percent 百分比，范围为[0, 100]
+     * @return 百分位数
+     */
+    std::uint64_t percentile(double _Percent) const noexcept
+    {
+        if (_Total == 0) {
+            return 0;
+        }
+
+        double _Rank = _Percent / 100.0 * static_cast<double>(_Total);
+        std::uint64_t _Target = static_cast<std::uint64_t>(_Rank);
+        if (static_cast<double>(_Target) < _Rank || _Target == 0) {
+            ++_Target;
+        }
+
+        std::uint64_t _Seen = 0;
+        for (std::size_t _Index = 0; _Index < BUCKET_COUNT; ++_Index) {
+            _Seen += _Counts[_Index];
+            if (_Seen >= _Target) {
+                std::uint64_t _Highest = _Highest_of(_Index);
+                return _Highest < _Max ? _Highest : _Max;
+            }
+        }
+
+        return _Max;
+    }
+
+private:
+    /**
+     * @brief 计算值所在的桶
+     * @details 小于2^SUB_BUCKET_BITS的值各占一个桶；更大的值右移g位落到[HALF, 2*HALF)，
+     * 第g组从(g+1)*HALF开始
+     * @param _Value 值
+     * @return 桶下标
+     */
+    static std::size_t _Index_of(std::uint64_t _Value) noexcept
+    {
+        int _Shift = _Bit_width(_Value) - SUB_BUCKET_BITS;
+        if (_Shift <= 0) {
+            return static_cast<std::size_t>(_Value);
+        }
+
+        return static_cast<std::size_t>((_Shift + 1) * SUB_BUCKET_HALF + ((_Value >> _Shift) - SUB_BUCKET_HALF));
+    }
+
+    /**
+     * @brief 计算桶能表示的最大值
+     * @param _Index 桶下标
+     * @return 最大值
+     */
+    static std::uint64_t _Highest_of(std::size_t _Index) noexcept
+    {
+        if (_Index < 2 * SUB_BUCKET_HALF) {
+            return _Index;
+        }
+
+        std::uint64_t _Shift = _Index / SUB_BUCKET_HALF - 1;
+        std::uint64_t _Sub = _Index % SUB_BUCKET_HALF + SUB_BUCKET_HALF;
+        return ((_Sub + 1) << _Shift) - 1;
+    }
+
+    /**
+     * @brief 计算表示一个整数需要的位数
+     * @param _Value 整数
+     * @return 位数，0为0
+     */
+    static int _Bit_width(std::uint64_t _Value) noexcept
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return _Value == 0 ? 0 : 64 - __builtin_clzll(_Value);
+#else
+        int _Width = 0;
+        for (; _Value != 0; _Value >>= 1) {
+            ++_Width;
+        }
+        return _Width;
+#endif
+    }
+};
+
+} // namespace bench
+} // namespace WW
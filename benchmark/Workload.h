@@ -0,0 +1,199 @@
+#pragma once
+
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+
+namespace WW
+{
+namespace bench
+{
+
+/**
+ * @brief Zipf分布的随机数生成器
+ * @details Gray等人的算法，YCSB使用相同的方法，常数theta越大访问越集中
+ */
+class zipfian_generator
+{
+private:
+    std::uint64_t _Count;       // 取值个数
+    double _Theta;              // 偏斜常数
+    double _Alpha;
+    double _Zetan;
+    double _Eta;
+    std::mt19937_64 _Engine;
+    std::uniform_real_distribution<double> _Uniform;
+
+public:
+    zipfian_generator(std::uint64_t _Count, double _Theta, std::uint64_t _Seed)
+        : _Count(_Count)
+        , _Theta(_Theta)
+        , _Alpha(1.0 / (1.0 - _Theta))
+        , _Zetan(_Zeta(_Count, _Theta))
+        , _Eta((1.0 - std::pow(2.0 / _Count, 1.0 - _Theta)) / (1.0 - _Zeta(2, _Theta) / _Zetan))
+        , _Engine(_Seed)
+        , _Uniform(0.0, 1.0)
+    {
+    }
+
+public:
+    /**
+     * @brief 生成[0, _Count)之间的随机数，越小越热
+     * @return 随机数
+     */
+    std::uint64_t operator()()
+    {
+        double _U = _Uniform(_Engine);
+        double _Uz = _U * _Zetan;
+
+        if (_Uz < 1.0) {
+            return 0;
+        }
+
+        if (_Uz < 1.0 + std::pow(0.5, _Theta)) {
+            return 1;
+        }
+
+        std::uint64_t _Value = static_cast<std::uint64_t>(_Count * std::pow(_Eta * _U - _Eta + 1.0, _Alpha));
+        return _Value < _Count ? _Value : _Count - 1;
+    }
+
+private:
+    static double _Zeta(std::uint64_t _Count, double _Theta)
+    {
+        double _Sum = 0;
+        for (std::uint64_t _Index = 1; _Index <= _Count; ++_Index) {
+            _Sum += 1.0 / std::pow(static_cast<double>(_Index), _Theta);
+        }
+        return _Sum;
+    }
+};
+
+/**
+ * @brief 均匀分布或Zipf分布的键序号生成器
+ * @details Zipf分布的序号经过打散，热点键在键空间中不相邻
+ */
+class key_chooser
+{
+private:
+    std::uint64_t _Count;           // 键个数
+    bool _Skewed;                   // 是否为Zipf分布
+    std::mt19937_64 _Engine;
+    zipfian_generator _Zipf;
+
+public:
+    key_chooser(std::uint64_t _Count, bool _Skewed, std::uint64_t _Seed, double _Theta = 0.99)
+        : _Count(_Count)
+        , _Skewed(_Skewed)
+        , _Engine(_Seed)
+        , _Zipf(_Skewed ? _Count : 2, _Theta, _Seed)
+    {
+    }
+
+public:
+    /**
+     * @brief 生成[0, _Count)之间的键序号
+     * @return 序号
+     */
+    std::uint64_t operator()()
+    {
+        if (!_Skewed) {
+            return _Engine() % _Count;
+        }
+
+        return _Zipf() * 0x9E3779B97F4A7C15ull % _Count;
+    }
+};
+
+/**
+ * @brief 已确认插入的键序号上限
+ * @details 与YCSB的AcknowledgedCounterGenerator相同。并发插入可能乱序完成，
+ * 只有一个序号之前的插入全部完成后，上限才越过它，按上限选键时不会读到尚未插入的键。
+ * 已完成但尚未连续的序号记在环形窗口中，超出窗口的插入等待较早的插入完成
+ */
+class acknowledged_counter
+{
+private:
+    static constexpr std::uint64_t WINDOW = 1 << 16;
+
+    std::unique_ptr<std::atomic<bool>[]> _Window;   // 序号对应的插入是否已完成
+    std::atomic<std::uint64_t> _Limit;              // 小于该值的序号都已完成
+    std::mutex _Mutex;                              // 同一时刻只有一个线程推进上限
+
+public:
+    explicit acknowledged_counter(std::uint64_t _Start)
+        : _Window(new std::atomic<bool>[WINDOW]())
+        , _Limit(_Start)
+    {
+    }
+
+public:
+    /**
+     * @brief 当前上限
+     * @return 小于该值的序号都已完成插入
+     */
+    std::uint64_t limit() const noexcept
+    {
+        return _Limit.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief 确认一个序号的插入已完成，并尽量推进上限
+     * @param _Index 序号，不小于构造时的起点且每个只确认一次
+     */
+    void acknowledge(std::uint64_t _Index)
+    {
+        while (_Index - limit() >= WINDOW) {
+            std::this_thread::yield();
+        }
+
+        _Window[_Index % WINDOW].store(true);
+
+        // 拿不到锁时由持有锁的线程推进，它释放锁后会再检查一次，确认不会遗漏
+        for (;;) {
+            std::unique_lock<std::mutex> _Lock(_Mutex, std::try_to_lock);
+            if (!_Lock.owns_lock()) {
+                return;
+            }
+
+            std::uint64_t _Next = _Limit.load(std::memory_order_relaxed);
+            while (_Window[_Next % WINDOW].load()) {
+                _Window[_Next % WINDOW].store(false, std::memory_order_relaxed);
+                ++_Next;
+            }
+
+            _Limit.store(_Next, std::memory_order_release);
+            _Lock.unlock();
+
+            if (!_Window[_Next % WINDOW].load()) {
+                return;
+            }
+        }
+    }
+};
+
+/**
+ * @brief 生成第_Index个定长字符串键，按序号的顺序即为键的字典序
+ * @param _Index 序号
+ * @param _Size 键长度，至少为20
+ * @return 键
+ */
+inline std::string make_key(std::uint64_t _Index, std::size_t _Size = 20)
+{
+    std::string _Key(_Size < 20 ? 20 : _Size, '0');
+
+    for (std::size_t _Pos = _Key.size(); _Index != 0; _Index /= 10) {
+        _Key[--_Pos] = static_cast<char>('0' + _Index % 10);
+    }
+
+    _Key[0] = 'k';
+    return _Key;
+}
+
+} // namespace bench
+} // namespace WW
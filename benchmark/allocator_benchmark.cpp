@@ -0,0 +1,327 @@
+#include <atomic>
+#include <cstdio>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+#include <malloc.h>
+#include <unistd.h>
+
+#include <benchmark/benchmark.h>
+#include <PoolAllocator.h>
+#include <SkipList.h>
+
+namespace
+{
+
+std::atomic<std::size_t> allocation_count(0);     // 全局operator new调用次数
+
+/**
+ * @brief 计数并分配内存，替换的全局operator new都经过这里
+ * @param _Size 字节数
+ * @param _Align 对齐
+ * @return 内存地址，失败时为nullptr
+ */
+void * counted_allocate_nothrow(std::size_t _Size, std::size_t _Align) noexcept
+{
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+
+    if (_Align <= alignof(std::max_align_t)) {
+        return std::malloc(_Size == 0 ? 1 : _Size);
+    }
+
+    // aligned_alloc要求大小是对齐的整数倍
+    return std::aligned_alloc(_Align, (_Size + _Align - 1) / _Align * _Align);
+}
+
+/**
+ * @brief 计数并分配内存，失败时抛出`std::bad_alloc`
+ * @param _Size 字节数
+ * @param _Align 对齐
+ * @return 内存地址
+ */
+void * counted_allocate(std::size_t _Size, std::size_t _Align)
+{
+    void * _Ptr = counted_allocate_nothrow(_Size, _Align);
+    if (_Ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+
+    return _Ptr;
+}
+
+/**
+ * @brief 释放替换的operator new分配的内存
+ * @details 不内联，否则GCC在调用处看到operator new的结果被free释放，会给出-Wmismatched-new-delete警告
+ * @param _Ptr 内存地址
+ */
+#if defined(__GNUC__)
+__attribute__((noinline))
+#endif
+void counted_free(void * _Ptr) noexcept
+{
+    std::free(_Ptr);
+}
+
+/**
+ * @brief 读取当前进程的常驻内存大小
+ * @return 字节数
+ */
+std::size_t resident_bytes()
+{
+    std::FILE * _File = std::fopen("/proc/self/statm", "r");
+    if (_File == nullptr) {
+        return 0;
+    }
+
+    unsigned long _Size = 0;
+    unsigned long _Resident = 0;
+    int _Count = std::fscanf(_File, "%lu %lu", &_Size, &_Resident);
+    std::fclose(_File);
+
+    return _Count == 2 ? _Resident * static_cast<std::size_t>(sysconf(_SC_PAGESIZE)) : 0;
+}
+
+/**
+ * @brief 生成定长字符串键
+ * @param _Count 键个数
+ * @return 键数组
+ */
+std::vector<std::string> make_keys(std::size_t _Count)
+{
+    std::vector<std::string> _Keys;
+    _Keys.reserve(_Count);
+
+    char _Buffer[32];
+    for (std::size_t _Index = 0; _Index < _Count; ++_Index) {
+        // 乘以一个奇数打乱插入顺序
+        std::snprintf(_Buffer, sizeof(_Buffer), "key%012zu", (_Index * 2654435761u) % _Count);
+        _Keys.emplace_back(_Buffer);
+    }
+
+    return _Keys;
+}
+
+/**
+ * @brief 插入N个键后清空，统计每次插入的分配次数和常驻内存增量
+ */
+template <typename _Ty_alloc>
+void BM_InsertAndClear(benchmark::State & state)
+{
+    using skiplist_type = WW::_Skiplist<std::string, std::string, std::less<std::string>, _Ty_alloc>;
+
+    const std::size_t _Count = static_cast<std::size_t>(state.range(0));
+    const std::vector<std::string> _Keys = make_keys(_Count);
+
+    std::size_t _Allocations = 0;
+    std::size_t _Resident = 0;
+
+    for (auto _ : state) {
+        skiplist_type _List;
+
+        // 将之前释放的内存归还给系统，避免影响常驻内存的统计
+        malloc_trim(0);
+
+        std::size_t _Allocations_before = allocation_count.load(std::memory_order_relaxed);
+        std::size_t _Resident_before = resident_bytes();
+
+        for (const std::string & _Key : _Keys) {
+            _List.insert({_Key, _Key});
+        }
+
+        _Allocations += allocation_count.load(std::memory_order_relaxed) - _Allocations_before;
+        _Resident += resident_bytes() - _Resident_before;
+
+        _List.clear();
+    }
+
+    state.SetItemsProcessed(state.iterations() * _Count);
+    state.counters["allocs_per_insert"] = static_cast<double>(_Allocations) / (state.iterations() * _Count);
+    state.counters["rss_bytes_per_node"] = static_cast<double>(_Resident) / (state.iterations() * _Count);
+}
+
+/**
+ * @brief 在N个键的跳表中反复删除再插入，模拟写密集负载
+ */
+template <typename _Ty_alloc>
+void BM_EraseAndInsert(benchmark::State & state)
+{
+    using skiplist_type = WW::_Skiplist<std::string, std::string, std::less<std::string>, _Ty_alloc>;
+
+    const std::size_t _Count = static_cast<std::size_t>(state.range(0));
+    const std::vector<std::string> _Keys = make_keys(_Count);
+
+    skiplist_type _List;
+    for (const std::string & _Key : _Keys) {
+        _List.insert({_Key, _Key});
+    }
+
+    std::size_t _Index = 0;
+    std::size_t _Allocations_before = allocation_count.load(std::memory_order_relaxed);
+
+    for (auto _ : state) {
+        _List.erase(_Keys[_Index]);
+        _List.insert({_Keys[_Index], _Keys[_Index]});
+
+        if (++_Index == _Count) {
+            _Index = 0;
+        }
+    }
+
+    std::size_t _Allocations = allocation_count.load(std::memory_order_relaxed) - _Allocations_before;
+    state.SetItemsProcessed(state.iterations());
+    state.counters["allocs_per_op"] = static_cast<double>(_Allocations) / state.iterations();
+}
+
+/**
+ * @brief 不产生新节点的修改操作，每次操作的分配次数应当为0
+ * @details 依次执行：插入已存在的键、删除不存在的键、operator[]访问已存在的键
+ */
+void BM_MutationWithoutNewNode(benchmark::State & state)
+{
+    const std::size_t _Count = static_cast<std::size_t>(state.range(0));
+    const std::vector<std::string> _Keys = make_keys(_Count);
+    const std::string _Missing = "missing";
+
+    WW::_Skiplist<std::string, std::string> _List;
+    for (const std::string & _Key : _Keys) {
+        _List.insert({_Key, _Key});
+    }
+
+    // 预先构造键值对，避免把键值对的拷贝算进来
+    std::vector<std::pair<const std::string, std::string>> _Pairs;
+    _Pairs.reserve(_Count);
+    for (const std::string & _Key : _Keys) {
+        _Pairs.emplace_back(_Key, _Key);
+    }
+
+    std::size_t _Index = 0;
+    std::size_t _Allocations_before = allocation_count.load(std::memory_order_relaxed);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(_List.insert(_Pairs[_Index]));
+        benchmark::DoNotOptimize(_List.erase(_Missing));
+        benchmark::DoNotOptimize(_List[_Keys[_Index]]);
+
+        if (++_Index == _Count) {
+            _Index = 0;
+        }
+    }
+
+    std::size_t _Allocations = allocation_count.load(std::memory_order_relaxed) - _Allocations_before;
+    state.SetItemsProcessed(state.iterations() * 3);
+    state.counters["allocs_per_op"] = static_cast<double>(_Allocations) / (state.iterations() * 3);
+}
+
+using std_allocator = std::allocator<std::pair<const std::string, std::string>>;
+using pool_allocator = WW::_Pool_allocator<std::pair<const std::string, std::string>>;
+
+} // namespace
+
+void * operator new(std::size_t _Size)
+{
+    return counted_allocate(_Size, alignof(std::max_align_t));
+}
+
+void * operator new[](std::size_t _Size)
+{
+    return counted_allocate(_Size, alignof(std::max_align_t));
+}
+
+void * operator new(std::size_t _Size, std::align_val_t _Align)
+{
+    return counted_allocate(_Size, static_cast<std::size_t>(_Align));
+}
+
+void * operator new[](std::size_t _Size, std::align_val_t _Align)
+{
+    return counted_allocate(_Size, static_cast<std::size_t>(_Align));
+}
+
+void * operator new(std::size_t _Size, const std::nothrow_t &) noexcept
+{
+    return counted_allocate_nothrow(_Size, alignof(std::max_align_t));
+}
+
+void * operator new[](std::size_t _Size, const std::nothrow_t &) noexcept
+{
+    return counted_allocate_nothrow(_Size, alignof(std::max_align_t));
+}
+
+void * operator new(std::size_t _Size, std::align_val_t _Align, const std::nothrow_t &) noexcept
+{
+    return counted_allocate_nothrow(_Size, static_cast<std::size_t>(_Align));
+}
+
+void * operator new[](std::size_t _Size, std::align_val_t _Align, const std::nothrow_t &) noexcept
+{
+    return counted_allocate_nothrow(_Size, static_cast<std::size_t>(_Align));
+}
+
+void operator delete(void * _Ptr) noexcept
+{
+    counted_free(_Ptr);
+}
+
+void operator delete[](void * _Ptr) noexcept
+{
+    counted_free(_Ptr);
+}
+
+void operator delete(void * _Ptr, std::size_t) noexcept
+{
+    counted_free(_Ptr);
+}
+
+void operator delete[](void * _Ptr, std::size_t) noexcept
+{
+    counted_free(_Ptr);
+}
+
+void operator delete(void * _Ptr, std::align_val_t) noexcept
+{
+    counted_free(_Ptr);
+}
+
+void operator delete[](void * _Ptr, std::align_val_t) noexcept
+{
+    counted_free(_Ptr);
+}
+
+void operator delete(void * _Ptr, std::size_t, std::align_val_t) noexcept
+{
+    counted_free(_Ptr);
+}
+
+void operator delete[](void * _Ptr, std::size_t, std::align_val_t) noexcept
+{
+    counted_free(_Ptr);
+}
+
+void operator delete(void * _Ptr, const std::nothrow_t &) noexcept
+{
+    counted_free(_Ptr);
+}
+
+void operator delete[](void * _Ptr, const std::nothrow_t &) noexcept
+{
+    counted_free(_Ptr);
+}
+
+void operator delete(void * _Ptr, std::align_val_t, const std::nothrow_t &) noexcept
+{
+    counted_free(_Ptr);
+}
+
+void operator delete[](void * _Ptr, std::align_val_t, const std::nothrow_t &) noexcept
+{
+    counted_free(_Ptr);
+}
+
+BENCHMARK_TEMPLATE(BM_InsertAndClear, std_allocator)->Arg(1000000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_InsertAndClear, pool_allocator)->Arg(1000000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_EraseAndInsert, std_allocator)->Arg(1000000);
+BENCHMARK_TEMPLATE(BM_EraseAndInsert, pool_allocator)->Arg(1000000);
+BENCHMARK(BM_MutationWithoutNewNode)->Arg(100000);
@@ -0,0 +1,162 @@
+#include <cstdio>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <KVStore.h>
+
+namespace
+{
+
+using store_type = WW::KVStore<std::string, std::string>;
+
+constexpr std::size_t KEY_COUNT = 1000000;
+
+/**
+ * @brief 生成第_Index个定长字符串键
+ * @param _Index 序号
+ * @return 键
+ */
+std::string make_key(std::size_t _Index)
+{
+    char _Buffer[32];
+    std::snprintf(_Buffer, sizeof(_Buffer), "key%012zu", _Index);
+    return _Buffer;
+}
+
+/**
+ * @brief 获取预先填充的储存，只包含偶数序号的键，所有基准共享
+ * @return 储存
+ */
+store_type & shared_store()
+{
+    static store_type * _Store = [] {
+        store_type * _Result = new store_type();
+        for (std::size_t _Index = 0; _Index < KEY_COUNT; ++_Index) {
+            std::string _Key = make_key(_Index * 2);
+            _Result->put(_Key, _Key);
+        }
+        return _Result;
+    }();
+
+    return *_Store;
+}
+
+/**
+ * @brief 生成一批随机键
+ * @param _Engine 随机数引擎
+ * @param _Size 批大小
+ * @param _Odd 是否为不存在的奇数序号键
+ * @return 键
+ */
+std::vector<std::string> make_batch(std::mt19937_64 & _Engine, std::size_t _Size, bool _Odd)
+{
+    std::vector<std::string> _Keys;
+    _Keys.reserve(_Size);
+
+    for (std::size_t _Index = 0; _Index < _Size; ++_Index) {
+        _Keys.push_back(make_key(_Engine() % KEY_COUNT * 2 + (_Odd ? 1 : 0)));
+    }
+
+    return _Keys;
+}
+
+/**
+ * @brief 逐个查找一批已存在的键
+ */
+void BM_PerKeyGet(benchmark::State & state)
+{
+    const store_type & _Store = shared_store();
+    std::mt19937_64 _Engine(7);
+    std::string _Value;
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::vector<std::string> _Keys = make_batch(_Engine, static_cast<std::size_t>(state.range(0)), false);
+        state.ResumeTiming();
+
+        for (const std::string & _Key : _Keys) {
+            benchmark::DoNotOptimize(_Store.get_into(_Key, _Value));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+/**
+ * @brief 批量查找一批已存在的键
+ */
+void BM_MultiGet(benchmark::State & state)
+{
+    const store_type & _Store = shared_store();
+    std::mt19937_64 _Engine(7);
+    std::vector<std::string> _Values;
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::vector<std::string> _Keys = make_batch(_Engine, static_cast<std::size_t>(state.range(0)), false);
+        state.ResumeTiming();
+
+        benchmark::DoNotOptimize(_Store.multi_get(_Keys, _Values));
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+/**
+ * @brief 逐个插入一批新键，再逐个删除
+ */
+void BM_PerKeyPutRemove(benchmark::State & state)
+{
+    store_type & _Store = shared_store();
+    std::mt19937_64 _Engine(7);
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::vector<std::string> _Keys = make_batch(_Engine, static_cast<std::size_t>(state.range(0)), true);
+        state.ResumeTiming();
+
+        for (const std::string & _Key : _Keys) {
+            _Store.put(_Key, _Key);
+        }
+        for (const std::string & _Key : _Keys) {
+            _Store.remove(_Key);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0) * 2);
+}
+
+/**
+ * @brief 批量插入一批新键，再批量删除
+ */
+void BM_MultiPutRemove(benchmark::State & state)
+{
+    store_type & _Store = shared_store();
+    std::mt19937_64 _Engine(7);
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::vector<std::string> _Keys = make_batch(_Engine, static_cast<std::size_t>(state.range(0)), true);
+        std::vector<std::pair<std::string, std::string>> _Pairs;
+        _Pairs.reserve(_Keys.size());
+        for (const std::string & _Key : _Keys) {
+            _Pairs.emplace_back(_Key, _Key);
+        }
+        state.ResumeTiming();
+
+        _Store.multi_put(_Pairs);
+        _Store.multi_remove(_Keys);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0) * 2);
+}
+
+} // namespace
+
+BENCHMARK(BM_PerKeyGet)->Arg(10)->Arg(100)->Arg(1000);
+BENCHMARK(BM_MultiGet)->Arg(10)->Arg(100)->Arg(1000);
+BENCHMARK(BM_PerKeyPutRemove)->Arg(10)->Arg(100)->Arg(1000);
+BENCHMARK(BM_MultiPutRemove)->Arg(10)->Arg(100)->Arg(1000);
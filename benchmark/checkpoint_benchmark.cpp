@@ -0,0 +1,118 @@
+#include <cstdio>
+#include <string>
+
+#include <unistd.h>
+
+#include <benchmark/benchmark.h>
+#include <KVStore.h>
+
+namespace
+{
+
+using store_type = WW::KVStore<std::string, std::string>;
+
+/**
+ * @brief 生成第_Index个定长字符串键
+ * @param _Index 序号
+ * @return 键
+ */
+std::string make_key(std::size_t _Index)
+{
+    char _Buffer[32];
+    std::snprintf(_Buffer, sizeof(_Buffer), "key%012zu", _Index);
+    return _Buffer;
+}
+
+/**
+ * @brief 获取临时检查点文件路径
+ * @return 路径
+ */
+std::string checkpoint_path()
+{
+    return "/tmp/ww_checkpoint_benchmark_" + std::to_string(::getpid()) + ".ckpt";
+}
+
+/**
+ * @brief 写出一个包含N个键的检查点
+ * @param _Count 键个数
+ */
+void write_checkpoint(std::size_t _Count)
+{
+    store_type _Store;
+    for (std::size_t _Index = 0; _Index < _Count; ++_Index) {
+        std::string _Key = make_key(_Index);
+        _Store.put(_Key, _Key);
+    }
+    _Store.checkpoint(checkpoint_path());
+}
+
+/**
+ * @brief 冷启动时逐个put重建，相当于重放只包含插入的日志
+ */
+void BM_ColdStartByPut(benchmark::State & state)
+{
+    const std::size_t _Count = static_cast<std::size_t>(state.range(0));
+
+    for (auto _ : state) {
+        store_type * _Store = new store_type();
+
+        for (std::size_t _Index = 0; _Index < _Count; ++_Index) {
+            std::string _Key = make_key(_Index);
+            _Store->put(_Key, _Key);
+        }
+
+        state.PauseTiming();
+        delete _Store;
+        state.ResumeTiming();
+    }
+
+    state.SetItemsProcessed(state.iterations() * _Count);
+}
+
+/**
+ * @brief 冷启动时从检查点自底向上构建
+ */
+void BM_ColdStartByLoad(benchmark::State & state)
+{
+    const std::size_t _Count = static_cast<std::size_t>(state.range(0));
+    write_checkpoint(_Count);
+
+    for (auto _ : state) {
+        store_type * _Store = new store_type();
+        benchmark::DoNotOptimize(_Store->load(checkpoint_path()));
+
+        state.PauseTiming();
+        delete _Store;
+        state.ResumeTiming();
+    }
+
+    state.SetItemsProcessed(state.iterations() * _Count);
+    std::remove(checkpoint_path().c_str());
+}
+
+/**
+ * @brief 写出检查点
+ */
+void BM_Checkpoint(benchmark::State & state)
+{
+    const std::size_t _Count = static_cast<std::size_t>(state.range(0));
+
+    store_type _Store;
+    for (std::size_t _Index = 0; _Index < _Count; ++_Index) {
+        std::string _Key = make_key(_Index);
+        _Store.put(_Key, _Key);
+    }
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(_Store.checkpoint(checkpoint_path()));
+    }
+
+    state.SetItemsProcessed(state.iterations() * _Count);
+    std::remove(checkpoint_path().c_str());
+}
+
+} // namespace
+
+BENCHMARK(BM_ColdStartByPut)->Arg(1000000)->Arg(10000000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ColdStartByLoad)->Arg(1000000)->Arg(10000000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Checkpoint)->Arg(1000000)->Arg(10000000)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,83 @@
+#!/usr/bin/env python3
+"""比较两次基准测试的JSON结果，任何一项变慢超过阈值时以非0状态退出。
+
+用法：
+    python3 compare.py <基线> <当前> [--threshold 0.10] [--metric real_time]
+
+基线和当前可以是单个JSON文件，也可以是benchmark_json生成的目录。
+使用--benchmark_repetitions时只比较中位数。
+"""
+
+import argparse
+import json
+import pathlib
+import sys
+
+UNIT_NS = {"ns": 1.0, "us": 1e3, "ms": 1e6, "s": 1e9}
+
+
+def load(path):
+    """读取结果，返回 名称 -> 纳秒"""
+    path = pathlib.Path(path)
+    files = sorted(path.glob("*.json")) if path.is_dir() else [path]
+    results = {}
+
+    for file in files:
+        # 过滤后没有运行任何基准测试时输出文件为空
+        if file.stat().st_size == 0:
+            continue
+
+        with open(file) as stream:
+            data = json.load(stream)
+
+        for entry in data.get("benchmarks", []):
+            if entry.get("run_type") == "aggregate":
+                if entry.get("aggregate_name") != "median":
+                    continue
+                name = entry["run_name"]
+            elif entry.get("repetitions", 1) > 1:
+                continue
+            else:
+                name = entry["name"]
+
+            results[name] = entry[ARGS.metric] * UNIT_NS[entry.get("time_unit", "ns")]
+
+    return results
+
+
+def main():
+    baseline = load(ARGS.baseline)
+    current = load(ARGS.current)
+    regressions = 0
+
+    width = max((len(name) for name in current), default=10)
+    print(f"{'benchmark':<{width}}  {'baseline':>12}  {'current':>12}  {'change':>8}")
+
+    for name, time in current.items():
+        if name not in baseline:
+            print(f"{name:<{width}}  {'-':>12}  {time:>10.0f}ns  {'new':>8}")
+            continue
+
+        change = time / baseline[name] - 1.0
+        mark = ""
+        if change > ARGS.threshold:
+            mark = "  REGRESSION"
+            regressions += 1
+
+        print(f"{name:<{width}}  {baseline[name]:>10.0f}ns  {time:>10.0f}ns  {change:>+7.1%}{mark}")
+
+    if regressions:
+        print(f"{regressions} benchmark(s) slower than {ARGS.threshold:.0%}", file=sys.stderr)
+        return 1
+
+    return 0
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("baseline")
+    parser.add_argument("current")
+    parser.add_argument("--threshold", type=float, default=0.10, help="允许变慢的比例")
+    parser.add_argument("--metric", choices=["real_time", "cpu_time"], default="real_time")
+    ARGS = parser.parse_args()
+    sys.exit(main())
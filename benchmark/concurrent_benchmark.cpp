@@ -0,0 +1,89 @@
+#include <mutex>
+#include <random>
+#include <string>
+
+#include <benchmark/benchmark.h>
+#include <KVStore.h>
+#include <ShardedKVStore.h>
+
+namespace
+{
+
+constexpr int KEY_COUNT = 100000;       // 键空间大小
+
+using lock_free_store = WW::KVStore<int, std::string, std::less<int>, std::allocator<std::pair<const int, std::string>>, WW::lock_free_policy>;
+using sharded_store = WW::ShardedKVStore<int, std::string>;
+
+/**
+ * @brief 用一把全局互斥锁保护的单线程KVStore，作为对照
+ */
+class locked_store
+{
+private:
+    std::mutex _Mutex;
+    WW::KVStore<int, std::string> _Store;
+
+public:
+    std::string get(int _Key)
+    {
+        std::lock_guard<std::mutex> _Lock(_Mutex);
+        return _Store.get_or_default(_Key);
+    }
+
+    bool put(int _Key, const std::string & _Value)
+    {
+        std::lock_guard<std::mutex> _Lock(_Mutex);
+        return _Store.put(_Key, _Value);
+    }
+
+    bool remove(int _Key)
+    {
+        std::lock_guard<std::mutex> _Lock(_Mutex);
+        return _Store.remove(_Key);
+    }
+};
+
+/**
+ * @brief 90%读、5%插入、5%删除的混合负载
+ */
+template <typename _Ty_store>
+void BM_MixedWorkload(benchmark::State & state)
+{
+    static _Ty_store * _Store = nullptr;
+
+    if (state.thread_index() == 0) {
+        _Store = new _Ty_store();
+        for (int _Key = 0; _Key < KEY_COUNT; _Key += 2) {
+            _Store->put(_Key, std::to_string(_Key));
+        }
+    }
+
+    std::minstd_rand _Engine(state.thread_index() + 1);
+    const std::string _Value = "value";
+
+    for (auto _ : state) {
+        int _Key = static_cast<int>(_Engine() % KEY_COUNT);
+        unsigned _Op = _Engine() % 100;
+
+        if (_Op < 90) {
+            benchmark::DoNotOptimize(_Store->get(_Key));
+        } else if (_Op < 95) {
+            benchmark::DoNotOptimize(_Store->put(_Key, _Value));
+        } else {
+            benchmark::DoNotOptimize(_Store->remove(_Key));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations());
+
+    if (state.thread_index() == 0) {
+        delete _Store;
+        _Store = nullptr;
+    }
+}
+
+} // namespace
+
+BENCHMARK_TEMPLATE(BM_MixedWorkload, locked_store)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_MixedWorkload, lock_free_store)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_MixedWorkload, sharded_store)->ThreadRange(1, 64)->UseRealTime();
@@ -0,0 +1,77 @@
+#include <cstdint>
+#include <limits>
+#include <string>
+
+#include <benchmark/benchmark.h>
+#include <KVStore.h>
+
+#include "Workload.h"
+
+namespace
+{
+
+constexpr std::size_t KEY_COUNT = 100000;
+constexpr std::size_t VALUE_SIZE = 100;
+
+using store_type = WW::KVStore<std::string, std::string>;
+
+/**
+ * @brief 所有键都在储存中时占用的内存
+ * @return 字节数
+ */
+std::size_t full_footprint()
+{
+    static const std::size_t _Footprint = [] {
+        store_type _Store;
+        _Store.set_memory_limit(std::numeric_limits<std::size_t>::max());
+        for (std::uint64_t _Index = 0; _Index < KEY_COUNT; ++_Index) {
+            _Store.put(WW::bench::make_key(_Index), std::string(VALUE_SIZE, 'v'));
+        }
+        return _Store.memory_usage();
+    }();
+
+    return _Footprint;
+}
+
+/**
+ * @brief 旁路缓存：Zipf(0.99)分布的读，未命中时写入，第一个参数为预算占全部数据的百分比，
+ * 第二个参数为0时使用LRU，为1时使用LFU
+ */
+void BM_ZipfianCache(benchmark::State & state)
+{
+    store_type _Store;
+    _Store.set_memory_limit(full_footprint() * state.range(0) / 100,
+                            state.range(1) == 0 ? WW::eviction_policy::lru : WW::eviction_policy::lfu);
+
+    WW::bench::key_chooser _Chooser(KEY_COUNT, true, 1);
+    const std::string _Value(VALUE_SIZE, 'v');
+    std::string _Out;
+
+    // 预热
+    for (std::size_t _Index = 0; _Index < KEY_COUNT * 5; ++_Index) {
+        std::string _Key = WW::bench::make_key(_Chooser());
+        if (!_Store.get_into(_Key, _Out)) {
+            _Store.put(_Key, _Value);
+        }
+    }
+
+    std::size_t _Hits = 0;
+    std::size_t _Evictions = _Store.evictions();
+    for (auto _ : state) {
+        std::string _Key = WW::bench::make_key(_Chooser());
+        if (_Store.get_into(_Key, _Out)) {
+            ++_Hits;
+        } else {
+            _Store.put(_Key, _Value);
+        }
+    }
+
+    state.counters["hit_ratio"] = static_cast<double>(_Hits) / state.iterations();
+    state.counters["evictions"] = static_cast<double>(_Store.evictions() - _Evictions);
+    state.counters["memory_usage"] = static_cast<double>(_Store.memory_usage());
+    state.SetItemsProcessed(state.iterations());
+}
+
+} // namespace
+
+BENCHMARK(BM_ZipfianCache)->ArgsProduct({{5, 10, 25, 50, 100}, {0, 1}});
@@ -0,0 +1,125 @@
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <SkipList.h>
+
+namespace
+{
+
+/**
+ * @brief 与std::less等价但不是std::less，跳表按通用方式逐个访问向前节点比较
+ */
+struct plain_less
+{
+    bool operator()(std::uint64_t _Left, std::uint64_t _Right) const
+    {
+        return _Left < _Right;
+    }
+};
+
+using cached_list = WW::_Skiplist<std::uint64_t, std::uint64_t>;
+using generic_list = WW::_Skiplist<std::uint64_t, std::uint64_t, plain_less>;
+
+/**
+ * @brief 生成互不相同的随机键
+ * @param _Count 个数
+ * @param _Seed 种子
+ * @return 键
+ */
+std::vector<std::uint64_t> make_keys(std::size_t _Count, std::uint64_t _Seed)
+{
+    std::mt19937_64 _Random(_Seed);
+    std::vector<std::uint64_t> _Keys(_Count);
+
+    for (std::uint64_t & _Key : _Keys) {
+        _Key = _Random();
+    }
+
+    std::sort(_Keys.begin(), _Keys.end());
+    _Keys.erase(std::unique(_Keys.begin(), _Keys.end()), _Keys.end());
+    std::shuffle(_Keys.begin(), _Keys.end(), _Random);
+    return _Keys;
+}
+
+/**
+ * @brief 随机顺序查找已存在的键，参数为元素个数
+ */
+template <typename _Ty_list>
+void BM_Find(benchmark::State & state)
+{
+    const std::vector<std::uint64_t> _Keys = make_keys(static_cast<std::size_t>(state.range(0)), 1);
+    WW::seed_level_random(2);
+
+    _Ty_list _List;
+    for (std::uint64_t _Key : _Keys) {
+        _List.insert({_Key, _Key});
+    }
+
+    std::size_t _Index = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(_List.find(_Keys[_Index]));
+        _Index = _Index + 1 == _Keys.size() ? 0 : _Index + 1;
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+/**
+ * @brief 查找不存在的键，参数为元素个数
+ */
+template <typename _Ty_list>
+void BM_FindMiss(benchmark::State & state)
+{
+    const std::vector<std::uint64_t> _Keys = make_keys(static_cast<std::size_t>(state.range(0)), 1);
+    const std::vector<std::uint64_t> _Probes = make_keys(static_cast<std::size_t>(state.range(0)), 3);
+    WW::seed_level_random(2);
+
+    _Ty_list _List;
+    for (std::uint64_t _Key : _Keys) {
+        _List.insert({_Key, _Key});
+    }
+
+    std::size_t _Index = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(_List.find(_Probes[_Index]));
+        _Index = _Index + 1 == _Probes.size() ? 0 : _Index + 1;
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+/**
+ * @brief 随机顺序插入，参数为元素个数
+ */
+template <typename _Ty_list>
+void BM_Insert(benchmark::State & state)
+{
+    const std::vector<std::uint64_t> _Keys = make_keys(static_cast<std::size_t>(state.range(0)), 1);
+
+    for (auto _ : state) {
+        WW::seed_level_random(2);
+        _Ty_list _List;
+
+        for (std::uint64_t _Key : _Keys) {
+            _List.insert({_Key, _Key});
+        }
+
+        state.PauseTiming();
+        _List.clear();
+        state.ResumeTiming();
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(_Keys.size()));
+}
+
+} // namespace
+
+BENCHMARK_TEMPLATE(BM_Find, cached_list)->RangeMultiplier(10)->Range(1000, 1000000);
+BENCHMARK_TEMPLATE(BM_Find, generic_list)->RangeMultiplier(10)->Range(1000, 1000000);
+BENCHMARK_TEMPLATE(BM_FindMiss, cached_list)->RangeMultiplier(10)->Range(1000, 1000000);
+BENCHMARK_TEMPLATE(BM_FindMiss, generic_list)->RangeMultiplier(10)->Range(1000, 1000000);
+BENCHMARK_TEMPLATE(BM_Insert, cached_list)->Arg(100000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Insert, generic_list)->Arg(100000)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,193 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <SkipList.h>
+
+namespace
+{
+
+constexpr std::size_t KEY_COUNT = 1000000;
+
+std::size_t allocated_bytes = 0;   // 节点分配器当前持有的字节数
+std::size_t comparisons = 0;       // 比较次数
+
+/**
+ * @brief 统计分配字节数的分配器
+ */
+template <typename _Ty>
+struct counting_allocator
+{
+    using value_type = _Ty;
+
+    counting_allocator() = default;
+
+    template <typename _Other>
+    counting_allocator(const counting_allocator<_Other> &) noexcept
+    {
+    }
+
+    _Ty * allocate(std::size_t _Count)
+    {
+        allocated_bytes += _Count * sizeof(_Ty);
+        return std::allocator<_Ty>().allocate(_Count);
+    }
+
+    void deallocate(_Ty * _Ptr, std::size_t _Count) noexcept
+    {
+        allocated_bytes -= _Count * sizeof(_Ty);
+        std::allocator<_Ty>().deallocate(_Ptr, _Count);
+    }
+
+    template <typename _Other>
+    bool operator==(const counting_allocator<_Other> &) const noexcept
+    {
+        return true;
+    }
+
+    template <typename _Other>
+    bool operator!=(const counting_allocator<_Other> &) const noexcept
+    {
+        return false;
+    }
+};
+
+/**
+ * @brief 统计比较次数的比较器
+ */
+struct counting_less
+{
+    bool operator()(std::uint64_t _Left, std::uint64_t _Right) const noexcept
+    {
+        ++comparisons;
+        return _Left < _Right;
+    }
+};
+
+using pair_type = std::pair<const std::uint64_t, std::uint64_t>;
+using skiplist_type = WW::_Skiplist<std::uint64_t, std::uint64_t, counting_less, counting_allocator<pair_type>>;
+
+/**
+ * @brief 按下标选择层级分布
+ * @param _Index 0为1/2，1为1/4，2为1/e
+ * @return 层级分布
+ */
+WW::level_distribution distribution_of(std::int64_t _Index)
+{
+    switch (_Index) {
+    case 1:
+        return WW::level_distribution::quarter();
+    case 2:
+        return WW::level_distribution::inverse_e();
+    default:
+        return WW::level_distribution::half();
+    }
+}
+
+/**
+ * @brief 以给定的层级分布随机插入KEY_COUNT个键后随机查找，统计每次查找的比较次数和每个节点的字节数
+ */
+void BM_LevelLookup(benchmark::State & state)
+{
+    WW::seed_level_random(1);
+    std::size_t _Base = allocated_bytes;
+
+    skiplist_type _Skiplist(WW::MAX_LEVEL_LIMIT);
+    _Skiplist.set_level_distribution(distribution_of(state.range(0)));
+
+    std::mt19937_64 _Engine(1);
+    for (std::size_t _Index = 0; _Index < KEY_COUNT; ++_Index) {
+        _Skiplist.insert({_Engine(), _Index});
+    }
+
+    state.counters["bytes_per_node"] = static_cast<double>(allocated_bytes - _Base) / _Skiplist.size();
+    state.counters["p"] = _Skiplist.get_level_distribution().probability();
+
+    _Engine.seed(1);
+    std::vector<std::uint64_t> _Keys(KEY_COUNT);
+    for (std::uint64_t & _Key : _Keys) {
+        _Key = _Engine();
+    }
+    std::shuffle(_Keys.begin(), _Keys.end(), std::mt19937_64(2));
+
+    comparisons = 0;
+    std::size_t _Index = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(_Skiplist.find(_Keys[_Index]));
+        if (++_Index == _Keys.size()) {
+            _Index = 0;
+        }
+    }
+
+    state.counters["comparisons_per_find"] = static_cast<double>(comparisons) / state.iterations();
+}
+
+/**
+ * @brief 每个线程向各自的跳表插入随机键，层级生成不应在线程之间产生竞争
+ */
+void BM_IndependentInsert(benchmark::State & state)
+{
+    std::mt19937_64 _Engine(state.thread_index() + 1);
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        WW::_Skiplist<std::uint64_t, std::uint64_t> _Skiplist;
+        state.ResumeTiming();
+
+        for (int _Index = 0; _Index < 10000; ++_Index) {
+            _Skiplist.insert({_Engine(), 0});
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * 10000);
+}
+
+/**
+ * @brief 以升序键建立N个元素的跳表后随机查找
+ * @details 第二个参数为0时固定最大层级为16，为1时最大层级随元素数量增长
+ */
+void BM_LookupScale(benchmark::State & state)
+{
+    using list_type = WW::_Skiplist<std::uint64_t, std::uint64_t>;
+
+    WW::seed_level_random(1);
+    const std::uint64_t _Count = static_cast<std::uint64_t>(state.range(0));
+    std::unique_ptr<list_type> _Skiplist(state.range(1) == 0 ? new list_type(16) : new list_type());
+
+    list_type::finger _Finger;
+    for (std::uint64_t _Index = 0; _Index < _Count; ++_Index) {
+        _Skiplist->insert({_Index * 2, _Index}, _Finger);
+    }
+
+    state.counters["level_limit"] = _Skiplist->level_limit();
+
+    std::mt19937_64 _Engine(3);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(_Skiplist->find((_Engine() % _Count) * 2));
+    }
+}
+
+/**
+ * @brief 查找规模的参数组合
+ * @details 100M个元素约需要7GB内存，只在设置了环境变量`WWBENCHMARK_LARGE`时加入
+ */
+void lookup_scale_arguments(benchmark::internal::Benchmark * _Bench)
+{
+    std::vector<std::int64_t> _Counts = {10000, 100000, 1000000, 10000000};
+    if (std::getenv("WWBENCHMARK_LARGE") != nullptr) {
+        _Counts.push_back(100000000);
+    }
+
+    _Bench->ArgsProduct({_Counts, {0, 1}});
+}
+
+} // namespace
+
+BENCHMARK(BM_LookupScale)->Apply(lookup_scale_arguments)->Unit(benchmark::kNanosecond);
+BENCHMARK(BM_LevelLookup)->DenseRange(0, 2);
+BENCHMARK(BM_IndependentInsert)->Threads(1)->Threads(4)->UseRealTime();
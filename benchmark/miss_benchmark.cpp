@@ -0,0 +1,138 @@
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+
+#include <benchmark/benchmark.h>
+#include <KVStore.h>
+
+namespace
+{
+
+constexpr std::size_t KEY_COUNT = 1000000;
+
+std::size_t allocated_bytes = 0;   // 节点分配器当前持有的字节数
+
+/**
+ * @brief 统计分配字节数的分配器
+ */
+template <typename _Ty>
+struct counting_allocator
+{
+    using value_type = _Ty;
+
+    counting_allocator() = default;
+
+    template <typename _Other>
+    counting_allocator(const counting_allocator<_Other> &) noexcept
+    {
+    }
+
+    _Ty * allocate(std::size_t _Count)
+    {
+        allocated_bytes += _Count * sizeof(_Ty);
+        return std::allocator<_Ty>().allocate(_Count);
+    }
+
+    void deallocate(_Ty * _Ptr, std::size_t _Count) noexcept
+    {
+        allocated_bytes -= _Count * sizeof(_Ty);
+        std::allocator<_Ty>().deallocate(_Ptr, _Count);
+    }
+
+    template <typename _Other>
+    bool operator==(const counting_allocator<_Other> &) const noexcept
+    {
+        return true;
+    }
+
+    template <typename _Other>
+    bool operator!=(const counting_allocator<_Other> &) const noexcept
+    {
+        return false;
+    }
+};
+
+using pair_type = std::pair<const std::string, std::string>;
+using store_type = WW::KVStore<std::string, std::string, std::less<std::string>, counting_allocator<pair_type>>;
+using skiplist_type = WW::_Skiplist<std::string, std::string, std::less<std::string>, counting_allocator<pair_type>>;
+
+/**
+ * @brief 生成第_Index个定长字符串键
+ * @param _Index 序号
+ * @return 键
+ */
+std::string make_key(std::size_t _Index)
+{
+    char _Buffer[32];
+    std::snprintf(_Buffer, sizeof(_Buffer), "key%012zu", _Index);
+    return _Buffer;
+}
+
+/**
+ * @brief 生成随机键，一半是不存在的奇数序号键
+ * @param _Engine 随机数引擎
+ * @return 键
+ */
+std::string next_key(std::mt19937_64 & _Engine)
+{
+    std::uint64_t _Random = _Engine();
+    return make_key((_Random >> 1) % KEY_COUNT * 2 + (_Random & 1));
+}
+
+/**
+ * @brief 以不插入的`get_into`查找，一半未命中
+ */
+void BM_GetHalfMiss(benchmark::State & state)
+{
+    store_type _Store;
+    for (std::size_t _Index = 0; _Index < KEY_COUNT; ++_Index) {
+        std::string _Key = make_key(_Index * 2);
+        _Store.put(_Key, _Key);
+    }
+
+    std::mt19937_64 _Engine(7);
+    std::string _Value;
+    std::size_t _Bytes_before = allocated_bytes;
+
+    for (auto _ : state) {
+        std::string _Key = next_key(_Engine);
+        benchmark::DoNotOptimize(_Store.get_into(_Key, _Value));
+    }
+
+    state.counters["growth_bytes"] = static_cast<double>(allocated_bytes - _Bytes_before);
+    state.counters["growth_nodes"] = static_cast<double>(_Store.size() - KEY_COUNT);
+    state.SetItemsProcessed(state.iterations());
+}
+
+/**
+ * @brief 以会插入默认值的下标运算符查找，即原先`get`的行为，一半未命中
+ */
+void BM_SubscriptHalfMiss(benchmark::State & state)
+{
+    skiplist_type _List;
+    for (std::size_t _Index = 0; _Index < KEY_COUNT; ++_Index) {
+        std::string _Key = make_key(_Index * 2);
+        _List.insert({_Key, _Key});
+    }
+
+    std::mt19937_64 _Engine(7);
+    std::string _Value;
+    std::size_t _Bytes_before = allocated_bytes;
+
+    for (auto _ : state) {
+        std::string _Key = next_key(_Engine);
+        _Value = _List[_Key];
+        benchmark::DoNotOptimize(_Value.data());
+    }
+
+    state.counters["growth_bytes"] = static_cast<double>(allocated_bytes - _Bytes_before);
+    state.counters["growth_nodes"] = static_cast<double>(_List.size() - KEY_COUNT);
+    state.SetItemsProcessed(state.iterations());
+}
+
+} // namespace
+
+BENCHMARK(BM_GetHalfMiss)->Iterations(1000000);
+BENCHMARK(BM_SubscriptHalfMiss)->Iterations(1000000);
@@ -0,0 +1,96 @@
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <SkipList.h>
+
+namespace
+{
+
+constexpr std::size_t KEY_COUNT = 100000;
+
+/**
+ * @brief 与std::less等价但不是std::less，跳表按通用方式逐个访问向前节点比较完整的键
+ */
+struct plain_less
+{
+    bool operator()(const std::string & _Left, const std::string & _Right) const
+    {
+        return _Left < _Right;
+    }
+};
+
+using cached_list = WW::_Skiplist<std::string, int>;
+using generic_list = WW::_Skiplist<std::string, int, plain_less>;
+
+/**
+ * @brief 生成互不相同的随机键
+ * @param _Size 键长度，超过16个字节
+ * @param _Shared 是否所有键以相同的16个字节开头，此时缓存的前缀总是相等
+ * @param _Seed 种子
+ * @return 键
+ */
+std::vector<std::string> make_keys(std::size_t _Size, bool _Shared, std::uint64_t _Seed)
+{
+    std::mt19937_64 _Random(_Seed);
+    std::vector<std::string> _Keys(KEY_COUNT);
+
+    for (std::string & _Key : _Keys) {
+        _Key.resize(_Size);
+        for (char & _Char : _Key) {
+            _Char = static_cast<char>('a' + _Random() % 26);
+        }
+
+        if (_Shared) {
+            _Key.replace(0, 16, "user:0000000000:");
+        }
+    }
+
+    std::sort(_Keys.begin(), _Keys.end());
+    _Keys.erase(std::unique(_Keys.begin(), _Keys.end()), _Keys.end());
+    std::shuffle(_Keys.begin(), _Keys.end(), _Random);
+    return _Keys;
+}
+
+/**
+ * @brief 随机顺序查找，参数依次为键长度、是否共享前缀、是否查找不存在的键
+ */
+template <typename _Ty_list>
+void BM_Find(benchmark::State & state)
+{
+    const std::size_t _Size = static_cast<std::size_t>(state.range(0));
+    const bool _Shared = state.range(1) == 1;
+    const std::vector<std::string> _Keys = make_keys(_Size, _Shared, 1);
+    const std::vector<std::string> _Probes = state.range(2) == 1 ? make_keys(_Size, _Shared, 3) : _Keys;
+    WW::seed_level_random(2);
+
+    _Ty_list _List;
+    for (const std::string & _Key : _Keys) {
+        _List.insert({_Key, 0});
+    }
+
+    std::size_t _Index = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(_List.find(_Probes[_Index]));
+        _Index = _Index + 1 == _Probes.size() ? 0 : _Index + 1;
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+/**
+ * @brief 查找的参数组合
+ */
+void find_arguments(benchmark::internal::Benchmark * _Bench)
+{
+    _Bench->ArgNames({"key", "shared", "miss"});
+    _Bench->ArgsProduct({{32, 64, 128, 256}, {0, 1}, {0, 1}});
+}
+
+} // namespace
+
+BENCHMARK_TEMPLATE(BM_Find, cached_list)->Apply(find_arguments);
+BENCHMARK_TEMPLATE(BM_Find, generic_list)->Apply(find_arguments);
@@ -0,0 +1,155 @@
+#include <cstdio>
+#include <string>
+
+#include <benchmark/benchmark.h>
+#include <KVStore.h>
+
+namespace
+{
+
+using store_type = WW::KVStore<std::string, std::string>;
+
+constexpr std::size_t KEY_COUNT = 1000000;
+
+/**
+ * @brief 生成第_Index个定长字符串键
+ * @param _Index 序号
+ * @return 键
+ */
+std::string make_key(std::size_t _Index)
+{
+    char _Buffer[32];
+    std::snprintf(_Buffer, sizeof(_Buffer), "key%012zu", _Index);
+    return _Buffer;
+}
+
+/**
+ * @brief 获取预先填充的储存，所有基准共享
+ * @return 储存
+ */
+const store_type & shared_store()
+{
+    static store_type * _Store = [] {
+        store_type * _Result = new store_type();
+        for (std::size_t _Index = 0; _Index < KEY_COUNT; ++_Index) {
+            std::string _Key = make_key(_Index);
+            _Result->put(_Key, _Key);
+        }
+        return _Result;
+    }();
+
+    return *_Store;
+}
+
+/**
+ * @brief 访问随机起点开始、长度为N的范围
+ */
+void BM_Scan(benchmark::State & state)
+{
+    const store_type & _Store = shared_store();
+    const std::size_t _Length = static_cast<std::size_t>(state.range(0));
+    std::size_t _Visited = 0;
+    std::size_t _Seed = 1;
+
+    for (auto _ : state) {
+        _Seed = _Seed * 6364136223846793005ull + 1442695040888963407ull;
+        std::size_t _First = (_Seed >> 33) % (KEY_COUNT - _Length);
+
+        _Visited += _Store.scan(make_key(_First), make_key(_First + _Length), _Length,
+                                [](const std::string & _Key, const std::string & _Value) {
+                                    benchmark::DoNotOptimize(_Key.data());
+                                    benchmark::DoNotOptimize(_Value.data());
+                                });
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(_Visited));
+}
+
+/**
+ * @brief 按降序访问随机终点之前、长度为N的范围
+ */
+void BM_ReverseScan(benchmark::State & state)
+{
+    const store_type & _Store = shared_store();
+    const std::size_t _Length = static_cast<std::size_t>(state.range(0));
+    std::size_t _Visited = 0;
+    std::size_t _Seed = 1;
+
+    for (auto _ : state) {
+        _Seed = _Seed * 6364136223846793005ull + 1442695040888963407ull;
+        std::size_t _First = (_Seed >> 33) % (KEY_COUNT - _Length);
+
+        _Visited += _Store.reverse_scan(make_key(_First), make_key(_First + _Length), _Length,
+                                        [](const std::string & _Key, const std::string & _Value) {
+                                            benchmark::DoNotOptimize(_Key.data());
+                                            benchmark::DoNotOptimize(_Value.data());
+                                        });
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(_Visited));
+}
+
+/**
+ * @brief 从第N个位置开始分页访问10个键
+ */
+void BM_ScanAtOffset(benchmark::State & state)
+{
+    const store_type & _Store = shared_store();
+    const std::size_t _Offset = static_cast<std::size_t>(state.range(0));
+    std::size_t _Visited = 0;
+
+    for (auto _ : state) {
+        _Visited += _Store.scan(_Offset, 10, [](const std::string & _Key, const std::string &) {
+            benchmark::DoNotOptimize(_Key.data());
+        });
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(_Visited));
+}
+
+/**
+ * @brief 查询随机键的排名
+ */
+void BM_Rank(benchmark::State & state)
+{
+    const store_type & _Store = shared_store();
+    std::size_t _Seed = 1;
+
+    for (auto _ : state) {
+        _Seed = _Seed * 6364136223846793005ull + 1442695040888963407ull;
+        benchmark::DoNotOptimize(_Store.rank(make_key((_Seed >> 33) % KEY_COUNT)));
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+/**
+ * @brief 访问一个包含1000个键的前缀
+ */
+void BM_PrefixScan(benchmark::State & state)
+{
+    const store_type & _Store = shared_store();
+    std::size_t _Visited = 0;
+    std::size_t _Seed = 1;
+
+    for (auto _ : state) {
+        _Seed = _Seed * 6364136223846793005ull + 1442695040888963407ull;
+        // 去掉末尾三位数字，前缀下恰好有1000个键
+        std::string _Prefix = make_key((_Seed >> 33) % KEY_COUNT).substr(0, 12);
+
+        _Visited += _Store.prefix_scan(_Prefix, KEY_COUNT,
+                                       [](const std::string & _Key, const std::string &) {
+                                           benchmark::DoNotOptimize(_Key.data());
+                                       });
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(_Visited));
+}
+
+} // namespace
+
+BENCHMARK(BM_Scan)->Arg(10)->Arg(100000);
+BENCHMARK(BM_ReverseScan)->Arg(10)->Arg(100000);
+BENCHMARK(BM_PrefixScan);
+BENCHMARK(BM_ScanAtOffset)->Arg(0)->Arg(500000)->Arg(999990);
+BENCHMARK(BM_Rank);
@@ -0,0 +1,176 @@
+#include <algorithm>
+#include <cstdio>
+#include <functional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <SkipList.h>
+
+namespace
+{
+
+using skiplist_type = WW::_Skiplist<std::string, std::string>;
+
+/**
+ * @brief 生成定长字符串键，并打乱顺序
+ * @param _Count 键个数
+ * @return 键数组
+ */
+std::vector<std::string> make_keys(std::size_t _Count)
+{
+    std::vector<std::string> _Keys;
+    _Keys.reserve(_Count);
+
+    char _Buffer[32];
+    for (std::size_t _Index = 0; _Index < _Count; ++_Index) {
+        std::snprintf(_Buffer, sizeof(_Buffer), "key%012zu", _Index);
+        _Keys.emplace_back(_Buffer);
+    }
+
+    std::mt19937_64 _Engine(42);
+    std::shuffle(_Keys.begin(), _Keys.end(), _Engine);
+    return _Keys;
+}
+
+/**
+ * @brief 插入N个随机顺序的字符串键
+ */
+void BM_SkiplistInsert(benchmark::State & state)
+{
+    const std::size_t _Count = static_cast<std::size_t>(state.range(0));
+    const std::vector<std::string> _Keys = make_keys(_Count);
+
+    for (auto _ : state) {
+        skiplist_type * _List = new skiplist_type();
+
+        for (const std::string & _Key : _Keys) {
+            _List->insert({_Key, _Key});
+        }
+
+        // 析构不计入插入耗时
+        state.PauseTiming();
+        delete _List;
+        state.ResumeTiming();
+    }
+
+    state.SetItemsProcessed(state.iterations() * _Count);
+}
+
+/**
+ * @brief 在N个键的跳表中随机查找已存在的键
+ */
+void BM_SkiplistLookup(benchmark::State & state)
+{
+    const std::size_t _Count = static_cast<std::size_t>(state.range(0));
+    std::vector<std::string> _Keys = make_keys(_Count);
+
+    skiplist_type _List;
+    for (const std::string & _Key : _Keys) {
+        _List.insert({_Key, _Key});
+    }
+
+    // 查找顺序与插入顺序不同
+    std::mt19937_64 _Engine(7);
+    std::shuffle(_Keys.begin(), _Keys.end(), _Engine);
+
+    std::size_t _Index = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(_List.find(_Keys[_Index]));
+        if (++_Index == _Count) {
+            _Index = 0;
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+/**
+ * @brief 以string_view查找超出短字符串优化长度的键
+ * @details 比较器不支持异构查找时，每次查找都要先构造一个临时的std::string
+ */
+template <typename _Ty_compare>
+void BM_StringViewLookup(benchmark::State & state)
+{
+    const std::size_t _Count = static_cast<std::size_t>(state.range(0));
+
+    // 键保存在一块连续缓冲区中，查找时只持有指向它的string_view
+    std::string _Buffer;
+    std::vector<std::string_view> _Views;
+    char _Key[64];
+    for (std::size_t _Index = 0; _Index < _Count; ++_Index) {
+        std::snprintf(_Key, sizeof(_Key), "user:session:%020zu", _Index);
+        _Buffer.append(_Key);
+    }
+
+    WW::_Skiplist<std::string, int, _Ty_compare> _List;
+    const std::size_t _Key_size = _Buffer.size() / _Count;
+    for (std::size_t _Index = 0; _Index < _Count; ++_Index) {
+        std::string_view _View(_Buffer.data() + _Index * _Key_size, _Key_size);
+        _Views.push_back(_View);
+        _List.insert({std::string(_View), 0});
+    }
+
+    std::mt19937_64 _Engine(7);
+    std::shuffle(_Views.begin(), _Views.end(), _Engine);
+
+    std::size_t _Index = 0;
+    for (auto _ : state) {
+        if constexpr (WW::_Is_transparent<_Ty_compare>::value) {
+            benchmark::DoNotOptimize(_List.find(_Views[_Index]));
+        } else {
+            benchmark::DoNotOptimize(_List.find(std::string(_Views[_Index])));
+        }
+
+        if (++_Index == _Count) {
+            _Index = 0;
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+/**
+ * @brief 遍历N个键的跳表，通过迭代器删除其中10%的键
+ */
+void BM_PurgeByIterator(benchmark::State & state)
+{
+    const std::size_t _Count = static_cast<std::size_t>(state.range(0));
+    const std::vector<std::string> _Keys = make_keys(_Count);
+    std::size_t _Erased = 0;
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        skiplist_type * _List = new skiplist_type();
+        for (const std::string & _Key : _Keys) {
+            _List->insert({_Key, _Key});
+        }
+        state.ResumeTiming();
+
+        std::size_t _Index = 0;
+        for (auto _It = _List->begin(); _It != _List->end(); ++_Index) {
+            if (_Index % 10 == 0) {
+                _It = _List->erase(_It);
+                ++_Erased;
+            } else {
+                ++_It;
+            }
+        }
+
+        state.PauseTiming();
+        delete _List;
+        state.ResumeTiming();
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(_Erased));
+}
+
+} // namespace
+
+BENCHMARK(BM_SkiplistInsert)->Arg(1000000)->Arg(10000000)->Unit(benchmark::kMillisecond)->Iterations(1);
+BENCHMARK(BM_SkiplistLookup)->Arg(1000000)->Arg(10000000);
+BENCHMARK_TEMPLATE(BM_StringViewLookup, std::less<std::string>)->Arg(1000)->Arg(1000000);
+BENCHMARK_TEMPLATE(BM_StringViewLookup, std::less<>)->Arg(1000)->Arg(1000000);
+BENCHMARK(BM_PurgeByIterator)->Arg(100000)->Arg(1000000)->Unit(benchmark::kMillisecond)->Iterations(1);
@@ -0,0 +1,133 @@
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include <benchmark/benchmark.h>
+#include <KVStore.h>
+
+namespace
+{
+
+constexpr std::size_t KEY_COUNT = 1000000;     // 键个数
+
+using memory_store = WW::KVStore<std::string, std::string>;
+using snapshot_store = WW::KVStore<std::string, std::string, std::less<std::string>, std::allocator<std::pair<const std::string, std::string>>,
+                                   WW::mapped_snapshot_policy>;
+
+/**
+ * @brief 生成第_Index个定长字符串键
+ * @param _Index 序号
+ * @return 键
+ */
+std::string make_key(std::size_t _Index)
+{
+    char _Buffer[32];
+    std::snprintf(_Buffer, sizeof(_Buffer), "key%012zu", _Index);
+    return _Buffer;
+}
+
+/**
+ * @brief 获取临时检查点文件路径
+ * @return 路径
+ */
+const std::string & checkpoint_path()
+{
+    static const std::string _Path = "/tmp/ww_snapshot_benchmark_" + std::to_string(::getpid()) + ".ckpt";
+    return _Path;
+}
+
+/**
+ * @brief 共享的内存储存，首次使用时构建并写出检查点
+ * @return 内存储存
+ */
+memory_store & shared_store()
+{
+    static memory_store * _Store = [] {
+        memory_store * _New_store = new memory_store();
+        for (std::size_t _Index = 0; _Index < KEY_COUNT; ++_Index) {
+            std::string _Key = make_key(_Index);
+            _New_store->put(_Key, _Key);
+        }
+        _New_store->checkpoint(checkpoint_path());
+        return _New_store;
+    }();
+
+    return *_Store;
+}
+
+/**
+ * @brief 随机命中的查找延迟
+ */
+template <typename _Ty_store>
+void BM_Lookup(benchmark::State & state, _Ty_store & _Store)
+{
+    std::mt19937_64 _Engine(42);
+    std::vector<std::string> _Keys;
+    for (std::size_t _Index = 0; _Index < 4096; ++_Index) {
+        _Keys.push_back(make_key(_Engine() % KEY_COUNT));
+    }
+
+    std::size_t _Index = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(_Store.get(_Keys[_Index++ & 4095]));
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_MemoryLookup(benchmark::State & state)
+{
+    BM_Lookup(state, shared_store());
+}
+
+void BM_SnapshotLookup(benchmark::State & state)
+{
+    shared_store();
+    snapshot_store _Store(checkpoint_path());
+    BM_Lookup(state, _Store);
+}
+
+/**
+ * @brief 打开快照的耗时
+ */
+void BM_SnapshotOpen(benchmark::State & state)
+{
+    shared_store();
+
+    for (auto _ : state) {
+        snapshot_store _Store(checkpoint_path());
+        benchmark::DoNotOptimize(_Store.size());
+    }
+}
+
+/**
+ * @brief 从检查点加载到内存跳表的耗时，作为对照
+ */
+void BM_MemoryLoad(benchmark::State & state)
+{
+    shared_store();
+
+    for (auto _ : state) {
+        memory_store _Store;
+        benchmark::DoNotOptimize(_Store.load(checkpoint_path()));
+    }
+}
+
+} // namespace
+
+BENCHMARK(BM_MemoryLookup);
+BENCHMARK(BM_SnapshotLookup);
+BENCHMARK(BM_SnapshotOpen)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_MemoryLoad)->Unit(benchmark::kMillisecond);
+
+int main(int argc, char ** argv)
+{
+    benchmark::Initialize(&argc, argv);
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    std::remove(checkpoint_path().c_str());
+    return 0;
+}
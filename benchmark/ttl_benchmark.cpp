@@ -0,0 +1,87 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <KVStore.h>
+
+namespace
+{
+
+constexpr std::size_t KEY_COUNT = 500000;
+constexpr std::int64_t OP_COUNT = 200000;
+
+using store_type = WW::KVStore<std::string, std::string>;
+
+/**
+ * @brief 生成第_Index个定长字符串键
+ * @param _Index 序号
+ * @return 键
+ */
+std::string make_key(std::size_t _Index)
+{
+    char _Buffer[32];
+    std::snprintf(_Buffer, sizeof(_Buffer), "session%012zu", _Index);
+    return _Buffer;
+}
+
+/**
+ * @brief 一半的键在同一时刻过期后，统计读写混合操作的延迟分布
+ * @details 参数为0时由写操作顺带逐步清理，为1时在第一次操作中一次性清理全部过期键，
+ * 模拟在储存外部维护过期索引并集中删除的做法
+ */
+void BM_ExpireStorm(benchmark::State & state)
+{
+    using namespace std::chrono_literals;
+
+    store_type _Store;
+    for (std::size_t _Index = 0; _Index < KEY_COUNT; ++_Index) {
+        _Store.put(make_key(_Index), "value");
+    }
+
+    // 插入会顺带清理，全部插入后再设置过期，保证过期的键在测量开始前都没有被清理
+    for (std::size_t _Index = 0; _Index < KEY_COUNT; _Index += 2) {
+        _Store.expire(make_key(_Index), 100ms);
+    }
+
+    std::this_thread::sleep_for(200ms);
+
+    std::mt19937_64 _Engine(1);
+    std::vector<double> _Latencies;
+    _Latencies.reserve(OP_COUNT);
+    bool _Bulk = state.range(0) == 1;
+    std::size_t _Next = KEY_COUNT;
+    std::string _Value;
+
+    for (auto _ : state) {
+        auto _Start = std::chrono::steady_clock::now();
+
+        if (_Bulk) {
+            _Store.sweep();
+            _Bulk = false;
+        }
+
+        if (_Engine() % 4 == 0) {
+            _Store.put(make_key(_Next++), "value");
+        } else {
+            benchmark::DoNotOptimize(_Store.get_into(make_key(_Engine() % KEY_COUNT), _Value));
+        }
+
+        _Latencies.push_back(std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - _Start).count());
+    }
+
+    std::sort(_Latencies.begin(), _Latencies.end());
+    state.counters["p50_ns"] = _Latencies[_Latencies.size() / 2];
+    state.counters["p99_ns"] = _Latencies[_Latencies.size() * 99 / 100];
+    state.counters["p999_ns"] = _Latencies[_Latencies.size() * 999 / 1000];
+    state.counters["max_ns"] = _Latencies.back();
+    state.counters["remaining"] = static_cast<double>(_Store.size());
+}
+
+} // namespace
+
+BENCHMARK(BM_ExpireStorm)->Arg(0)->Arg(1)->Iterations(OP_COUNT);
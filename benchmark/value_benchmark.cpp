@@ -0,0 +1,138 @@
+#include <cstdio>
+#include <string>
+#include <utility>
+
+#include <benchmark/benchmark.h>
+#include <KVStore.h>
+
+namespace
+{
+
+std::size_t copied_bytes = 0;      // 值被拷贝的字节数
+
+/**
+ * @brief 记录拷贝字节数的大值
+ */
+struct blob
+{
+    std::string data;
+
+    blob() = default;
+
+    explicit blob(std::size_t _Size)
+        : data(_Size, 'v')
+    {
+    }
+
+    blob(const blob & _Other)
+        : data(_Other.data)
+    {
+        copied_bytes += data.size();
+    }
+
+    blob(blob && _Other) noexcept = default;
+
+    blob & operator=(const blob & _Other)
+    {
+        data = _Other.data;
+        copied_bytes += data.size();
+        return *this;
+    }
+
+    blob & operator=(blob && _Other) noexcept = default;
+};
+
+} // namespace
+
+namespace WW
+{
+
+template <>
+struct _Codec<blob>
+{
+    static void encode(std::string & _Out, const blob & _Value)
+    {
+        _Codec<std::string>::encode(_Out, _Value.data);
+    }
+
+    static bool decode(const char *& _First, const char * _Last, blob & _Value)
+    {
+        return _Codec<std::string>::decode(_First, _Last, _Value.data);
+    }
+};
+
+} // namespace WW
+
+namespace
+{
+
+using store_type = WW::KVStore<std::string, blob>;
+
+/**
+ * @brief 以左值插入N字节的值再删除
+ */
+void BM_PutLvalue(benchmark::State & state)
+{
+    store_type _Store;
+    const blob _Value(static_cast<std::size_t>(state.range(0)));
+    const std::string _Key = "key";
+    copied_bytes = 0;
+
+    for (auto _ : state) {
+        _Store.put(_Key, _Value);
+        _Store.remove(_Key);
+    }
+
+    state.counters["copied_per_put"] = static_cast<double>(copied_bytes) / state.iterations();
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+/**
+ * @brief 以右值插入N字节的值再删除，值的构造不计入耗时
+ */
+void BM_PutRvalue(benchmark::State & state)
+{
+    store_type _Store;
+    const std::string _Key = "key";
+    copied_bytes = 0;
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        blob _Value(static_cast<std::size_t>(state.range(0)));
+        state.ResumeTiming();
+
+        _Store.put(_Key, std::move(_Value));
+        _Store.remove(_Key);
+    }
+
+    state.counters["copied_per_put"] = static_cast<double>(copied_bytes) / state.iterations();
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+/**
+ * @brief 以右值覆盖已有键的N字节的值，值的构造不计入耗时
+ */
+void BM_UpdateRvalue(benchmark::State & state)
+{
+    store_type _Store;
+    const std::string _Key = "key";
+    _Store.update(_Key, blob(static_cast<std::size_t>(state.range(0))));
+    copied_bytes = 0;
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        blob _Value(static_cast<std::size_t>(state.range(0)));
+        state.ResumeTiming();
+
+        _Store.update(_Key, std::move(_Value));
+    }
+
+    state.counters["copied_per_put"] = static_cast<double>(copied_bytes) / state.iterations();
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+} // namespace
+
+BENCHMARK(BM_PutLvalue)->Arg(4096)->Arg(65536);
+BENCHMARK(BM_PutRvalue)->Arg(4096)->Arg(65536);
+BENCHMARK(BM_UpdateRvalue)->Arg(4096)->Arg(65536);
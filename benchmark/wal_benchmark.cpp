@@ -0,0 +1,60 @@
+#include <atomic>
+#include <cstdio>
+#include <string>
+
+#include <unistd.h>
+
+#include <benchmark/benchmark.h>
+#include <KVStore.h>
+
+namespace
+{
+
+using lock_free_store = WW::KVStore<int, std::string, std::less<int>, std::allocator<std::pair<const int, std::string>>, WW::lock_free_policy>;
+
+/**
+ * @brief 带日志的写入吞吐，参数为同步模式
+ */
+void BM_LoggedPut(benchmark::State & state)
+{
+    static lock_free_store * _Store = nullptr;
+    static std::atomic<int> _Next_key(0);
+    static std::string _Path;
+
+    if (state.thread_index() == 0) {
+        _Path = "/tmp/ww_wal_benchmark_" + std::to_string(::getpid()) + ".log";
+        std::remove(_Path.c_str());
+
+        WW::wal_options _Options;
+        _Options.path = _Path;
+        _Options.sync_mode = static_cast<WW::wal_sync_mode>(state.range(0));
+
+        _Store = new lock_free_store();
+        _Store->open(_Options);
+        _Next_key.store(0);
+    }
+
+    const std::string _Value(100, 'v');
+
+    for (auto _ : state) {
+        _Store->put(_Next_key.fetch_add(1, std::memory_order_relaxed), _Value);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+
+    if (state.thread_index() == 0) {
+        delete _Store;
+        _Store = nullptr;
+        std::remove(_Path.c_str());
+    }
+}
+
+} // namespace
+
+BENCHMARK(BM_LoggedPut)
+    ->ArgName("sync_mode")
+    ->Arg(static_cast<int>(WW::wal_sync_mode::none))
+    ->Arg(static_cast<int>(WW::wal_sync_mode::periodic))
+    ->Arg(static_cast<int>(WW::wal_sync_mode::batch))
+    ->ThreadRange(1, 16)
+    ->UseRealTime();
@@ -0,0 +1,230 @@
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <KVStore.h>
+
+#include "Workload.h"
+
+namespace
+{
+
+constexpr std::uint64_t KEY_COUNT = 100000;
+constexpr std::size_t SCAN_LENGTH = 100;
+
+/**
+ * @brief KVStore
+ */
+struct kvstore_engine
+{
+    WW::KVStore<std::string, std::string> _Store;
+
+    bool get(const std::string & _Key, std::string & _Value)
+    {
+        return _Store.get_into(_Key, _Value);
+    }
+
+    void put(const std::string & _Key, const std::string & _Value)
+    {
+        _Store.update(_Key, _Value);
+    }
+
+    template <typename _Fn>
+    std::size_t scan(const std::string & _Start, std::size_t _Limit, _Fn _Callback)
+    {
+        return _Store.scan(_Start, std::string(1, '\x7f'), _Limit, _Callback);
+    }
+};
+
+/**
+ * @brief std::map基线
+ */
+struct map_engine
+{
+    std::map<std::string, std::string> _Map;
+
+    bool get(const std::string & _Key, std::string & _Value)
+    {
+        auto _It = _Map.find(_Key);
+        if (_It == _Map.end()) {
+            return false;
+        }
+
+        _Value = _It->second;
+        return true;
+    }
+
+    void put(const std::string & _Key, const std::string & _Value)
+    {
+        _Map.insert_or_assign(_Key, _Value);
+    }
+
+    template <typename _Fn>
+    std::size_t scan(const std::string & _Start, std::size_t _Limit, _Fn _Callback)
+    {
+        std::size_t _Count = 0;
+        for (auto _It = _Map.lower_bound(_Start); _It != _Map.end() && _Count < _Limit; ++_It, ++_Count) {
+            _Callback(_It->first, _It->second);
+        }
+        return _Count;
+    }
+};
+
+/**
+ * @brief std::unordered_map基线，不支持有序遍历
+ */
+struct unordered_map_engine
+{
+    std::unordered_map<std::string, std::string> _Map;
+
+    bool get(const std::string & _Key, std::string & _Value)
+    {
+        auto _It = _Map.find(_Key);
+        if (_It == _Map.end()) {
+            return false;
+        }
+
+        _Value = _It->second;
+        return true;
+    }
+
+    void put(const std::string & _Key, const std::string & _Value)
+    {
+        _Map.insert_or_assign(_Key, _Value);
+    }
+};
+
+/**
+ * @brief 预先生成全部键
+ * @param _Key_size 键长度
+ * @return 键数组，下标即序号
+ */
+std::vector<std::string> make_keys(std::size_t _Key_size)
+{
+    std::vector<std::string> _Keys;
+    _Keys.reserve(KEY_COUNT);
+
+    for (std::uint64_t _Index = 0; _Index < KEY_COUNT; ++_Index) {
+        _Keys.push_back(WW::bench::make_key(_Index, _Key_size));
+    }
+
+    return _Keys;
+}
+
+/**
+ * @brief 读写混合
+ * @details 参数依次为：0均匀/1 Zipf(0.99)分布、读操作百分比、键长度、值长度。
+ * 预先写入全部键，写操作覆盖已有键
+ */
+template <typename _Ty_engine>
+void BM_Mixed(benchmark::State & state)
+{
+    const bool _Skewed = state.range(0) == 1;
+    const std::uint64_t _Read_percent = static_cast<std::uint64_t>(state.range(1));
+    const std::vector<std::string> _Keys = make_keys(static_cast<std::size_t>(state.range(2)));
+    const std::string _Value(static_cast<std::size_t>(state.range(3)), 'v');
+
+    _Ty_engine _Engine;
+    for (const std::string & _Key : _Keys) {
+        _Engine.put(_Key, _Value);
+    }
+
+    WW::bench::key_chooser _Chooser(KEY_COUNT, _Skewed, 1);
+    std::mt19937_64 _Random(2);
+    std::string _Out;
+
+    for (auto _ : state) {
+        const std::string & _Key = _Keys[_Chooser()];
+
+        if (_Random() % 100 < _Read_percent) {
+            benchmark::DoNotOptimize(_Engine.get(_Key, _Out));
+        } else {
+            _Engine.put(_Key, _Value);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+/**
+ * @brief 插入KEY_COUNT个键，参数为0时按键的升序插入，为1时随机顺序
+ */
+template <typename _Ty_engine>
+void BM_Insert(benchmark::State & state)
+{
+    std::vector<std::string> _Keys = make_keys(20);
+    if (state.range(0) == 1) {
+        std::shuffle(_Keys.begin(), _Keys.end(), std::mt19937_64(3));
+    }
+
+    const std::string _Value(16, 'v');
+
+    for (auto _ : state) {
+        std::unique_ptr<_Ty_engine> _Engine(new _Ty_engine());
+        for (const std::string & _Key : _Keys) {
+            _Engine->put(_Key, _Value);
+        }
+
+        // 析构不计入耗时
+        state.PauseTiming();
+        _Engine.reset();
+        state.ResumeTiming();
+    }
+
+    state.SetItemsProcessed(state.iterations() * KEY_COUNT);
+}
+
+/**
+ * @brief 从均匀分布的随机起点按升序访问SCAN_LENGTH个键值对
+ */
+template <typename _Ty_engine>
+void BM_RangeScan(benchmark::State & state)
+{
+    const std::vector<std::string> _Keys = make_keys(20);
+    const std::string _Value(16, 'v');
+
+    _Ty_engine _Engine;
+    for (const std::string & _Key : _Keys) {
+        _Engine.put(_Key, _Value);
+    }
+
+    WW::bench::key_chooser _Chooser(KEY_COUNT, false, 4);
+    std::size_t _Bytes = 0;
+
+    for (auto _ : state) {
+        _Engine.scan(_Keys[_Chooser()], SCAN_LENGTH, [&_Bytes](const std::string & _Key, const std::string & _Val) {
+            _Bytes += _Key.size() + _Val.size();
+        });
+    }
+
+    benchmark::DoNotOptimize(_Bytes);
+    state.SetItemsProcessed(state.iterations() * SCAN_LENGTH);
+}
+
+/**
+ * @brief 读写混合的参数组合
+ */
+void mixed_arguments(benchmark::internal::Benchmark * _Bench)
+{
+    _Bench->ArgNames({"zipf", "read", "key", "value"});
+    _Bench->ArgsProduct({{0, 1}, {50, 95, 100}, {20, 64}, {16, 1024}});
+}
+
+} // namespace
+
+BENCHMARK_TEMPLATE(BM_Mixed, kvstore_engine)->Apply(mixed_arguments);
+BENCHMARK_TEMPLATE(BM_Mixed, map_engine)->Apply(mixed_arguments);
+BENCHMARK_TEMPLATE(BM_Mixed, unordered_map_engine)->Apply(mixed_arguments);
+
+BENCHMARK_TEMPLATE(BM_Insert, kvstore_engine)->ArgName("random")->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Insert, map_engine)->ArgName("random")->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Insert, unordered_map_engine)->ArgName("random")->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_TEMPLATE(BM_RangeScan, kvstore_engine);
+BENCHMARK_TEMPLATE(BM_RangeScan, map_engine);
@@ -0,0 +1,475 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <KVStore.h>
+#include <ShardedKVStore.h>
+
+#include "Histogram.h"
+#include "Workload.h"
+
+namespace
+{
+
+using clock_type = std::chrono::steady_clock;
+
+/**
+ * @brief 操作类型
+ */
+enum operation
+{
+    READ,
+    UPDATE,
+    INSERT,
+    SCAN,
+    READ_MODIFY_WRITE,
+    OPERATION_COUNT
+};
+
+const char * const OPERATION_NAMES[OPERATION_COUNT] = {"READ", "UPDATE", "INSERT", "SCAN", "READ-MODIFY-WRITE"};
+
+/**
+ * @brief 键的访问分布
+ */
+enum class distribution
+{
+    zipfian,        // Zipf分布，热点键打散在键空间中
+    latest          // 越新插入的键越热
+};
+
+/**
+ * @brief YCSB核心负载，各操作的比例之和为1
+ */
+struct workload
+{
+    char name;
+    double proportions[OPERATION_COUNT];
+    distribution request;
+};
+
+const workload WORKLOADS[] = {
+    {'a', {0.50, 0.50, 0.00, 0.00, 0.00}, distribution::zipfian},   // 读写各半
+    {'b', {0.95, 0.05, 0.00, 0.00, 0.00}, distribution::zipfian},   // 以读为主
+    {'c', {1.00, 0.00, 0.00, 0.00, 0.00}, distribution::zipfian},   // 只读
+    {'d', {0.95, 0.00, 0.05, 0.00, 0.00}, distribution::latest},    // 读最新插入的键
+    {'e', {0.00, 0.00, 0.05, 0.95, 0.00}, distribution::zipfian},   // 短范围扫描
+    {'f', {0.50, 0.00, 0.00, 0.00, 0.50}, distribution::zipfian},   // 读-改-写
+};
+
+/**
+ * @brief 命令行选项
+ */
+struct options
+{
+    const workload * load = &WORKLOADS[0];
+    std::string engine = "lock_free";
+    unsigned threads = 4;
+    std::uint64_t records = 100000;         // 预先写入的键个数
+    std::uint64_t operations = 1000000;     // 所有线程的总操作数
+    double seconds = 0;                     // 大于0时按时间运行，忽略operations
+    std::size_t value_size = 100;
+    std::size_t max_scan_length = 100;      // 扫描长度均匀分布于[1, max_scan_length]
+    double interval = 1.0;                  // 吞吐量的报告间隔，单位为秒
+};
+
+/**
+ * @brief 无锁跳表引擎的KVStore
+ */
+struct lock_free_engine
+{
+    WW::KVStore<std::string, std::string, std::less<std::string>, std::allocator<std::pair<const std::string, std::string>>,
+                WW::lock_free_policy> _Store;
+
+    bool read(const std::string & _Key, std::string & _Value)
+    {
+        return _Store.get_into(_Key, _Value);
+    }
+
+    void write(const std::string & _Key, const std::string & _Value)
+    {
+        _Store.update(_Key, _Value);
+    }
+
+    std::size_t scan(const std::string & _Start, std::size_t _Limit)
+    {
+        return _Store.scan(_Start, std::string(1, '\x7f'), _Limit, [](const std::string &, const std::string &) {});
+    }
+};
+
+/**
+ * @brief 分片KVStore
+ */
+struct sharded_engine
+{
+    WW::ShardedKVStore<std::string, std::string> _Store;
+
+    bool read(const std::string & _Key, std::string & _Value)
+    {
+        return _Store.get_into(_Key, _Value);
+    }
+
+    void write(const std::string & _Key, const std::string & _Value)
+    {
+        _Store.update(_Key, _Value);
+    }
+
+    std::size_t scan(const std::string & _Start, std::size_t _Limit)
+    {
+        return _Store.scan(_Start, std::string(1, '\x7f'), _Limit, [](const std::string &, const std::string &) {});
+    }
+};
+
+/**
+ * @brief 单线程KVStore，所有操作由一把互斥锁串行化，作为基线
+ */
+struct locked_engine
+{
+    std::mutex _Mutex;
+    WW::KVStore<std::string, std::string> _Store;
+
+    bool read(const std::string & _Key, std::string & _Value)
+    {
+        std::lock_guard<std::mutex> _Lock(_Mutex);
+        return _Store.get_into(_Key, _Value);
+    }
+
+    void write(const std::string & _Key, const std::string & _Value)
+    {
+        std::lock_guard<std::mutex> _Lock(_Mutex);
+        _Store.update(_Key, _Value);
+    }
+
+    std::size_t scan(const std::string & _Start, std::size_t _Limit)
+    {
+        std::lock_guard<std::mutex> _Lock(_Mutex);
+        return _Store.scan(_Start, std::string(1, '\x7f'), _Limit, [](const std::string &, const std::string &) {});
+    }
+};
+
+/**
+ * @brief 每个线程的统计，独占缓存行
+ */
+struct alignas(64) worker_stats
+{
+    std::atomic<std::uint64_t> done{0};                 // 已完成的操作数，报告线程读取
+    std::uint64_t misses = 0;                           // 读不到的次数
+    WW::bench::latency_histogram latency[OPERATION_COUNT];
+};
+
+/**
+ * @brief 所有线程共享的状态
+ */
+struct shared_state
+{
+    std::atomic<std::uint64_t> next_insert;             // 下一个插入的键序号
+    WW::bench::acknowledged_counter inserted;           // 已经连续插入完成的键序号上限
+    std::atomic<bool> stop{false};                      // 按时间运行时的停止信号
+
+    explicit shared_state(std::uint64_t _Records)
+        : next_insert(_Records)
+        , inserted(_Records)
+    {
+    }
+};
+
+/**
+ * @brief 按比例选择操作
+ * @param _Load 负载
+ * @param _Uniform [0, 1)上的随机数
+ * @return 操作
+ */
+operation choose_operation(const workload & _Load, double _Uniform)
+{
+    for (int _Op = 0; _Op < OPERATION_COUNT; ++_Op) {
+        _Uniform -= _Load.proportions[_Op];
+        if (_Uniform < 0) {
+            return static_cast<operation>(_Op);
+        }
+    }
+
+    return READ;
+}
+
+/**
+ * @brief 工作线程
+ * @param _Engine 引擎
+ * @param _Options 选项
+ * @param _Shared 共享状态
+ * @param _Stats 本线程的统计
+ * @param _Operations 本线程的操作数，按时间运行时忽略
+ * @param _Seed 种子
+ */
+template <typename _Ty_engine>
+void run_worker(_Ty_engine & _Engine, const options & _Options, shared_state & _Shared, worker_stats & _Stats,
+                std::uint64_t _Operations, std::uint64_t _Seed)
+{
+    const workload & _Load = *_Options.load;
+    const bool _Timed = _Options.seconds > 0;
+
+    WW::bench::key_chooser _Chooser(_Options.records, true, _Seed);
+    WW::bench::zipfian_generator _Recency(_Options.records, 0.99, _Seed + 1);
+    std::mt19937_64 _Random(_Seed + 2);
+    std::uniform_real_distribution<double> _Uniform(0.0, 1.0);
+
+    const std::string _Value(_Options.value_size, 'v');
+    std::string _Modified(_Options.value_size, 'w');
+    std::string _Out;
+
+    for (std::uint64_t _Done = 0; _Timed ? !_Shared.stop.load(std::memory_order_relaxed) : _Done < _Operations; ++_Done) {
+        operation _Op = choose_operation(_Load, _Uniform(_Random));
+
+        // 选键不计入延迟
+        std::uint64_t _Index = 0;
+        if (_Op == INSERT) {
+            _Index = _Shared.next_insert.fetch_add(1, std::memory_order_relaxed);
+        } else if (_Load.request == distribution::latest) {
+            // 插入乱序完成，只读连续完成的部分，保证读到的键都已存在
+            std::uint64_t _Newest = _Shared.inserted.limit();
+            std::uint64_t _Back = _Recency();
+            _Index = _Back < _Newest ? _Newest - 1 - _Back : 0;
+        } else {
+            _Index = _Chooser();
+        }
+        const std::string _Key = WW::bench::make_key(_Index);
+
+        auto _Start = clock_type::now();
+
+        switch (_Op) {
+        case READ:
+            _Stats.misses += _Engine.read(_Key, _Out) ? 0 : 1;
+            break;
+        case UPDATE:
+            _Engine.write(_Key, _Value);
+            break;
+        case INSERT:
+            _Engine.write(_Key, _Value);
+            break;
+        case SCAN:
+            _Engine.scan(_Key, 1 + _Random() % _Options.max_scan_length);
+            break;
+        case READ_MODIFY_WRITE:
+            _Stats.misses += _Engine.read(_Key, _Out) ? 0 : 1;
+            _Modified[_Done % _Modified.size()] ^= 1;
+            _Engine.write(_Key, _Modified);
+            break;
+        default:
+            break;
+        }
+
+        auto _Elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(clock_type::now() - _Start).count();
+        _Stats.latency[_Op].record(static_cast<std::uint64_t>(_Elapsed));
+        _Stats.done.store(_Done + 1, std::memory_order_relaxed);
+
+        if (_Op == INSERT) {
+            _Shared.inserted.acknowledge(_Index);
+        }
+    }
+}
+
+/**
+ * @brief 加载数据、运行负载并输出结果
+ * @param _Options 选项
+ */
+template <typename _Ty_engine>
+void run(const options & _Options)
+{
+    std::unique_ptr<_Ty_engine> _Engine(new _Ty_engine());
+    const std::string _Value(_Options.value_size, 'v');
+
+    auto _Load_start = clock_type::now();
+    for (std::uint64_t _Index = 0; _Index < _Options.records; ++_Index) {
+        _Engine->write(WW::bench::make_key(_Index), _Value);
+    }
+    double _Load_seconds = std::chrono::duration<double>(clock_type::now() - _Load_start).count();
+
+    std::printf("workload %c, engine %s, %u threads, %llu records loaded in %.2f s\n",
+                _Options.load->name, _Options.engine.c_str(), _Options.threads,
+                static_cast<unsigned long long>(_Options.records), _Load_seconds);
+
+    shared_state _Shared(_Options.records);
+
+    std::vector<std::unique_ptr<worker_stats>> _Stats;
+    std::vector<std::thread> _Workers;
+    std::atomic<unsigned> _Running(_Options.threads);
+
+    auto _Start = clock_type::now();
+
+    for (unsigned _Thread = 0; _Thread < _Options.threads; ++_Thread) {
+        std::uint64_t _Share = _Options.operations / _Options.threads + (_Thread < _Options.operations % _Options.threads ? 1 : 0);
+        _Stats.emplace_back(new worker_stats());
+
+        _Workers.emplace_back([&, _Share, _Thread] {
+            run_worker(*_Engine, _Options, _Shared, *_Stats[_Thread], _Share, 1000 * (_Thread + 1));
+            _Running.fetch_sub(1);
+        });
+    }
+
+    // 定期报告吞吐量
+    auto _Total_done = [&_Stats] {
+        std::uint64_t _Sum = 0;
+        for (const auto & _Stat : _Stats) {
+            _Sum += _Stat->done.load(std::memory_order_relaxed);
+        }
+        return _Sum;
+    };
+
+    auto _Interval = std::chrono::duration<double>(_Options.interval);
+    auto _Next_report = _Start + std::chrono::duration_cast<clock_type::duration>(_Interval);
+    std::uint64_t _Last_done = 0;
+    auto _Last_time = _Start;
+
+    while (_Running.load() != 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        auto _Now = clock_type::now();
+
+        if (_Options.seconds > 0 && std::chrono::duration<double>(_Now - _Start).count() >= _Options.seconds) {
+            _Shared.stop.store(true);
+        }
+
+        if (_Now >= _Next_report) {
+            std::uint64_t _Done = _Total_done();
+            double _Window = std::chrono::duration<double>(_Now - _Last_time).count();
+            std::printf("[%8.1f s] %12.0f ops/s\n", std::chrono::duration<double>(_Now - _Start).count(),
+                        static_cast<double>(_Done - _Last_done) / _Window);
+
+            _Last_done = _Done;
+            _Last_time = _Now;
+            _Next_report += std::chrono::duration_cast<clock_type::duration>(_Interval);
+        }
+    }
+
+    for (std::thread & _Worker : _Workers) {
+        _Worker.join();
+    }
+
+    double _Runtime = std::chrono::duration<double>(clock_type::now() - _Start).count();
+
+    // 合并各线程的统计
+    WW::bench::latency_histogram _Merged[OPERATION_COUNT];
+    std::uint64_t _Misses = 0;
+    for (const auto & _Stat : _Stats) {
+        for (int _Op = 0; _Op < OPERATION_COUNT; ++_Op) {
+            _Merged[_Op].merge(_Stat->latency[_Op]);
+        }
+        _Misses += _Stat->misses;
+    }
+
+    std::uint64_t _Total = _Total_done();
+    std::printf("[OVERALL] runtime %.3f s, %llu operations, throughput %.0f ops/s, %llu read misses\n",
+                _Runtime, static_cast<unsigned long long>(_Total), static_cast<double>(_Total) / _Runtime,
+                static_cast<unsigned long long>(_Misses));
+
+    std::printf("%-18s %12s %10s %10s %10s %10s %10s\n", "operation (us)", "count", "mean", "p50", "p99", "p99.9", "max");
+    for (int _Op = 0; _Op < OPERATION_COUNT; ++_Op) {
+        const WW::bench::latency_histogram & _Hist = _Merged[_Op];
+        if (_Hist.count() == 0) {
+            continue;
+        }
+
+        std::printf("%-18s %12llu %10.2f %10.2f %10.2f %10.2f %10.2f\n", OPERATION_NAMES[_Op],
+                    static_cast<unsigned long long>(_Hist.count()), _Hist.mean() / 1000.0,
+                    _Hist.percentile(50) / 1000.0, _Hist.percentile(99) / 1000.0,
+                    _Hist.percentile(99.9) / 1000.0, _Hist.max() / 1000.0);
+    }
+}
+
+/**
+ * @brief 输出用法
+ * @param _Program 程序名
+ */
+void usage(const char * _Program)
+{
+    std::fprintf(stderr,
+        "usage: %s [options]\n"
+        "  --workload=a|b|c|d|e|f     YCSB core workload (default a)\n"
+        "  --engine=lock_free|sharded|locked\n"
+        "                             store under test (default lock_free)\n"
+        "  --threads=N                client threads (default 4)\n"
+        "  --records=N                keys loaded before the run (default 100000)\n"
+        "  --operations=N             total operations across threads (default 1000000)\n"
+        "  --seconds=S                run for S seconds instead of a fixed operation count\n"
+        "  --value-size=N             value size in bytes (default 100)\n"
+        "  --scan-length=N            maximum scan length for workload e (default 100)\n"
+        "  --interval=S               throughput report interval in seconds (default 1)\n",
+        _Program);
+}
+
+/**
+ * @brief 解析`--name=value`形式的参数
+ * @param _Arg 参数
+ * @param _Name 选项名，包含`--`和`=`
+ * @return 值，名字不匹配时为空
+ */
+const char * option_value(const char * _Arg, const char * _Name)
+{
+    std::size_t _Length = std::strlen(_Name);
+    return std::strncmp(_Arg, _Name, _Length) == 0 ? _Arg + _Length : nullptr;
+}
+
+} // namespace
+
+int main(int argc, char ** argv)
+{
+    options _Options;
+
+    for (int _Index = 1; _Index < argc; ++_Index) {
+        const char * _Arg = argv[_Index];
+        const char * _Value = nullptr;
+
+        if ((_Value = option_value(_Arg, "--workload=")) != nullptr) {
+            _Options.load = nullptr;
+            for (const workload & _Load : WORKLOADS) {
+                if (_Value[0] == _Load.name && _Value[1] == '\0') {
+                    _Options.load = &_Load;
+                }
+            }
+        } else if ((_Value = option_value(_Arg, "--engine=")) != nullptr) {
+            _Options.engine = _Value;
+        } else if ((_Value = option_value(_Arg, "--threads=")) != nullptr) {
+            _Options.threads = static_cast<unsigned>(std::strtoul(_Value, nullptr, 10));
+        } else if ((_Value = option_value(_Arg, "--records=")) != nullptr) {
+            _Options.records = std::strtoull(_Value, nullptr, 10);
+        } else if ((_Value = option_value(_Arg, "--operations=")) != nullptr) {
+            _Options.operations = std::strtoull(_Value, nullptr, 10);
+        } else if ((_Value = option_value(_Arg, "--seconds=")) != nullptr) {
+            _Options.seconds = std::strtod(_Value, nullptr);
+        } else if ((_Value = option_value(_Arg, "--value-size=")) != nullptr) {
+            _Options.value_size = std::strtoull(_Value, nullptr, 10);
+        } else if ((_Value = option_value(_Arg, "--scan-length=")) != nullptr) {
+            _Options.max_scan_length = std::strtoull(_Value, nullptr, 10);
+        } else if ((_Value = option_value(_Arg, "--interval=")) != nullptr) {
+            _Options.interval = std::strtod(_Value, nullptr);
+        } else {
+            usage(argv[0]);
+            return std::strcmp(_Arg, "--help") == 0 ? 0 : 1;
+        }
+    }
+
+    if (_Options.load == nullptr || _Options.threads == 0 || _Options.records == 0 || _Options.value_size == 0
+        || _Options.max_scan_length == 0 || _Options.interval <= 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    if (_Options.engine == "lock_free") {
+        run<lock_free_engine>(_Options);
+    } else if (_Options.engine == "sharded") {
+        run<sharded_engine>(_Options);
+    } else if (_Options.engine == "locked") {
+        run<locked_engine>(_Options);
+    } else {
+        usage(argv[0]);
+        return 1;
+    }
+
+    return 0;
+}
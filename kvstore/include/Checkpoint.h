@@ -0,0 +1,655 @@
+#pragma once
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <Checksum.h>
+#include <Codec.h>
+
+namespace WW
+{
+
+/**
+ * @brief 检查点文件格式
+ * @details 文件由若干数据块、一个索引块和定长的尾部组成：`data block... | index block | footer`。
+ * 数据块内的条目按键升序排列，每个键只保存与前一个键不同的后缀，块内第一个键保存完整内容，
+ * 条目格式为`shared(varint) | unshared(varint) | value_size(varint) | deadline(varint) | key_suffix | value`，
+ * deadline为系统时钟的过期时间（自纪元起的纳秒数），0表示没有过期时间，
+ * 块末尾是覆盖整个块的crc32c(4)。
+ * 索引块为每个数据块保存`offset | size | count | first_key`，同样以crc32c(4)结尾。
+ * 尾部为`index_offset(8) | index_size(8) | entry_count(8) | magic(8)`。
+ * 键经过`_Key_codec`序列化为保持顺序的字节串，相邻的键共享较长的前缀；
+ * 值经过`_Codec`序列化，再按上述格式保存
+ */
+struct _Checkpoint_format
+{
+    using size_type = std::size_t;
+
+    static constexpr std::uint64_t MAGIC = 0x57574B5643500003ull;  // "WWKVCP"与版本号
+    static constexpr size_type BLOCK_SIZE = 4096;                   // 数据块的目标大小
+    static constexpr size_type CHECKSUM_SIZE = 4;                   // 校验和大小
+    static constexpr size_type FOOTER_SIZE = 32;                    // 尾部大小
+
+    /**
+     * @brief 数据块在文件中的位置，即索引块中的一项
+     */
+    struct block_handle
+    {
+        std::uint64_t _Offset;          // 数据块起始偏移
+        std::uint64_t _Size;            // 数据块大小，不包括校验和
+        std::uint64_t _Count;           // 数据块中的条目个数
+        std::string _First_key;         // 数据块中第一个键序列化后的字节串
+    };
+
+    /**
+     * @brief 尾部
+     */
+    struct footer
+    {
+        std::uint64_t _Index_offset;    // 索引块起始偏移
+        std::uint64_t _Index_size;      // 索引块大小，不包括校验和
+        std::uint64_t _Count;           // 条目总数
+    };
+
+    /**
+     * @brief 追加校验和
+     * @param _Out 输出缓冲区，校验和覆盖其全部内容
+     */
+    static void seal(std::string & _Out)
+    {
+        std::uint32_t _Crc = _Crc32c(_Out.data(), _Out.size());
+        _Out.append(reinterpret_cast<const char *>(&_Crc), CHECKSUM_SIZE);
+    }
+
+    /**
+     * @brief 校验一个以校验和结尾的块
+     * @param _Data 块起始
+     * @param _Size 块大小，不包括校验和
+     * @return 是否通过校验
+     */
+    static bool verify(const char * _Data, size_type _Size) noexcept
+    {
+        std::uint32_t _Crc = 0;
+        std::memcpy(&_Crc, _Data + _Size, CHECKSUM_SIZE);
+        return _Crc32c(_Data, _Size) == _Crc;
+    }
+
+    /**
+     * @brief 编码尾部
+     * @param _Footer 尾部
+     * @return 定长的尾部字节串
+     */
+    static std::string encode_footer(const footer & _Footer)
+    {
+        std::uint64_t _Fields[4] = {_Footer._Index_offset, _Footer._Index_size, _Footer._Count, MAGIC};
+        return std::string(reinterpret_cast<const char *>(_Fields), FOOTER_SIZE);
+    }
+
+    /**
+     * @brief 解码尾部
+     * @param _Data 尾部起始，长度为`FOOTER_SIZE`
+     * @param _File_size 文件大小，用于检查索引块的位置
+     * @return 尾部
+     */
+    static footer decode_footer(const char * _Data, std::uint64_t _File_size)
+    {
+        std::uint64_t _Fields[4];
+        std::memcpy(_Fields, _Data, FOOTER_SIZE);
+
+        if (_Fields[3] != MAGIC
+            || _Fields[0] > _File_size
+            || _Fields[1] > _File_size - _Fields[0]
+            || _Fields[0] + _Fields[1] + CHECKSUM_SIZE + FOOTER_SIZE != _File_size) {
+            throw_corrupted();
+        }
+
+        return footer{_Fields[0], _Fields[1], _Fields[2]};
+    }
+
+    /**
+     * @brief 解码索引块
+     * @param _Data 索引块起始，之后紧跟校验和
+     * @param _Size 索引块大小，不包括校验和
+     * @param _Index_offset 索引块起始偏移，所有数据块都必须位于它之前
+     * @return 数据块位置列表
+     */
+    static std::vector<block_handle> decode_index(const char * _Data, size_type _Size, std::uint64_t _Index_offset)
+    {
+        if (!verify(_Data, _Size)) {
+            throw_corrupted();
+        }
+
+        std::vector<block_handle> _Index;
+        const char * _First = _Data;
+        const char * _Last = _Data + _Size;
+
+        while (_First < _Last) {
+            block_handle _Handle;
+            std::uint64_t _Key_size = 0;
+
+            if (!_Get_varint(_First, _Last, _Handle._Offset)
+                || !_Get_varint(_First, _Last, _Handle._Size)
+                || !_Get_varint(_First, _Last, _Handle._Count)
+                || !_Get_varint(_First, _Last, _Key_size)
+                || static_cast<std::uint64_t>(_Last - _First) < _Key_size
+                || _Handle._Offset > _Index_offset
+                || _Handle._Size + CHECKSUM_SIZE > _Index_offset - _Handle._Offset) {
+                throw_corrupted();
+            }
+
+            _Handle._First_key.assign(_First, static_cast<size_type>(_Key_size));
+            _First += _Key_size;
+            _Index.push_back(std::move(_Handle));
+        }
+
+        return _Index;
+    }
+
+    /**
+     * @brief 抛出文件损坏异常
+     */
+    [[noreturn]] static void throw_corrupted()
+    {
+        throw std::runtime_error("checkpoint corrupted");
+    }
+};
+
+/**
+ * @brief 数据块游标
+ * @details 顺序解码一个已经通过校验的数据块，还原出每个条目完整的键字节串
+ */
+class _Checkpoint_block_cursor
+{
+public:
+    using size_type = std::size_t;
+
+private:
+    const char * _Cur;                  // 下一个条目的起始
+    const char * _Last;                 // 数据块末尾
+    std::string _Key;                   // 当前条目的键
+    const char * _Value;                // 当前条目的值
+    size_type _Value_size;              // 当前条目的值大小
+    std::uint64_t _Deadline;            // 当前条目的过期时间，0表示没有
+
+public:
+    _Checkpoint_block_cursor(const char * _First, const char * _Last)
+        : _Cur(_First)
+        , _Last(_Last)
+        , _Key()
+        , _Value(nullptr)
+        , _Value_size(0)
+        , _Deadline(0)
+    {
+    }
+
+public:
+    /**
+     * @brief 移动到下一个条目
+     * @return 是否还有条目
+     */
+    bool next()
+    {
+        if (_Cur == _Last) {
+            return false;
+        }
+
+        std::uint64_t _Shared = 0;
+        std::uint64_t _Unshared = 0;
+        std::uint64_t _Size = 0;
+
+        if (!_Get_varint(_Cur, _Last, _Shared)
+            || !_Get_varint(_Cur, _Last, _Unshared)
+            || !_Get_varint(_Cur, _Last, _Size)
+            || !_Get_varint(_Cur, _Last, _Deadline)
+            || _Shared > _Key.size()
+            || static_cast<std::uint64_t>(_Last - _Cur) < _Unshared
+            || static_cast<std::uint64_t>(_Last - _Cur) - _Unshared < _Size) {
+            _Checkpoint_format::throw_corrupted();
+        }
+
+        // 保留与前一个键相同的前缀，再接上不同的后缀
+        _Key.resize(static_cast<size_type>(_Shared));
+        _Key.append(_Cur, static_cast<size_type>(_Unshared));
+        _Cur += _Unshared;
+
+        _Value = _Cur;
+        _Value_size = static_cast<size_type>(_Size);
+        _Cur += _Size;
+
+        return true;
+    }
+
+    /**
+     * @brief 获取当前条目的键
+     * @return 序列化后的键
+     */
+    const std::string & key() const noexcept
+    {
+        return _Key;
+    }
+
+    /**
+     * @brief 获取当前条目的值起始
+     * @return 序列化后的值
+     */
+    const char * value_data() const noexcept
+    {
+        return _Value;
+    }
+
+    /**
+     * @brief 获取当前条目的值大小
+     * @return 字节数
+     */
+    size_type value_size() const noexcept
+    {
+        return _Value_size;
+    }
+
+    /**
+     * @brief 获取当前条目的过期时间
+     * @return 系统时钟自纪元起的纳秒数，0表示没有过期时间
+     */
+    std::uint64_t deadline() const noexcept
+    {
+        return _Deadline;
+    }
+
+    /**
+     * @brief 判断当前条目是否已经过期
+     * @param _Wall_now 系统时钟的当前时间
+     * @return 是否已经过期
+     */
+    bool expired(std::uint64_t _Wall_now) const noexcept
+    {
+        return _Deadline != 0 && _Deadline <= _Wall_now;
+    }
+};
+
+/**
+ * @brief 检查点写入器
+ * @details 条目必须按键的严格升序添加。内容先写入`path.tmp`，`finish`时刷盘后原子地重命名为目标文件，
+ * 未调用`finish`就析构时删除临时文件，不会影响已有的检查点
+ */
+class _Checkpoint_writer
+{
+public:
+    using size_type = std::size_t;
+
+private:
+    std::string _Path;                  // 目标路径
+    std::string _Tmp_path;              // 临时文件路径
+    int _Fd;                            // 临时文件描述符
+    std::string _Block;                 // 正在构建的数据块
+    std::string _First_key;             // 当前数据块的第一个键
+    std::string _Last_key;              // 上一个键
+    std::string _Index;                 // 索引块
+    std::string _Key_buffer;            // 序列化键的缓冲区
+    std::string _Value_buffer;          // 序列化值的缓冲区
+    std::uint64_t _Offset;              // 已写出的字节数
+    std::uint64_t _Block_count;         // 当前数据块中的条目个数
+    std::uint64_t _Count;               // 条目总数
+
+public:
+    explicit _Checkpoint_writer(const std::string & _Path)
+        : _Path(_Path)
+        , _Tmp_path(_Path + ".tmp")
+        , _Fd(-1)
+        , _Block()
+        , _First_key()
+        , _Last_key()
+        , _Index()
+        , _Key_buffer()
+        , _Value_buffer()
+        , _Offset(0)
+        , _Block_count(0)
+        , _Count(0)
+    {
+        _Fd = ::open(_Tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (_Fd < 0) {
+            _Throw_system_error("checkpoint open");
+        }
+
+        _Block.reserve(_Checkpoint_format::BLOCK_SIZE * 2);
+    }
+
+    _Checkpoint_writer(const _Checkpoint_writer &) = delete;
+
+    _Checkpoint_writer & operator=(const _Checkpoint_writer &) = delete;
+
+    ~_Checkpoint_writer()
+    {
+        if (_Fd >= 0) {
+            ::close(_Fd);
+            ::unlink(_Tmp_path.c_str());
+        }
+    }
+
+public:
+    /**
+     * @brief 添加一个键值对
+     * @param _Key 键
+     * @param _Value 值
+     * @param _Wall_deadline 系统时钟的过期时间，自纪元起的纳秒数，0表示没有过期时间
+     */
+    template <typename _Ty_key, typename _Ty_value>
+    void add(const _Ty_key & _Key, const _Ty_value & _Value, std::uint64_t _Wall_deadline = 0)
+    {
+        _Key_buffer.clear();
+        _Value_buffer.clear();
+        _Key_codec<_Ty_key>::encode(_Key_buffer, _Key);
+        _Codec<_Ty_value>::encode(_Value_buffer, _Value);
+
+        _Add_encoded(_Key_buffer, _Value_buffer, _Wall_deadline);
+    }
+
+    /**
+     * @brief 写出索引块和尾部，刷盘后替换目标文件
+     * @return 条目总数
+     */
+    size_type finish()
+    {
+        _Flush_block();
+
+        std::uint64_t _Index_offset = _Offset;
+        std::uint64_t _Index_size = _Index.size();
+        _Checkpoint_format::seal(_Index);
+        _Index.append(_Checkpoint_format::encode_footer({_Index_offset, _Index_size, _Count}));
+        _Write_all(_Index);
+
+        if (::fsync(_Fd) != 0) {
+            _Throw_system_error("checkpoint sync");
+        }
+
+        ::close(_Fd);
+        _Fd = -1;
+
+        if (std::rename(_Tmp_path.c_str(), _Path.c_str()) != 0) {
+            int _Code = errno;
+            ::unlink(_Tmp_path.c_str());
+            errno = _Code;
+            _Throw_system_error("checkpoint rename");
+        }
+
+        _Sync_directory();
+
+        return static_cast<size_type>(_Count);
+    }
+
+private:
+    /**
+     * @brief 添加一个已经序列化的条目
+     * @param _Key 键
+     * @param _Value 值
+     * @param _Wall_deadline 过期时间
+     */
+    void _Add_encoded(const std::string & _Key, const std::string & _Value, std::uint64_t _Wall_deadline)
+    {
+        size_type _Shared = 0;
+
+        if (_Block_count == 0) {
+            // 新数据块的第一个键保存完整内容，并作为索引项
+            _First_key = _Key;
+        } else {
+            size_type _Limit = _Last_key.size() < _Key.size() ? _Last_key.size() : _Key.size();
+            while (_Shared < _Limit && _Last_key[_Shared] == _Key[_Shared]) {
+                ++_Shared;
+            }
+        }
+
+        _Put_varint(_Block, _Shared);
+        _Put_varint(_Block, _Key.size() - _Shared);
+        _Put_varint(_Block, _Value.size());
+        _Put_varint(_Block, _Wall_deadline);
+        _Block.append(_Key, _Shared, std::string::npos);
+        _Block.append(_Value);
+
+        _Last_key = _Key;
+        ++_Block_count;
+        ++_Count;
+
+        if (_Block.size() >= _Checkpoint_format::BLOCK_SIZE) {
+            _Flush_block();
+        }
+    }
+
+    /**
+     * @brief 写出当前数据块，并补全它的索引项
+     */
+    void _Flush_block()
+    {
+        if (_Block_count == 0) {
+            return;
+        }
+
+        _Put_varint(_Index, _Offset);
+        _Put_varint(_Index, _Block.size());
+        _Put_varint(_Index, _Block_count);
+        _Put_varint(_Index, _First_key.size());
+        _Index.append(_First_key);
+
+        _Checkpoint_format::seal(_Block);
+        _Write_all(_Block);
+
+        _Block.clear();
+        _Block_count = 0;
+    }
+
+    /**
+     * @brief 写出全部数据
+     * @param _Data 数据
+     */
+    void _Write_all(const std::string & _Data)
+    {
+        const char * _Cur = _Data.data();
+        size_type _Size = _Data.size();
+
+        while (_Size > 0) {
+            ssize_t _Written = ::write(_Fd, _Cur, _Size);
+            if (_Written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                _Throw_system_error("checkpoint write");
+            }
+
+            _Cur += _Written;
+            _Size -= static_cast<size_type>(_Written);
+        }
+
+        _Offset += _Data.size();
+    }
+
+    /**
+     * @brief 刷新目标文件所在目录，保证重命名被持久化
+     */
+    void _Sync_directory() const noexcept
+    {
+        std::string::size_type _Slash = _Path.find_last_of('/');
+        std::string _Directory = _Slash == std::string::npos ? "." : _Path.substr(0, _Slash == 0 ? 1 : _Slash);
+
+        int _Dir_fd = ::open(_Directory.c_str(), O_RDONLY);
+        if (_Dir_fd >= 0) {
+            ::fsync(_Dir_fd);
+            ::close(_Dir_fd);
+        }
+    }
+
+    /**
+     * @brief 根据errno抛出异常
+     * @param _What 描述
+     */
+    [[noreturn]] static void _Throw_system_error(const char * _What)
+    {
+        throw std::system_error(errno, std::generic_category(), _What);
+    }
+};
+
+/**
+ * @brief 检查点读取器
+ * @details 打开时读取并校验尾部和索引块，之后按顺序逐块读取数据块
+ */
+class _Checkpoint_reader
+{
+public:
+    using size_type = std::size_t;
+    using block_handle = _Checkpoint_format::block_handle;
+
+private:
+    int _Fd;                                // 文件描述符
+    std::vector<block_handle> _Index;       // 数据块位置列表
+    std::uint64_t _Count;                   // 条目总数
+
+public:
+    explicit _Checkpoint_reader(const std::string & _Path)
+        : _Fd(-1)
+        , _Index()
+        , _Count(0)
+    {
+        _Fd = ::open(_Path.c_str(), O_RDONLY);
+        if (_Fd < 0) {
+            _Throw_system_error("checkpoint open");
+        }
+
+        try {
+            _Read_index();
+        } catch (...) {
+            ::close(_Fd);
+            throw;
+        }
+    }
+
+    _Checkpoint_reader(const _Checkpoint_reader &) = delete;
+
+    _Checkpoint_reader & operator=(const _Checkpoint_reader &) = delete;
+
+    ~_Checkpoint_reader()
+    {
+        ::close(_Fd);
+    }
+
+public:
+    /**
+     * @brief 获取条目总数
+     * @return 条目总数
+     */
+    size_type size() const noexcept
+    {
+        return static_cast<size_type>(_Count);
+    }
+
+    /**
+     * @brief 按键的升序访问所有键值对
+     * @param _Callback 回调，参数为键和值的右值，以及系统时钟的过期时间，0表示没有过期时间
+     */
+    template <typename _Ty_key, typename _Ty_value, typename _Fn>
+    void for_each(_Fn _Callback) const
+    {
+        std::string _Buffer;
+
+        for (const block_handle & _Handle : _Index) {
+            _Buffer.resize(static_cast<size_type>(_Handle._Size) + _Checkpoint_format::CHECKSUM_SIZE);
+            _Read_at(&_Buffer[0], _Buffer.size(), _Handle._Offset);
+
+            if (!_Checkpoint_format::verify(_Buffer.data(), static_cast<size_type>(_Handle._Size))) {
+                _Checkpoint_format::throw_corrupted();
+            }
+
+            _Checkpoint_block_cursor _Cursor(_Buffer.data(), _Buffer.data() + _Handle._Size);
+            while (_Cursor.next()) {
+                _Ty_key _Key = _Ty_key();
+                _Ty_value _Value = _Ty_value();
+
+                const char * _Key_first = _Cursor.key().data();
+                const char * _Key_last = _Key_first + _Cursor.key().size();
+                const char * _Value_first = _Cursor.value_data();
+                const char * _Value_last = _Value_first + _Cursor.value_size();
+
+                if (!_Key_codec<_Ty_key>::decode(_Key_first, _Key_last, _Key) || _Key_first != _Key_last
+                    || !_Codec<_Ty_value>::decode(_Value_first, _Value_last, _Value) || _Value_first != _Value_last) {
+                    _Checkpoint_format::throw_corrupted();
+                }
+
+                _Callback(std::move(_Key), std::move(_Value), _Cursor.deadline());
+            }
+        }
+    }
+
+private:
+    /**
+     * @brief 读取并校验尾部和索引块
+     */
+    void _Read_index()
+    {
+        struct stat _Stat;
+        if (::fstat(_Fd, &_Stat) != 0) {
+            _Throw_system_error("checkpoint stat");
+        }
+
+        std::uint64_t _File_size = static_cast<std::uint64_t>(_Stat.st_size);
+        if (_File_size < _Checkpoint_format::FOOTER_SIZE + _Checkpoint_format::CHECKSUM_SIZE) {
+            _Checkpoint_format::throw_corrupted();
+        }
+
+        char _Footer_data[_Checkpoint_format::FOOTER_SIZE];
+        _Read_at(_Footer_data, sizeof(_Footer_data), _File_size - _Checkpoint_format::FOOTER_SIZE);
+        _Checkpoint_format::footer _Footer = _Checkpoint_format::decode_footer(_Footer_data, _File_size);
+
+        std::string _Buffer(static_cast<size_type>(_Footer._Index_size) + _Checkpoint_format::CHECKSUM_SIZE, '\0');
+        _Read_at(&_Buffer[0], _Buffer.size(), _Footer._Index_offset);
+
+        _Index = _Checkpoint_format::decode_index(_Buffer.data(), static_cast<size_type>(_Footer._Index_size),
+                                                  _Footer._Index_offset);
+        _Count = _Footer._Count;
+    }
+
+    /**
+     * @brief 从指定位置读取
+     * @param _Data 缓冲区
+     * @param _Size 字节数
+     * @param _Offset 文件偏移
+     */
+    void _Read_at(char * _Data, size_type _Size, std::uint64_t _Offset) const
+    {
+        while (_Size > 0) {
+            ssize_t _Read_size = ::pread(_Fd, _Data, _Size, static_cast<off_t>(_Offset));
+            if (_Read_size < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                _Throw_system_error("checkpoint read");
+            }
+
+            if (_Read_size == 0) {
+                _Checkpoint_format::throw_corrupted();
+            }
+
+            _Data += _Read_size;
+            _Size -= static_cast<size_type>(_Read_size);
+            _Offset += static_cast<std::uint64_t>(_Read_size);
+        }
+    }
+
+    /**
+     * @brief 根据errno抛出异常
+     * @param _What 描述
+     */
+    [[noreturn]] static void _Throw_system_error(const char * _What)
+    {
+        throw std::system_error(errno, std::generic_category(), _What);
+    }
+};
+
+} // namespace WW
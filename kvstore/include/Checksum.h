@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace WW
+{
+
+/**
+ * @brief 生成CRC32C（Castagnoli）查找表
+ * @return 查找表
+ */
+inline const std::uint32_t * _Crc32c_table() noexcept
+{
+    struct _Table
+    {
+        std::uint32_t _Entries[256];
+
+        _Table() noexcept
+        {
+            for (std::uint32_t _Index = 0; _Index < 256; ++_Index) {
+                std::uint32_t _Crc = _Index;
+                for (int _Bit = 0; _Bit < 8; ++_Bit) {
+                    _Crc = (_Crc >> 1) ^ (0x82F63B78u & (0u - (_Crc & 1u)));
+                }
+                _Entries[_Index] = _Crc;
+            }
+        }
+    };
+
+    static const _Table _Instance;
+    return _Instance._Entries;
+}
+
+/**
+ * @brief 计算CRC32C校验和
+ * @param _Data 数据
+ * @param _Size 字节数
+ * @param _Crc 之前的校验和，用于分段计算
+ * @return 校验和
+ */
+inline std::uint32_t _Crc32c(const void * _Data, std::size_t _Size, std::uint32_t _Crc = 0) noexcept
+{
+    const std::uint32_t * _Table = _Crc32c_table();
+    const unsigned char * _Bytes = static_cast<const unsigned char *>(_Data);
+
+    _Crc = ~_Crc;
+    for (std::size_t _Index = 0; _Index < _Size; ++_Index) {
+        _Crc = _Table[(_Crc ^ _Bytes[_Index]) & 0xFF] ^ (_Crc >> 8);
+    }
+
+    return ~_Crc;
+}
+
+} // namespace WW
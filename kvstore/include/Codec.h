@@ -0,0 +1,184 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+namespace WW
+{
+
+/**
+ * @brief 追加一个变长整数
+ * @param _Out 输出缓冲区
+ * @param _Value 整数
+ */
+inline void _Put_varint(std::string & _Out, std::uint64_t _Value)
+{
+    while (_Value >= 0x80) {
+        _Out.push_back(static_cast<char>(_Value | 0x80));
+        _Value >>= 7;
+    }
+
+    _Out.push_back(static_cast<char>(_Value));
+}
+
+/**
+ * @brief 读取一个变长整数
+ * @param _First 读取位置，成功后向后移动
+ * @param _Last 缓冲区末尾
+ * @param _Value 用于接收整数
+ * @return 是否读取成功
+ */
+inline bool _Get_varint(const char *& _First, const char * _Last, std::uint64_t & _Value) noexcept
+{
+    _Value = 0;
+
+    for (int _Shift = 0; _Shift < 64 && _First < _Last; _Shift += 7) {
+        std::uint64_t _Byte = static_cast<unsigned char>(*_First++);
+        _Value |= (_Byte & 0x7F) << _Shift;
+
+        if ((_Byte & 0x80) == 0) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief 键和值的序列化方式
+ * @details 默认支持可平凡复制的类型（按内存原样保存）和`std::string`，
+ * 其他类型需要特化该模板并提供同样的`encode`和`decode`
+ * @tparam _Ty 类型
+ */
+template <typename _Ty, typename = void>
+struct _Codec;
+
+template <typename _Ty>
+struct _Codec<_Ty, typename std::enable_if<std::is_trivially_copyable<_Ty>::value>::type>
+{
+    /**
+     * @brief 序列化
+     * @param _Out 输出缓冲区
+     * @param _Value 对象
+     */
+    static void encode(std::string & _Out, const _Ty & _Value)
+    {
+        _Out.append(reinterpret_cast<const char *>(&_Value), sizeof(_Ty));
+    }
+
+    /**
+     * @brief 反序列化
+     * @param _First 读取位置，成功后向后移动
+     * @param _Last 缓冲区末尾
+     * @param _Value 用于接收对象
+     * @return 是否成功
+     */
+    static bool decode(const char *& _First, const char * _Last, _Ty & _Value) noexcept
+    {
+        if (static_cast<std::size_t>(_Last - _First) < sizeof(_Ty)) {
+            return false;
+        }
+
+        std::memcpy(&_Value, _First, sizeof(_Ty));
+        _First += sizeof(_Ty);
+        return true;
+    }
+};
+
+template <>
+struct _Codec<std::string>
+{
+    static void encode(std::string & _Out, const std::string & _Value)
+    {
+        _Put_varint(_Out, _Value.size());
+        _Out.append(_Value);
+    }
+
+    static bool decode(const char *& _First, const char * _Last, std::string & _Value)
+    {
+        std::uint64_t _Size = 0;
+        if (!_Get_varint(_First, _Last, _Size) || static_cast<std::uint64_t>(_Last - _First) < _Size) {
+            return false;
+        }
+
+        _Value.assign(_First, static_cast<std::size_t>(_Size));
+        _First += _Size;
+        return true;
+    }
+};
+
+/**
+ * @brief 键的保序序列化方式
+ * @details 用于检查点中的键：序列化后的字节串按字典序比较与键的顺序一致，
+ * 相邻的键共享尽可能长的前缀。键的长度由外部记录，`decode`消耗全部输入。
+ * 整数按大端序保存，有符号整数翻转符号位；`std::string`只保存字节本身；
+ * 其他类型退回`_Codec`，仍然可以正确读写，只是前缀压缩的效果较差
+ * @tparam _Ty 类型
+ */
+template <typename _Ty, typename = void>
+struct _Key_codec
+{
+    static void encode(std::string & _Out, const _Ty & _Value)
+    {
+        _Codec<_Ty>::encode(_Out, _Value);
+    }
+
+    static bool decode(const char *& _First, const char * _Last, _Ty & _Value)
+    {
+        return _Codec<_Ty>::decode(_First, _Last, _Value);
+    }
+};
+
+template <typename _Ty>
+struct _Key_codec<_Ty, typename std::enable_if<std::is_integral<_Ty>::value>::type>
+{
+    using unsigned_type = typename std::make_unsigned<_Ty>::type;
+
+    static constexpr unsigned_type SIGN_BIT = std::is_signed<_Ty>::value
+        ? static_cast<unsigned_type>(static_cast<unsigned_type>(1) << (sizeof(_Ty) * 8 - 1)) : 0;
+
+    static void encode(std::string & _Out, const _Ty & _Value)
+    {
+        unsigned_type _Bits = static_cast<unsigned_type>(static_cast<unsigned_type>(_Value) ^ SIGN_BIT);
+
+        for (std::size_t _Index = sizeof(_Ty); _Index > 0; --_Index) {
+            _Out.push_back(static_cast<char>(static_cast<unsigned char>(_Bits >> ((_Index - 1) * 8))));
+        }
+    }
+
+    static bool decode(const char *& _First, const char * _Last, _Ty & _Value) noexcept
+    {
+        if (static_cast<std::size_t>(_Last - _First) != sizeof(_Ty)) {
+            return false;
+        }
+
+        unsigned_type _Bits = 0;
+        for (std::size_t _Index = 0; _Index < sizeof(_Ty); ++_Index) {
+            _Bits = static_cast<unsigned_type>((_Bits << 8) | static_cast<unsigned char>(*_First++));
+        }
+
+        _Value = static_cast<_Ty>(static_cast<unsigned_type>(_Bits ^ SIGN_BIT));
+        return true;
+    }
+};
+
+template <>
+struct _Key_codec<std::string>
+{
+    static void encode(std::string & _Out, const std::string & _Value)
+    {
+        _Out.append(_Value);
+    }
+
+    static bool decode(const char *& _First, const char * _Last, std::string & _Value)
+    {
+        _Value.assign(_First, _Last);
+        _First = _Last;
+        return true;
+    }
+};
+
+} // namespace WW
@@ -4,9 +4,41 @@ namespace WW
 {
 
 /**
- * @brief 跳表最大层级
- * @details 指的是跳表最多有多少层，范围为[0, MAX_LEVEL - 1]
+ * @brief 无锁跳表的默认最大层级
+ * @details 指的是跳表最多有多少层，范围为[0, MAX_LEVEL - 1]。
+ * `_Skiplist`默认以`MAX_LEVEL_LIMIT`为最大层级，实际使用的层级随元素数量增长
  */
 constexpr int MAX_LEVEL = 16;
 
+/**
+ * @brief 跳表最大层级的上限
+ * @details 构造跳表时指定的最大层级不能超过该值，查找前驱时的栈上数组按该值分配。
+ * 以1/2的概率晋升时足以容纳2^31个元素
+ */
+constexpr int MAX_LEVEL_LIMIT = 32;
+
+/**
+ * @brief 单线程引擎策略
+ * @details `KVStore`使用`_Skiplist`储存数据，不做任何同步
+ */
+struct single_thread_policy
+{
+};
+
+/**
+ * @brief 无锁引擎策略
+ * @details `KVStore`使用`_Concurrent_skiplist`储存数据，所有操作都可以并发调用
+ */
+struct lock_free_policy
+{
+};
+
+/**
+ * @brief 只读快照策略
+ * @details `KVStore`以内存映射的方式直接读取检查点文件，只支持查询
+ */
+struct mapped_snapshot_policy
+{
+};
+
 } // namespace WW
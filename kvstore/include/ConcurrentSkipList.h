@@ -0,0 +1,877 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+#include <Common.h>
+#include <Epoch.h>
+#include <Random.h>
+
+namespace WW
+{
+
+/**
+ * @brief 并发跳表节点
+ * @details 每一层的向前指针的最低位作为删除标记，标记后该层的指针不再改变。
+ * 值通过原子指针保存，更新时整体替换并延迟释放旧值。
+ * 与`_Skip_list_node`相同，向前数组以柔性数组的形式紧跟在节点之后
+ * @tparam _Key 键类型
+ * @tparam _Value 值类型
+ */
+template <
+    typename _Ty_key,
+    typename _Ty_value
+> class _Concurrent_skip_list_node
+{
+public:
+    using key_type = _Ty_key;
+    using value_type = _Ty_value;
+    using size_type = std::size_t;
+    using level_type = int;
+    using node_pointer = _Concurrent_skip_list_node<_Ty_key, _Ty_value> *;
+    using link_type = std::uintptr_t;
+
+private:
+    const key_type _Key;                        // 键
+    std::atomic<value_type *> _Value;           // 值
+    std::atomic<int> _Finished;                 // 插入和删除中已经结束的一方的个数，后结束的一方负责回收
+    level_type _Level;                          // 层级
+    std::atomic<link_type> _Forward[1];         // 向前数组，实际长度为_Level + 1
+
+public:
+    _Concurrent_skip_list_node(const key_type & _Key, value_type * _Value, level_type _Level)
+        : _Key(_Key)
+        , _Value(_Value)
+        , _Finished(0)
+        , _Level(_Level)
+    {
+        for (level_type _Index = 0; _Index <= _Level; ++_Index) {
+            ::new (static_cast<void *>(&_Forward[_Index])) std::atomic<link_type>(0);
+        }
+    }
+
+    _Concurrent_skip_list_node(const _Concurrent_skip_list_node &) = delete;
+
+    _Concurrent_skip_list_node & operator=(const _Concurrent_skip_list_node &) = delete;
+
+    ~_Concurrent_skip_list_node()
+    {
+        delete _Value.load(std::memory_order_relaxed);
+    }
+
+public:
+    /**
+     * @brief 创建节点
+     * @param _Key 键
+     * @param _Value 值，所有权转移给节点
+     * @param _Level 层级
+     * @return 节点指针
+     */
+    static node_pointer create(const key_type & _Key, value_type * _Value, level_type _Level)
+    {
+        size_type _Size = sizeof(_Concurrent_skip_list_node) + _Level * sizeof(std::atomic<link_type>);
+        void * _Memory = ::operator new(_Size);
+
+        try {
+            return ::new (_Memory) _Concurrent_skip_list_node(_Key, _Value, _Level);
+        } catch (...) {
+            ::operator delete(_Memory);
+            throw;
+        }
+    }
+
+    /**
+     * @brief 销毁节点
+     * @param _Node 节点指针
+     */
+    static void destroy(void * _Node) noexcept
+    {
+        static_cast<node_pointer>(_Node)->~_Concurrent_skip_list_node();
+        ::operator delete(_Node);
+    }
+
+    /**
+     * @brief 销毁值
+     * @param _Value 值指针
+     */
+    static void destroy_value(void * _Value) noexcept
+    {
+        delete static_cast<value_type *>(_Value);
+    }
+
+    /**
+     * @brief 组合指针和删除标记
+     */
+    static link_type make_link(node_pointer _Node, bool _Marked) noexcept
+    {
+        return reinterpret_cast<link_type>(_Node) | static_cast<link_type>(_Marked);
+    }
+
+    /**
+     * @brief 从链接中取出指针
+     */
+    static node_pointer link_pointer(link_type _Link) noexcept
+    {
+        return reinterpret_cast<node_pointer>(_Link & ~static_cast<link_type>(1));
+    }
+
+    /**
+     * @brief 从链接中取出删除标记
+     */
+    static bool link_marked(link_type _Link) noexcept
+    {
+        return (_Link & 1) != 0;
+    }
+
+    const key_type & key() const noexcept
+    {
+        return _Key;
+    }
+
+    std::atomic<value_type *> & value() noexcept
+    {
+        return _Value;
+    }
+
+    level_type level() const noexcept
+    {
+        return _Level;
+    }
+
+    std::atomic<link_type> & forward(level_type _Level) noexcept
+    {
+        return _Forward[_Level];
+    }
+
+    std::atomic<int> & finished() noexcept
+    {
+        return _Finished;
+    }
+};
+
+/**
+ * @brief 并发跳表常量迭代器
+ * @details 迭代器持有纪元守卫，因此迭代过程中经过的节点不会被释放，
+ * 迭代期间其他线程的插入和删除可能被看到也可能看不到，但不会重复访问同一个键，且顺序始终递增。
+ * 迭代器只能在创建它的线程中使用，长时间持有会推迟其他线程的内存回收
+ */
+template <
+    typename _Ty_key,
+    typename _Ty_value
+> class _Concurrent_skiplist_const_iterator
+{
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using key_type = _Ty_key;
+    using value_type = _Ty_value;
+    using reference = std::pair<const _Ty_key &, const _Ty_value &>;
+    using difference_type = std::ptrdiff_t;
+
+    using node_type = _Concurrent_skip_list_node<key_type, value_type>;
+    using node_pointer = node_type *;
+    using self = _Concurrent_skiplist_const_iterator<_Ty_key, _Ty_value>;
+
+    /**
+     * @brief `operator->`使用的代理
+     */
+    class pointer
+    {
+    private:
+        reference _Ref;
+
+    public:
+        explicit pointer(const reference & _Ref)
+            : _Ref(_Ref)
+        {
+        }
+
+        const reference * operator->() const noexcept
+        {
+            return &_Ref;
+        }
+    };
+
+protected:
+    _Epoch_guard _Guard;            // 纪元守卫
+    node_pointer _Node;             // 节点指针
+    value_type * _Value;            // 到达该节点时读到的值
+
+public:
+    _Concurrent_skiplist_const_iterator()
+        : _Guard()
+        , _Node(nullptr)
+        , _Value(nullptr)
+    { //空迭代器
+        _Guard.release();
+    }
+
+    explicit _Concurrent_skiplist_const_iterator(node_pointer _Node)
+        : _Guard()
+        , _Node(_Node)
+        , _Value(nullptr)
+    {
+        _Skip_removed();
+    }
+
+public:
+    reference operator*() const noexcept
+    {
+        return reference(_Node->key(), *_Value);
+    }
+
+    pointer operator->() const noexcept
+    {
+        return pointer(operator*());
+    }
+
+    self & operator++() noexcept
+    {
+        _Node = node_type::link_pointer(_Node->forward(0).load(std::memory_order_acquire));
+        _Skip_removed();
+        return *this;
+    }
+
+    self operator++(int) noexcept
+    {
+        self _Tmp = *this;
+        ++*this;
+        return _Tmp;
+    }
+
+    bool operator==(const self & _Other) const noexcept
+    {
+        return _Node == _Other._Node;
+    }
+
+    bool operator!=(const self & _Other) const noexcept
+    {
+        return !(*this == _Other);
+    }
+
+private:
+    /**
+     * @brief 跳过已经被逻辑删除的节点，并在到达末尾时提前离开纪元
+     */
+    void _Skip_removed() noexcept
+    {
+        while (_Node != nullptr) {
+            if (!node_type::link_marked(_Node->forward(0).load(std::memory_order_acquire))) {
+                _Value = _Node->value().load(std::memory_order_acquire);
+                return;
+            }
+
+            _Node = node_type::link_pointer(_Node->forward(0).load(std::memory_order_acquire));
+        }
+
+        _Value = nullptr;
+        _Guard.release();
+    }
+};
+
+/**
+ * @brief 无锁并发跳表
+ * @details 基于Fraser与Herlihy-Shavit的无锁跳表：各层通过CAS链接，删除时先自顶向下标记各层的向前指针，
+ * 第0层标记成功即为删除的线性化点，随后由查找过程协助物理摘除。
+ * 被摘除的节点和被替换的值通过`_Epoch_domain`延迟释放。
+ * 除构造和析构外，所有操作都可以被多个线程并发调用
+ * @tparam _Key 键类型
+ * @tparam _Value 值类型
+ * @tparam _Compare 比较器类型
+ */
+template <
+    typename _Ty_key,
+    typename _Ty_value,
+    typename _Ty_compare = std::less<_Ty_key>
+> class _Concurrent_skiplist
+{
+public:
+    using key_type = _Ty_key;
+    using value_type = _Ty_value;
+    using pair_type = std::pair<const _Ty_key, _Ty_value>;
+    using size_type = std::size_t;
+    using key_compare = _Ty_compare;
+    using const_iterator = _Concurrent_skiplist_const_iterator<key_type, value_type>;
+    using iterator = const_iterator;
+
+    using level_type = int;
+    using node_type = _Concurrent_skip_list_node<key_type, value_type>;
+    using node_pointer = node_type *;
+    using link_type = typename node_type::link_type;
+
+private:
+    key_compare _Comp;                          // 比较器
+    node_pointer _Head;                         // 头节点
+    level_type _Max_level_index;                // 最大层级索引
+    std::atomic<size_type> _Size;               // 节点个数
+
+public:
+    _Concurrent_skiplist()
+        : _Concurrent_skiplist(MAX_LEVEL)
+    {
+    }
+
+    explicit _Concurrent_skiplist(level_type _Max_level, const key_compare & _Compare = key_compare())
+        : _Comp(_Compare)
+        , _Head(nullptr)
+        , _Max_level_index(_Clamp_max_level(_Max_level) - 1)
+        , _Size(0)
+    {
+        _Head = node_type::create(key_type(), nullptr, _Max_level_index);
+    }
+
+    _Concurrent_skiplist(const _Concurrent_skiplist &) = delete;
+
+    _Concurrent_skiplist & operator=(const _Concurrent_skiplist &) = delete;
+
+    ~_Concurrent_skiplist()
+    {
+        // 析构时不允许并发访问，仍在链表中的节点直接释放，已摘除的节点由回收域释放
+        clear();
+
+        node_type::destroy(_Head);
+    }
+
+public:
+    /**
+     * @brief 获取比较器
+     * @return 比较器
+     */
+    key_compare key_comp() const
+    {
+        return _Comp;
+    }
+
+    // 迭代器
+
+    /**
+     * @brief 返回指向起始的迭代器
+     */
+    const_iterator begin() const
+    {
+        _Epoch_guard _Guard;
+        return const_iterator(node_type::link_pointer(_Head->forward(0).load(std::memory_order_acquire)));
+    }
+
+    /**
+     * @brief 返回指向起始的迭代器
+     */
+    const_iterator cbegin() const
+    {
+        return begin();
+    }
+
+    /**
+     * @brief 返回指向末尾的迭代器
+     */
+    const_iterator end() const noexcept
+    {
+        return const_iterator();
+    }
+
+    /**
+     * @brief 返回指向首个不小于给定键的元素的迭代器
+     * @param _Key 键
+     * @return 迭代器
+     */
+    const_iterator lower_bound(const key_type & _Key) const
+    {
+        _Epoch_guard _Guard;
+        return const_iterator(_Lower_bound_node(_Key));
+    }
+
+    /**
+     * @brief 返回指向末尾的迭代器
+     */
+    const_iterator cend() const noexcept
+    {
+        return end();
+    }
+
+    // 容量
+
+    /**
+     * @brief 获取跳表大小
+     * @details 并发修改时只是一个近似值
+     * @return 跳表大小
+     */
+    size_type size() const noexcept
+    {
+        return _Size.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 判断跳表是否为空
+     * @return 是否为空
+     */
+    bool empty() const noexcept
+    {
+        return size() == 0;
+    }
+
+    // 修改器
+
+    /**
+     * @brief 清空跳表
+     * @details 不能与其他操作并发调用，仍在链表中的节点直接释放
+     */
+    void clear() noexcept
+    {
+        node_pointer _Cur = node_type::link_pointer(_Head->forward(0).load(std::memory_order_acquire));
+
+        while (_Cur != nullptr) {
+            node_pointer _Next = node_type::link_pointer(_Cur->forward(0).load(std::memory_order_relaxed));
+            node_type::destroy(_Cur);
+            _Cur = _Next;
+        }
+
+        for (level_type _Level = 0; _Level <= _Max_level_index; ++_Level) {
+            _Head->forward(_Level).store(0, std::memory_order_relaxed);
+        }
+
+        _Size.store(0, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 当不存在键时，插入一个键值对
+     * @param _Key 键
+     * @param _Value 值
+     * @return 是否插入成功
+     */
+    bool insert(const key_type & _Key, const value_type & _Value)
+    {
+        _Epoch_guard _Guard;
+        return _Insert(_Key, _Value, false);
+    }
+
+    /**
+     * @brief 插入一个键值对，键已存在时替换值
+     * @param _Key 键
+     * @param _Value 值
+     * @return 是否为新插入
+     */
+    bool insert_or_assign(const key_type & _Key, const value_type & _Value)
+    {
+        _Epoch_guard _Guard;
+        return _Insert(_Key, _Value, true);
+    }
+
+    /**
+     * @brief 当键存在时替换值
+     * @param _Key 键
+     * @param _Value 值
+     * @return 是否替换成功
+     */
+    bool assign(const key_type & _Key, const value_type & _Value)
+    {
+        _Epoch_guard _Guard;
+
+        node_pointer _Node = _Find_node(_Key);
+        if (_Node == nullptr) {
+            return false;
+        }
+
+        _Replace_value(_Node, new value_type(_Value));
+        return true;
+    }
+
+    /**
+     * @brief 删除指定键的元素
+     * @param _Key 键
+     * @return 被删除的元素个数
+     */
+    size_type erase(const key_type & _Key)
+    {
+        _Epoch_guard _Guard;
+
+        node_pointer _Preds[MAX_LEVEL_LIMIT];
+        node_pointer _Succs[MAX_LEVEL_LIMIT];
+
+        if (!_Find(_Key, _Preds, _Succs)) {
+            return 0;
+        }
+
+        node_pointer _Victim = _Succs[0];
+
+        // 自顶向下标记除第0层以外的各层
+        for (level_type _Level = _Victim->level(); _Level > 0; --_Level) {
+            link_type _Link = _Victim->forward(_Level).load(std::memory_order_acquire);
+            while (!node_type::link_marked(_Link)) {
+                _Victim->forward(_Level).compare_exchange_weak(_Link, _Link | 1, std::memory_order_acq_rel);
+            }
+        }
+
+        // 标记第0层，成功的线程才是真正的删除者
+        link_type _Link = _Victim->forward(0).load(std::memory_order_acquire);
+        while (true) {
+            if (node_type::link_marked(_Link)) {
+                // 被其他线程抢先删除
+                return 0;
+            }
+
+            if (_Victim->forward(0).compare_exchange_weak(_Link, _Link | 1, std::memory_order_acq_rel)) {
+                break;
+            }
+        }
+
+        _Size.fetch_sub(1, std::memory_order_relaxed);
+
+        // 协助物理摘除
+        _Find(_Key, _Preds, _Succs);
+        _Finish(_Victim);
+
+        return 1;
+    }
+
+    // 查找
+
+    /**
+     * @brief 获取指定键的值
+     * @param _Key 键
+     * @param _Value 用于接收值
+     * @return 是否存在
+     */
+    bool get(const key_type & _Key, value_type & _Value) const
+    {
+        _Epoch_guard _Guard;
+
+        node_pointer _Node = _Find_node(_Key);
+        if (_Node == nullptr) {
+            return false;
+        }
+
+        _Value = *_Node->value().load(std::memory_order_acquire);
+        return true;
+    }
+
+    /**
+     * @brief 查询一个键是否存在
+     * @param _Key 键
+     * @return 是否存在
+     */
+    bool contains(const key_type & _Key) const
+    {
+        _Epoch_guard _Guard;
+        return _Find_node(_Key) != nullptr;
+    }
+
+    // 批量构建
+
+    /**
+     * @brief 有序构建器
+     * @details 与`_Skiplist::sorted_builder`相同，按键的严格升序直接链接到各层末尾，层级由序号确定。
+     * 构建器创建时会清空跳表，构建期间不能与其他操作并发，构建完成后才能交给其他线程使用
+     */
+    class sorted_builder
+    {
+    private:
+        _Concurrent_skiplist & _List;               // 目标跳表
+        node_pointer _Tail[MAX_LEVEL_LIMIT];        // 每一层的最后一个节点
+        size_type _Count;                           // 已追加的节点个数
+
+    public:
+        explicit sorted_builder(_Concurrent_skiplist & _List)
+            : _List(_List)
+            , _Count(0)
+        {
+            _List.clear();
+
+            for (level_type _Level = 0; _Level <= _List._Max_level_index; ++_Level) {
+                _Tail[_Level] = _List._Head;
+            }
+        }
+
+        sorted_builder(const sorted_builder &) = delete;
+
+        sorted_builder & operator=(const sorted_builder &) = delete;
+
+    public:
+        /**
+         * @brief 在末尾追加一个键值对
+         * @param _Key 键，必须大于之前追加的所有键
+         * @param _Value 值
+         */
+        void append(const key_type & _Key, const value_type & _Value)
+        {
+            if (_Count != 0 && !_List._Comp(_Tail[0]->key(), _Key)) {
+                throw std::invalid_argument("skiplist keys are not sorted");
+            }
+
+            size_type _Sequence = _Count + 1;
+            level_type _New_level_index = 0;
+            while ((_Sequence & 1) == 0 && _New_level_index < _List._Max_level_index) {
+                _Sequence >>= 1;
+                ++_New_level_index;
+            }
+
+            node_pointer _New_node = node_type::create(_Key, new value_type(_Value), _New_level_index);
+
+            // 不会再有插入方调用_Finish，预先记为插入已结束，之后的删除方负责回收
+            _New_node->finished().store(1, std::memory_order_relaxed);
+
+            for (level_type _Level = 0; _Level <= _New_level_index; ++_Level) {
+                _Tail[_Level]->forward(_Level).store(node_type::make_link(_New_node, false), std::memory_order_release);
+                _Tail[_Level] = _New_node;
+            }
+
+            _List._Size.fetch_add(1, std::memory_order_relaxed);
+            ++_Count;
+        }
+    };
+
+private:
+    /**
+     * @brief 将最大层级限制在[1, MAX_LEVEL_LIMIT]之间
+     * @param _Max_level 最大层级
+     * @return 限制后的最大层级
+     */
+    static level_type _Clamp_max_level(level_type _Max_level) noexcept
+    {
+        if (_Max_level < 1) {
+            return 1;
+        }
+
+        return _Max_level < MAX_LEVEL_LIMIT ? _Max_level : MAX_LEVEL_LIMIT;
+    }
+
+    /**
+     * @brief 随机生成一个层级索引
+     * @details 每个线程使用独立的随机数生成器，以1/2的概率逐层晋升，由一个随机数末尾0的个数得到。
+     * 上限与头节点的最高层相同，查找从这一层开始
+     * @return 层级索引
+     */
+    level_type _Random_level_index() const noexcept
+    {
+        level_type _Level = _Count_trailing_zeros(_Xorshift_random::local()() | (1ull << 63));
+        return _Level < _Max_level_index ? _Level : _Max_level_index;
+    }
+
+    /**
+     * @brief 查找键，并记录每一层的前驱和后继，途中摘除已经被标记的节点
+     * @param _Key 键
+     * @param _Preds 前驱数组
+     * @param _Succs 后继数组
+     * @return 是否找到未被删除的节点
+     */
+    bool _Find(const key_type & _Key, node_pointer * _Preds, node_pointer * _Succs) const
+    {
+    retry:
+        node_pointer _Pred = _Head;
+
+        for (level_type _Level = _Max_level_index; _Level >= 0; --_Level) {
+            node_pointer _Cur = node_type::link_pointer(_Pred->forward(_Level).load(std::memory_order_acquire));
+
+            while (_Cur != nullptr) {
+                link_type _Succ_link = _Cur->forward(_Level).load(std::memory_order_acquire);
+
+                // 当前节点在该层已被标记，尝试将它从该层摘除
+                while (node_type::link_marked(_Succ_link)) {
+                    link_type _Expected = node_type::make_link(_Cur, false);
+                    node_pointer _Succ = node_type::link_pointer(_Succ_link);
+                    if (!_Pred->forward(_Level).compare_exchange_strong(_Expected, node_type::make_link(_Succ, false),
+                                                                       std::memory_order_acq_rel)) {
+                        // 前驱发生了变化，重新开始
+                        goto retry;
+                    }
+
+                    _Cur = _Succ;
+                    if (_Cur == nullptr) {
+                        break;
+                    }
+
+                    _Succ_link = _Cur->forward(_Level).load(std::memory_order_acquire);
+                }
+
+                if (_Cur == nullptr || !_Comp(_Cur->key(), _Key)) {
+                    break;
+                }
+
+                _Pred = _Cur;
+                _Cur = node_type::link_pointer(_Succ_link);
+            }
+
+            _Preds[_Level] = _Pred;
+            _Succs[_Level] = _Cur;
+        }
+
+        return _Succs[0] != nullptr && !_Comp(_Key, _Succs[0]->key());
+    }
+
+    /**
+     * @brief 只读查找，不修改任何链接
+     * @param _Key 键
+     * @return 未被删除的节点指针，不存在时为空
+     */
+    node_pointer _Find_node(const key_type & _Key) const noexcept
+    {
+        node_pointer _Cur = _Lower_bound_node(_Key);
+
+        if (_Cur != nullptr && !_Comp(_Key, _Cur->key())) {
+            return _Cur;
+        }
+
+        return nullptr;
+    }
+
+    /**
+     * @brief 只读查找第一个不小于键的节点，不修改任何链接
+     * @param _Key 键
+     * @return 未被删除的节点指针，不存在时为空
+     */
+    node_pointer _Lower_bound_node(const key_type & _Key) const noexcept
+    {
+        node_pointer _Pred = _Head;
+        node_pointer _Cur = nullptr;
+
+        for (level_type _Level = _Max_level_index; _Level >= 0; --_Level) {
+            _Cur = node_type::link_pointer(_Pred->forward(_Level).load(std::memory_order_acquire));
+
+            while (_Cur != nullptr) {
+                link_type _Succ_link = _Cur->forward(_Level).load(std::memory_order_acquire);
+
+                // 跳过已标记的节点
+                if (node_type::link_marked(_Succ_link)) {
+                    _Cur = node_type::link_pointer(_Succ_link);
+                    continue;
+                }
+
+                if (!_Comp(_Cur->key(), _Key)) {
+                    break;
+                }
+
+                _Pred = _Cur;
+                _Cur = node_type::link_pointer(_Succ_link);
+            }
+        }
+
+        return _Cur;
+    }
+
+    /**
+     * @brief 插入键值对
+     * @param _Key 键
+     * @param _Value 值
+     * @param _Assign 键已存在时是否替换值
+     * @return 是否为新插入
+     */
+    bool _Insert(const key_type & _Key, const value_type & _Value, bool _Assign)
+    {
+        node_pointer _Preds[MAX_LEVEL_LIMIT];
+        node_pointer _Succs[MAX_LEVEL_LIMIT];
+        node_pointer _New_node = nullptr;
+
+        while (true) {
+            if (_Find(_Key, _Preds, _Succs)) {
+                if (_New_node != nullptr) {
+                    node_type::destroy(_New_node);
+                }
+
+                if (_Assign) {
+                    _Replace_value(_Succs[0], new value_type(_Value));
+                }
+
+                return false;
+            }
+
+            if (_New_node == nullptr) {
+                _New_node = node_type::create(_Key, new value_type(_Value), _Random_level_index());
+            }
+
+            // 新节点尚未发布，可以直接设置向前指针
+            for (level_type _Level = 0; _Level <= _New_node->level(); ++_Level) {
+                _New_node->forward(_Level).store(node_type::make_link(_Succs[_Level], false), std::memory_order_relaxed);
+            }
+
+            // 在第0层链接即为插入的线性化点
+            link_type _Expected = node_type::make_link(_Succs[0], false);
+            if (_Preds[0]->forward(0).compare_exchange_strong(_Expected, node_type::make_link(_New_node, false),
+                                                             std::memory_order_acq_rel)) {
+                break;
+            }
+        }
+
+        _Size.fetch_add(1, std::memory_order_relaxed);
+
+        // 逐层链接上层
+        for (level_type _Level = 1; _Level <= _New_node->level(); ++_Level) {
+            if (!_Link_level(_New_node, _Level, _Preds, _Succs)) {
+                break;
+            }
+        }
+
+        _Finish(_New_node);
+
+        return true;
+    }
+
+    /**
+     * @brief 在指定层级链接新节点
+     * @param _New_node 新节点
+     * @param _Level 层级
+     * @param _Preds 前驱数组
+     * @param _Succs 后继数组
+     * @return 是否链接成功，节点已被删除时返回false
+     */
+    bool _Link_level(node_pointer _New_node, level_type _Level, node_pointer * _Preds, node_pointer * _Succs)
+    {
+        while (true) {
+            // 确保新节点在该层指向正确的后继，节点已被标记时放弃
+            link_type _Link = _New_node->forward(_Level).load(std::memory_order_acquire);
+            if (node_type::link_marked(_Link)) {
+                return false;
+            }
+
+            link_type _Succ_link = node_type::make_link(_Succs[_Level], false);
+            if (_Link != _Succ_link
+                && !_New_node->forward(_Level).compare_exchange_strong(_Link, _Succ_link, std::memory_order_acq_rel)) {
+                continue;
+            }
+
+            link_type _Expected = _Succ_link;
+            if (_Preds[_Level]->forward(_Level).compare_exchange_strong(_Expected, node_type::make_link(_New_node, false),
+                                                                       std::memory_order_acq_rel)) {
+                return true;
+            }
+
+            // 前驱发生变化，重新查找，若新节点已经不在跳表中则放弃
+            if (!_Find(_New_node->key(), _Preds, _Succs) || _Succs[0] != _New_node) {
+                return false;
+            }
+        }
+    }
+
+    /**
+     * @brief 插入方链接完毕或删除方摘除完毕后调用，后结束的一方负责回收节点
+     * @param _Node 节点
+     */
+    void _Finish(node_pointer _Node)
+    {
+        if (_Node->finished().fetch_add(1, std::memory_order_acq_rel) != 1) {
+            return;
+        }
+
+        // 插入与删除都已结束，不会再有新的链接，再查找一次确保各层都已摘除
+        node_pointer _Preds[MAX_LEVEL_LIMIT];
+        node_pointer _Succs[MAX_LEVEL_LIMIT];
+        _Find(_Node->key(), _Preds, _Succs);
+
+        _Epoch_domain::instance().retire(_Node, &node_type::destroy);
+    }
+
+    /**
+     * @brief 替换节点的值并延迟释放旧值
+     * @param _Node 节点
+     * @param _Value 新值，所有权转移给节点
+     */
+    void _Replace_value(node_pointer _Node, value_type * _Value)
+    {
+        value_type * _Old = _Node->value().exchange(_Value, std::memory_order_acq_rel);
+        _Epoch_domain::instance().retire(_Old, &node_type::destroy_value);
+    }
+};
+
+} // namespace WW
@@ -0,0 +1,315 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace WW
+{
+
+/**
+ * @brief 基于纪元的内存回收域
+ * @details 线程在访问共享结构前进入纪元（`_Epoch_guard`），被摘除的对象通过`retire`延迟释放，
+ * 只有当全局纪元比对象被摘除后的纪元前进了两次之后，才能确定没有线程还持有它，此时才真正释放。
+ * 回收域是进程级的单例且永不析构，因此被延迟释放的对象必须能够独立释放，不能依赖其所属容器
+ */
+class _Epoch_domain
+{
+public:
+    using epoch_type = std::uint64_t;
+    using deleter_type = void (*)(void *);
+
+    static constexpr std::size_t RETIRE_THRESHOLD = 64;    // 每摘除多少个对象尝试推进一次纪元
+
+private:
+    /**
+     * @brief 待释放的对象
+     */
+    struct _Retired
+    {
+        void * _Ptr;
+        deleter_type _Deleter;
+    };
+
+    /**
+     * @brief 线程记录，独占一个缓存行，线程退出后可以被其他线程复用
+     */
+    struct alignas(64) _Record
+    {
+        std::atomic<epoch_type> _State;         // 最低位表示是否处于纪元中，其余位为进入时的纪元
+        std::atomic<bool> _In_use;              // 是否被某个线程占用
+        _Record * _Next;                        // 记录链表，插入后不再修改
+        std::size_t _Nesting;                   // 嵌套进入的次数
+        std::size_t _Retire_count;              // 距离上次尝试推进纪元摘除的对象个数
+        epoch_type _Limbo_epoch[3];             // 每个待释放列表对应的纪元
+        std::vector<_Retired> _Limbo[3];        // 按纪元分组的待释放列表
+
+        _Record()
+            : _State(0)
+            , _In_use(true)
+            , _Next(nullptr)
+            , _Nesting(0)
+            , _Retire_count(0)
+            , _Limbo_epoch()
+        {
+        }
+    };
+
+    /**
+     * @brief 线程退出时归还线程记录
+     */
+    struct _Thread_handle
+    {
+        _Record * _Rec = nullptr;
+
+        ~_Thread_handle()
+        {
+            if (_Rec != nullptr) {
+                _Rec->_In_use.store(false, std::memory_order_release);
+            }
+        }
+    };
+
+    std::atomic<epoch_type> _Global_epoch;      // 全局纪元
+    std::atomic<_Record *> _Records;            // 线程记录链表
+
+public:
+    _Epoch_domain() noexcept
+        : _Global_epoch(2)
+        , _Records(nullptr)
+    {
+    }
+
+    _Epoch_domain(const _Epoch_domain &) = delete;
+
+    _Epoch_domain & operator=(const _Epoch_domain &) = delete;
+
+public:
+    /**
+     * @brief 获取进程级的回收域
+     * @details 有意不析构，保证线程退出和静态析构阶段仍然可以安全访问
+     * @return 回收域
+     */
+    static _Epoch_domain & instance()
+    {
+        static _Epoch_domain * _Domain = new _Epoch_domain();
+        return *_Domain;
+    }
+
+    /**
+     * @brief 当前线程进入纪元，可以嵌套
+     */
+    void enter()
+    {
+        _Record * _Rec = _Local_record();
+
+        if (_Rec->_Nesting++ == 0) {
+            epoch_type _Epoch = _Global_epoch.load(std::memory_order_acquire);
+            // 必须在读取共享结构之前对其他线程可见
+            _Rec->_State.store(_Epoch | 1, std::memory_order_seq_cst);
+        }
+    }
+
+    /**
+     * @brief 当前线程离开纪元
+     */
+    void leave() noexcept
+    {
+        _Record * _Rec = _Local_record();
+
+        if (--_Rec->_Nesting == 0) {
+            _Rec->_State.store(0, std::memory_order_release);
+        }
+    }
+
+    /**
+     * @brief 延迟释放一个已经从共享结构中摘除的对象，调用者必须处于纪元中
+     * @param _Ptr 对象指针
+     * @param _Deleter 释放函数
+     */
+    void retire(void * _Ptr, deleter_type _Deleter)
+    {
+        _Record * _Rec = _Local_record();
+
+        // 以摘除之后的全局纪元作为标记：此时还可能持有该对象的线程，进入纪元时读到的全局纪元都不会超过它
+        epoch_type _Epoch = _Global_epoch.load(std::memory_order_seq_cst);
+        std::size_t _Index = (_Epoch >> 1) % 3;
+
+        // 该列表中是至少三个纪元之前的对象，已经可以释放
+        if (_Rec->_Limbo_epoch[_Index] != _Epoch) {
+            _Free_limbo(_Rec->_Limbo[_Index]);
+            _Rec->_Limbo_epoch[_Index] = _Epoch;
+        }
+
+        _Rec->_Limbo[_Index].push_back(_Retired{_Ptr, _Deleter});
+
+        if (++_Rec->_Retire_count >= RETIRE_THRESHOLD) {
+            _Rec->_Retire_count = 0;
+            _Try_advance();
+            _Collect(_Rec);
+        }
+    }
+
+    /**
+     * @brief 获取全局纪元
+     * @return 纪元
+     */
+    epoch_type epoch() const noexcept
+    {
+        return _Global_epoch.load(std::memory_order_acquire);
+    }
+
+private:
+    /**
+     * @brief 获取当前线程的记录，首次调用时分配或复用一个记录
+     * @return 线程记录
+     */
+    _Record * _Local_record()
+    {
+        static thread_local _Thread_handle _Handle;
+
+        if (_Handle._Rec == nullptr) {
+            _Handle._Rec = _Acquire_record();
+        }
+
+        return _Handle._Rec;
+    }
+
+    /**
+     * @brief 复用一个空闲的线程记录，没有空闲记录时创建新记录
+     * @return 线程记录
+     */
+    _Record * _Acquire_record()
+    {
+        for (_Record * _Rec = _Records.load(std::memory_order_acquire); _Rec != nullptr; _Rec = _Rec->_Next) {
+            bool _Expected = false;
+            if (!_Rec->_In_use.load(std::memory_order_relaxed)
+                && _Rec->_In_use.compare_exchange_strong(_Expected, true, std::memory_order_acquire)) {
+                return _Rec;
+            }
+        }
+
+        _Record * _Rec = new _Record();
+        _Record * _Head = _Records.load(std::memory_order_relaxed);
+        do {
+            _Rec->_Next = _Head;
+        } while (!_Records.compare_exchange_weak(_Head, _Rec, std::memory_order_release, std::memory_order_relaxed));
+
+        return _Rec;
+    }
+
+    /**
+     * @brief 当所有处于纪元中的线程都已经进入当前纪元时，推进全局纪元
+     */
+    void _Try_advance() noexcept
+    {
+        epoch_type _Epoch = _Global_epoch.load(std::memory_order_seq_cst);
+
+        for (_Record * _Rec = _Records.load(std::memory_order_acquire); _Rec != nullptr; _Rec = _Rec->_Next) {
+            epoch_type _State = _Rec->_State.load(std::memory_order_seq_cst);
+            if ((_State & 1) != 0 && (_State & ~static_cast<epoch_type>(1)) != _Epoch) {
+                // 还有线程停留在旧纪元
+                return;
+            }
+        }
+
+        _Global_epoch.compare_exchange_strong(_Epoch, _Epoch + 2, std::memory_order_acq_rel);
+    }
+
+    /**
+     * @brief 释放当前线程中已经安全的对象
+     * @param _Rec 线程记录
+     */
+    void _Collect(_Record * _Rec) noexcept
+    {
+        epoch_type _Epoch = _Global_epoch.load(std::memory_order_acquire);
+
+        for (std::size_t _Index = 0; _Index < 3; ++_Index) {
+            // 纪元每次前进2，落后两个纪元即可释放
+            if (_Rec->_Limbo_epoch[_Index] + 4 <= _Epoch) {
+                _Free_limbo(_Rec->_Limbo[_Index]);
+            }
+        }
+    }
+
+    /**
+     * @brief 释放一个待释放列表中的全部对象
+     * @param _Limbo 待释放列表
+     */
+    static void _Free_limbo(std::vector<_Retired> & _Limbo) noexcept
+    {
+        for (const _Retired & _Item : _Limbo) {
+            _Item._Deleter(_Item._Ptr);
+        }
+
+        _Limbo.clear();
+    }
+};
+
+/**
+ * @brief 纪元守卫
+ * @details 构造时进入纪元，析构时离开纪元，守卫只能在创建它的线程中使用和销毁
+ */
+class _Epoch_guard
+{
+private:
+    bool _Active;       // 是否持有纪元
+
+public:
+    _Epoch_guard()
+        : _Active(true)
+    {
+        _Epoch_domain::instance().enter();
+    }
+
+    _Epoch_guard(const _Epoch_guard & _Other)
+        : _Active(_Other._Active)
+    {
+        if (_Active) {
+            _Epoch_domain::instance().enter();
+        }
+    }
+
+    _Epoch_guard(_Epoch_guard && _Other) noexcept
+        : _Active(_Other._Active)
+    {
+        _Other._Active = false;
+    }
+
+    _Epoch_guard & operator=(const _Epoch_guard & _Other)
+    {
+        if (this != &_Other && _Active != _Other._Active) {
+            if (_Other._Active) {
+                _Epoch_domain::instance().enter();
+            } else {
+                _Epoch_domain::instance().leave();
+            }
+
+            _Active = _Other._Active;
+        }
+
+        return *this;
+    }
+
+    ~_Epoch_guard()
+    {
+        if (_Active) {
+            _Epoch_domain::instance().leave();
+        }
+    }
+
+public:
+    /**
+     * @brief 提前离开纪元
+     */
+    void release() noexcept
+    {
+        if (_Active) {
+            _Epoch_domain::instance().leave();
+            _Active = false;
+        }
+    }
+};
+
+} // namespace WW
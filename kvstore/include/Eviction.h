@@ -0,0 +1,167 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include <Random.h>
+
+namespace WW
+{
+
+/**
+ * @brief 淘汰策略
+ */
+enum class eviction_policy
+{
+    lru,            // 近似最近最少使用，淘汰采样中最久没有访问的键
+    lfu             // 近似最不经常使用，淘汰采样中衰减后访问频率最低的键
+};
+
+/**
+ * @brief 计算对象在堆上额外持有的内存
+ * @details 默认认为对象不持有堆内存，需要精确统计时可以为自定义类型特化
+ * @tparam _Ty 类型
+ */
+template <typename _Ty>
+struct _Heap_size
+{
+    static std::size_t of(const _Ty &) noexcept
+    {
+        return 0;
+    }
+};
+
+/**
+ * @brief `std::string`在堆上持有的内存，短字符串存放在对象内部时为0
+ */
+template <>
+struct _Heap_size<std::string>
+{
+    static std::size_t of(const std::string & _Str) noexcept
+    {
+        const char * _Data = _Str.data();
+        const char * _Self = reinterpret_cast<const char *>(&_Str);
+
+        if (_Data >= _Self && _Data < _Self + sizeof(std::string)) {
+            return 0;
+        }
+
+        return _Str.capacity() + 1;
+    }
+};
+
+/**
+ * @brief 访问记录器
+ * @details 把访问信息编码为跳表节点中的32位访问标记，时间以逻辑时钟计量，每次访问前进1。
+ * LRU模式下标记为最近一次访问时的时钟；LFU模式下与Redis相同，低8位为对数计数器，
+ * 高24位为最近一次衰减的周期，计数器每经过一个周期减1
+ */
+class _Access_tracker
+{
+public:
+    static constexpr std::uint32_t LFU_INIT_COUNT = 5;          // 新键的初始计数，避免刚插入就被淘汰
+    static constexpr std::uint32_t LFU_LOG_FACTOR = 10;         // 计数器增长的对数因子
+    static constexpr unsigned LFU_DECAY_SHIFT = 16;             // 衰减周期为2^16次访问
+
+private:
+    eviction_policy _Policy;        // 淘汰策略
+    std::uint32_t _Clock;           // 逻辑时钟
+
+public:
+    explicit _Access_tracker(eviction_policy _Policy = eviction_policy::lru) noexcept
+        : _Policy(_Policy)
+        , _Clock(0)
+    {
+    }
+
+public:
+    /**
+     * @brief 获取淘汰策略
+     * @return 淘汰策略
+     */
+    eviction_policy policy() const noexcept
+    {
+        return _Policy;
+    }
+
+    /**
+     * @brief 生成新键的访问标记
+     * @return 访问标记
+     */
+    std::uint32_t initial() noexcept
+    {
+        ++_Clock;
+
+        if (_Policy == eviction_policy::lru) {
+            return _Clock;
+        }
+
+        return (_Period() << 8) | LFU_INIT_COUNT;
+    }
+
+    /**
+     * @brief 记录一次访问
+     * @param _Mark 访问标记
+     */
+    void touch(std::uint32_t & _Mark) noexcept
+    {
+        ++_Clock;
+
+        if (_Policy == eviction_policy::lru) {
+            _Mark = _Clock;
+            return;
+        }
+
+        std::uint32_t _Count = _Decayed_count(_Mark);
+
+        // 计数越大增长越慢，255次访问之后约为百万次量级
+        if (_Count < 255) {
+            std::uint64_t _Base = _Count > LFU_INIT_COUNT ? _Count - LFU_INIT_COUNT : 0;
+            if (_Xorshift_random::local()() % (_Base * LFU_LOG_FACTOR + 1) == 0) {
+                ++_Count;
+            }
+        }
+
+        _Mark = (_Period() << 8) | _Count;
+    }
+
+    /**
+     * @brief 计算淘汰优先级
+     * @param _Mark 访问标记
+     * @return 优先级，越大越应该被淘汰
+     */
+    std::uint32_t score(std::uint32_t _Mark) const noexcept
+    {
+        if (_Policy == eviction_policy::lru) {
+            // 无符号减法，时钟回绕后仍然正确
+            return _Clock - _Mark;
+        }
+
+        return 255 - _Decayed_count(_Mark);
+    }
+
+private:
+    /**
+     * @brief 当前的衰减周期，只保留24位
+     * @return 周期
+     */
+    std::uint32_t _Period() const noexcept
+    {
+        return (_Clock >> LFU_DECAY_SHIFT) & 0xFFFFFF;
+    }
+
+    /**
+     * @brief 计算衰减后的计数
+     * @param _Mark 访问标记
+     * @return 计数
+     */
+    std::uint32_t _Decayed_count(std::uint32_t _Mark) const noexcept
+    {
+        std::uint32_t _Count = _Mark & 0xFF;
+        std::uint32_t _Elapsed = (_Period() - (_Mark >> 8)) & 0xFFFFFF;
+        return _Elapsed >= _Count ? 0 : _Count - _Elapsed;
+    }
+};
+
+} // namespace WW
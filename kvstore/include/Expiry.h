@@ -0,0 +1,234 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <set>
+#include <utility>
+
+namespace WW
+{
+
+/**
+ * @brief 获取系统时钟的当前时间
+ * @return 自纪元起的纳秒数
+ */
+inline std::uint64_t _Wall_now() noexcept
+{
+    auto _Since_epoch = std::chrono::system_clock::now().time_since_epoch();
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(_Since_epoch).count());
+}
+
+/**
+ * @brief 将过期时间换算为系统时钟的时间
+ * @details `steady_clock`的时间在进程重启后没有意义，日志和检查点中保存系统时钟的时间
+ * @param _Deadline 过期时间
+ * @return 自纪元起的纳秒数，至少为1，0留给“没有过期时间”
+ */
+inline std::uint64_t _To_wall_deadline(std::chrono::steady_clock::time_point _Deadline) noexcept
+{
+    auto _Left = std::chrono::duration_cast<std::chrono::nanoseconds>(_Deadline - std::chrono::steady_clock::now()).count();
+    std::int64_t _Wall = static_cast<std::int64_t>(_Wall_now()) + _Left;
+    return _Wall < 1 ? 1 : static_cast<std::uint64_t>(_Wall);
+}
+
+/**
+ * @brief 将系统时钟的时间换算为过期时间
+ * @param _Wall_deadline 自纪元起的纳秒数
+ * @return 过期时间
+ */
+inline std::chrono::steady_clock::time_point _From_wall_deadline(std::uint64_t _Wall_deadline) noexcept
+{
+    std::int64_t _Left = static_cast<std::int64_t>(_Wall_deadline) - static_cast<std::int64_t>(_Wall_now());
+    return std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::nanoseconds(_Left));
+}
+
+/**
+ * @brief 过期时间索引
+ * @details 记录设置了过期时间的键，与跳表节点分开存放，没有过期时间的键不占用任何额外内存。
+ * 按键索引的有序表用于查询某个键的过期时间，按过期时间排序的队列保存指向有序表中键的指针，
+ * 用于按时间顺序取出已经过期的键，键本身只保存一份
+ * @tparam _Key 键类型
+ * @tparam _Compare 比较器类型
+ */
+template <
+    typename _Ty_key,
+    typename _Ty_compare = std::less<_Ty_key>
+> class _Expiry_index
+{
+public:
+    using key_type = _Ty_key;
+    using key_compare = _Ty_compare;
+    using size_type = std::size_t;
+    using clock_type = std::chrono::steady_clock;
+    using time_point = clock_type::time_point;
+
+private:
+    using _Queue_entry = std::pair<time_point, const key_type *>;
+
+    /**
+     * @brief 队列的比较器，先比较过期时间，再比较键
+     */
+    struct _Queue_less
+    {
+        key_compare _Comp;
+
+        bool operator()(const _Queue_entry & _Left, const _Queue_entry & _Right) const
+        {
+            if (_Left.first != _Right.first) {
+                return _Left.first < _Right.first;
+            }
+
+            return _Comp(*_Left.second, *_Right.second);
+        }
+    };
+
+    std::map<key_type, time_point, key_compare> _Deadlines;     // 键到过期时间
+    std::set<_Queue_entry, _Queue_less> _Queue;                 // 按过期时间排序
+
+public:
+    explicit _Expiry_index(const key_compare & _Compare = key_compare())
+        : _Deadlines(_Compare)
+        , _Queue(_Queue_less{_Compare})
+    {
+    }
+
+    _Expiry_index(const _Expiry_index &) = delete;
+
+    _Expiry_index & operator=(const _Expiry_index &) = delete;
+
+public:
+    /**
+     * @brief 判断是否没有任何键设置了过期时间
+     * @return 是否为空
+     */
+    bool empty() const noexcept
+    {
+        return _Deadlines.empty();
+    }
+
+    /**
+     * @brief 获取设置了过期时间的键的个数
+     * @return 个数
+     */
+    size_type size() const noexcept
+    {
+        return _Deadlines.size();
+    }
+
+    /**
+     * @brief 设置键的过期时间，已经设置过时替换
+     * @param _Key 键
+     * @param _Deadline 过期时间
+     */
+    void set(const key_type & _Key, time_point _Deadline)
+    {
+        auto _It = _Deadlines.lower_bound(_Key);
+
+        if (_It != _Deadlines.end() && !_Deadlines.key_comp()(_Key, _It->first)) {
+            _Queue.erase(_Queue_entry(_It->second, &_It->first));
+            _It->second = _Deadline;
+        } else {
+            _It = _Deadlines.emplace_hint(_It, _Key, _Deadline);
+        }
+
+        _Queue.insert(_Queue_entry(_Deadline, &_It->first));
+    }
+
+    /**
+     * @brief 清除键的过期时间
+     * @param _Key 键
+     * @return 是否设置过过期时间
+     */
+    bool clear(const key_type & _Key)
+    {
+        auto _It = _Deadlines.find(_Key);
+        if (_It == _Deadlines.end()) {
+            return false;
+        }
+
+        _Queue.erase(_Queue_entry(_It->second, &_It->first));
+        _Deadlines.erase(_It);
+        return true;
+    }
+
+    /**
+     * @brief 获取键的过期时间
+     * @param _Key 键，支持异构查找时可以是与键可比较的值
+     * @return 过期时间，没有设置时为空
+     */
+    template <typename _Kty>
+    const time_point * find(const _Kty & _Key) const
+    {
+        auto _It = _Deadlines.find(_Key);
+        return _It == _Deadlines.end() ? nullptr : &_It->second;
+    }
+
+    /**
+     * @brief 判断键是否已经过期
+     * @param _Key 键
+     * @param _Now 当前时间
+     * @return 是否已经过期，没有设置过期时间时为false
+     */
+    template <typename _Kty>
+    bool expired(const _Kty & _Key, time_point _Now) const
+    {
+        const time_point * _Deadline = find(_Key);
+        return _Deadline != nullptr && !(_Now < *_Deadline);
+    }
+
+    /**
+     * @brief 按过期时间顺序访问已经过期的键，不取出
+     * @param _Now 当前时间
+     * @param _Callback 回调，参数为键，返回false时停止
+     */
+    template <typename _Fn>
+    void for_each_expired(time_point _Now, _Fn _Callback) const
+    {
+        for (auto _It = _Queue.begin(); _It != _Queue.end() && !(_Now < _It->first); ++_It) {
+            if (!_Callback(*_It->second)) {
+                return;
+            }
+        }
+    }
+
+    /**
+     * @brief 按过期时间顺序取出已经过期的键
+     * @details 回调在键从索引中移除之前调用
+     * @param _Now 当前时间
+     * @param _Limit 最多取出的个数
+     * @param _Callback 回调，参数为键
+     * @return 取出的个数
+     */
+    template <typename _Fn>
+    size_type pop_expired(time_point _Now, size_type _Limit, _Fn _Callback)
+    {
+        size_type _Count = 0;
+
+        while (_Count < _Limit && !_Queue.empty() && !(_Now < _Queue.begin()->first)) {
+            const key_type & _Key = *_Queue.begin()->second;
+            _Callback(_Key);
+
+            // 键属于有序表中的节点，先取得迭代器再删除
+            auto _It = _Deadlines.find(_Key);
+            _Queue.erase(_Queue.begin());
+            _Deadlines.erase(_It);
+            ++_Count;
+        }
+
+        return _Count;
+    }
+
+    /**
+     * @brief 清空索引
+     */
+    void reset() noexcept
+    {
+        _Queue.clear();
+        _Deadlines.clear();
+    }
+};
+
+} // namespace WW
@@ -1,18 +1,65 @@
 #pragma once
 
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
 #include <SkipList.h>
+#include <ConcurrentSkipList.h>
+#include <Eviction.h>
+#include <Expiry.h>
+#include <WriteAheadLog.h>
+#include <Checkpoint.h>
+#include <MappedSnapshot.h>
+#include <Stats.h>
 
 namespace WW
 {
 
+/**
+ * @brief 计算前缀的后继，即大于所有以该前缀开头的字符串的最小字符串
+ * @details 按无符号字节的字典序计算，与`std::string`的默认顺序一致
+ * @param _Prefix 前缀，成功时被替换为后继
+ * @return 是否存在后继，前缀为空或全部由0xFF组成时不存在
+ */
+inline bool _Prefix_successor(std::string & _Prefix)
+{
+    while (!_Prefix.empty() && static_cast<unsigned char>(_Prefix.back()) == 0xFF) {
+        _Prefix.pop_back();
+    }
+
+    if (_Prefix.empty()) {
+        return false;
+    }
+
+    _Prefix.back() = static_cast<char>(static_cast<unsigned char>(_Prefix.back()) + 1);
+    return true;
+}
+
 /**
  * @brief KV储存
+ * @details 键可以设置过期时间，过期的键对查找和遍历不可见，由写操作顺带或`sweep`逐步清理。
+ * `size`、`rank`、`select`和`count_range`会计入已过期但尚未清理的键。
+ * 设置内存预算后，写操作使占用超出预算时按淘汰策略删除键，此时查找会更新访问标记
  * @tparam _Key 键类型
  * @tparam _Value 值类型
+ * @tparam _Compare 比较器类型
+ * @tparam _Alloc 分配器类型
+ * @tparam _Policy 引擎策略，`single_thread_policy`、`lock_free_policy`或`mapped_snapshot_policy`
  */
 template <
     typename _Ty_key,
-    typename _Ty_value
+    typename _Ty_value,
+    typename _Ty_compare = std::less<_Ty_key>,
+    typename _Ty_alloc = std::allocator<std::pair<const _Ty_key, _Ty_value>>,
+    typename _Ty_policy = single_thread_policy
 > class KVStore
 {
 public:
@@ -21,9 +68,27 @@ public:
     using pair_type = std::pair<const _Ty_key, _Ty_value>;
     using size_type = std::size_t;
     using level_type = int;
+    using key_compare = _Ty_compare;
+    using allocator_type = _Ty_alloc;
+    using clock_type = std::chrono::steady_clock;
+    using duration = clock_type::duration;
+
+    static constexpr size_type EXPIRE_STEP = 16;    // 每次写操作顺带清理的过期键的最大个数
+    static constexpr size_type EVICTION_SAMPLES = 5; // 每次淘汰采样的键的个数
+    static constexpr size_type EVICTION_BATCH = 64;  // 每轮淘汰的键的最大个数
 
 protected:
-    _Skiplist<key_type, value_type> _Skiplist;      // 跳表
+    using skiplist_type = WW::_Skiplist<key_type, value_type, key_compare, allocator_type>;
+    using expiry_type = _Expiry_index<key_type, key_compare>;
+
+    skiplist_type _Skiplist;                                            // 跳表
+    expiry_type _Expiry;                                                // 过期时间索引
+    std::unique_ptr<_Write_ahead_log> _Wal;                             // 预写日志，未开启时为空
+    mutable _Access_tracker _Tracker;                                   // 访问记录器
+    size_type _Memory_limit = 0;                                        // 内存预算，为0时不限制
+    size_type _Memory_used = 0;                                         // 已使用的内存，只在设置了预算时统计
+    size_type _Evictions = 0;                                           // 淘汰的键的个数
+    _Stats_recorder _Recorder;                                          // 操作统计，未定义`WW_KVSTORE_STATS`时为空
 
 public:
     KVStore() = default;
@@ -33,17 +98,190 @@ public:
     {
     }
 
+    explicit KVStore(const allocator_type & _Allocator)
+        : _Skiplist(_Allocator)
+    {
+    }
+
+    explicit KVStore(const key_compare & _Compare, const allocator_type & _Allocator = allocator_type())
+        : _Skiplist(_Compare, _Allocator)
+        , _Expiry(_Compare)
+    {
+    }
+
+    KVStore(level_type _Max_level, const allocator_type & _Allocator)
+        : _Skiplist(_Max_level, _Allocator)
+    {
+    }
+
     ~KVStore() = default;
 
 public:
+    /**
+     * @brief 开启预写日志
+     * @details 先重放已有的日志，之后的写操作先把记录写入日志再修改，
+     * 写入日志失败时抛出`std::system_error`，修改不会生效。过期时间按系统时钟记录，重启后仍然有效
+     * @param _Options 日志选项
+     * @return 重放的记录个数
+     */
+    std::size_t open(const wal_options & _Options)
+    {
+        std::unique_ptr<_Write_ahead_log> _Log(new _Write_ahead_log(_Options));
+
+        std::size_t _Count = _Log->open([this](_Write_ahead_log::record_type _Type, const char * _First, const char * _Last) {
+            return _Write_ahead_log::decode<key_type, value_type>(_Type, _First, _Last,
+                [this](const key_type & _Key, const value_type & _Value) {
+                    _Skiplist[_Key] = _Value;
+                    _Expiry.clear(_Key);
+                },
+                [this](const key_type & _Key, const value_type & _Value) { _Skiplist.try_emplace(_Key, _Value); },
+                [this](const key_type & _Key) {
+                    _Skiplist.erase(_Key);
+                    _Expiry.clear(_Key);
+                },
+                [this](const key_type & _Key, std::uint64_t _Wall_deadline) {
+                    if (_Wall_deadline == 0) {
+                        _Expiry.clear(_Key);
+                    } else if (_Skiplist.contains(_Key)) {
+                        _Expiry.set(_Key, _From_wall_deadline(_Wall_deadline));
+                    }
+                });
+        });
+
+        _Wal = std::move(_Log);
+        _Recount_memory();
+        _Evict_if_needed();
+        return _Count;
+    }
+
+    /**
+     * @brief 关闭预写日志
+     */
+    void close() noexcept
+    {
+        _Wal.reset();
+    }
+
+    /**
+     * @brief 将当前内容写入检查点文件
+     * @details 按键的升序写出到临时文件，刷盘后原子地替换目标文件，过期时间按系统时钟一并写出。
+     * 开启了预写日志时，检查点完成后清空日志，重启时先`load`检查点再`open`日志即可恢复
+     * @param _Path 文件路径
+     * @return 写出的键值对个数
+     */
+    size_type checkpoint(const std::string & _Path)
+    {
+        _Checkpoint_writer _Writer(_Path);
+        auto _Now = clock_type::now();
+
+        for (const pair_type & _Pair : _Skiplist) {
+            const auto * _Deadline = _Expiry.empty() ? nullptr : _Expiry.find(_Pair.first);
+            if (_Deadline == nullptr) {
+                _Writer.add(_Pair.first, _Pair.second);
+            } else if (_Now < *_Deadline) {
+                _Writer.add(_Pair.first, _Pair.second, _To_wall_deadline(*_Deadline));
+            }
+        }
+
+        size_type _Count = _Writer.finish();
+
+        if (_Wal) {
+            _Wal->reset();
+        }
+
+        return _Count;
+    }
+
+    /**
+     * @brief 从检查点文件加载，替换当前的全部内容
+     * @details 文件中的键已经有序，跳表自底向上按顺序构建，不需要逐个查找插入位置。
+     * 已经过期的键不加载。不会写入预写日志，应当在`open`之前调用。文件损坏时抛出异常，已加载的部分保留
+     * @param _Path 文件路径
+     * @return 加载的键值对个数
+     */
+    size_type load(const std::string & _Path)
+    {
+        _Checkpoint_reader _Reader(_Path);
+        typename skiplist_type::sorted_builder _Builder(_Skiplist);
+        _Expiry.reset();
+        std::uint64_t _Now = _Wall_now();
+
+        _Reader.for_each<key_type, value_type>([&](key_type && _Key, value_type && _Value, std::uint64_t _Wall_deadline) {
+            if (_Wall_deadline == 0) {
+                _Builder.append(pair_type(std::move(_Key), std::move(_Value)));
+            } else if (_Now < _Wall_deadline) {
+                _Expiry.set(_Key, _From_wall_deadline(_Wall_deadline));
+                _Builder.append(pair_type(std::move(_Key), std::move(_Value)));
+            }
+        });
+
+        _Recount_memory();
+        _Evict_if_needed();
+        return _Skiplist.size();
+    }
+
     /**
      * @brief 获取值
+     * @details 不修改储存，不存在的键不会被插入
+     * @param _Key 键
+     * @return 值，不存在时为空
+     */
+    std::optional<value_type> get(const key_type & _Key) const
+    {
+        auto _Record = _Recorder.begin(_Stats_op::get);
+
+        auto _It = _Skiplist.find(_Key);
+        if (_It == _Skiplist.end() || _Is_expired(_Key)) {
+            _Record.hit(false);
+            return std::nullopt;
+        }
+
+        _Record.hit(true);
+        _Touch(_It);
+        return _It->second;
+    }
+
+    /**
+     * @brief 获取值，不存在时返回给定的默认值
      * @param _Key 键
+     * @param _Default 默认值
      * @return 值
      */
-    const value_type & get(const key_type & _Key) noexcept
+    value_type get_or_default(const key_type & _Key, const value_type & _Default = value_type()) const
+    {
+        auto _Record = _Recorder.begin(_Stats_op::get);
+
+        auto _It = _Skiplist.find(_Key);
+        if (_It == _Skiplist.end() || _Is_expired(_Key)) {
+            _Record.hit(false);
+            return _Default;
+        }
+
+        _Record.hit(true);
+        _Touch(_It);
+        return _It->second;
+    }
+
+    /**
+     * @brief 获取值并赋值给已有对象，可以复用对象已经持有的内存
+     * @param _Key 键
+     * @param _Value 用于接收值，不存在时不修改
+     * @return 是否存在
+     */
+    bool get_into(const key_type & _Key, value_type & _Value) const
     {
-        return _Skiplist[_Key];
+        auto _Record = _Recorder.begin(_Stats_op::get);
+
+        auto _It = _Skiplist.find(_Key);
+        if (_It == _Skiplist.end() || _Is_expired(_Key)) {
+            _Record.hit(false);
+            return false;
+        }
+
+        _Record.hit(true);
+        _Touch(_It);
+        _Value = _It->second;
+        return true;
     }
 
     /**
@@ -52,22 +290,91 @@ public:
      * @param _Value 值
      * @return 是否插入成功
      */
-    bool put(const key_type & _Key, const value_type & _Value) noexcept
+    bool put(const key_type & _Key, const value_type & _Value)
+    {
+        return _Put(_Key, _Value);
+    }
+
+    /**
+     * @brief 插入键值对，插入成功时移动值
+     * @param _Key 键
+     * @param _Value 值
+     * @return 是否插入成功
+     */
+    bool put(const key_type & _Key, value_type && _Value)
+    {
+        return _Put(_Key, std::move(_Value));
+    }
+
+    /**
+     * @brief 插入键值对，插入成功时移动键和值
+     * @param _Key 键
+     * @param _Value 值
+     * @return 是否插入成功
+     */
+    bool put(key_type && _Key, value_type && _Value)
+    {
+        return _Put(std::move(_Key), std::move(_Value));
+    }
+
+    /**
+     * @brief 插入键值对，并设置存活时间
+     * @param _Key 键
+     * @param _Value 值
+     * @param _Ttl 存活时间，不大于0时键插入后立即过期
+     * @return 是否插入成功，键已存在时不修改值和过期时间，插入后被立即淘汰时返回false
+     */
+    bool put(const key_type & _Key, const value_type & _Value, duration _Ttl)
+    {
+        auto _Deadline = clock_type::now() + _Ttl;
+        return _Put(_Key, _Value, &_Deadline);
+    }
+
+    /**
+     * @brief 插入键值对并设置存活时间，插入成功时移动值
+     * @param _Key 键
+     * @param _Value 值
+     * @param _Ttl 存活时间，不大于0时键插入后立即过期
+     * @return 是否插入成功，键已存在时不修改值和过期时间，插入后被立即淘汰时返回false
+     */
+    bool put(const key_type & _Key, value_type && _Value, duration _Ttl)
     {
-        auto pair = _Skiplist.insert(pair_type(_Key, _Value));
-        return pair.second;
+        auto _Deadline = clock_type::now() + _Ttl;
+        return _Put(_Key, std::move(_Value), &_Deadline);
     }
 
     /**
      * @brief 更新键值对
+     * @details 与插入不同，更新会清除键原有的过期时间
      * @param _Key 键
      * @param _Value 值
      * @return 是否更新成功
      */
-    bool update(const key_type & _Key, const value_type & _Value) noexcept
+    bool update(const key_type & _Key, const value_type & _Value)
     {
-        _Skiplist[_Key] = _Value;
-        return true;
+        return _Update(_Key, _Value);
+    }
+
+    /**
+     * @brief 更新键值对，移动值
+     * @param _Key 键
+     * @param _Value 值
+     * @return 是否更新成功
+     */
+    bool update(const key_type & _Key, value_type && _Value)
+    {
+        return _Update(_Key, std::move(_Value));
+    }
+
+    /**
+     * @brief 更新键值对，移动值，插入时移动键
+     * @param _Key 键
+     * @param _Value 值
+     * @return 是否更新成功
+     */
+    bool update(key_type && _Key, value_type && _Value)
+    {
+        return _Update(std::move(_Key), std::move(_Value));
     }
 
     /**
@@ -75,10 +382,29 @@ public:
      * @param _Key 键
      * @return 是否删除成功
      */
-    bool remove(const key_type & _Key) noexcept
+    bool remove(const key_type & _Key)
     {
-        auto count = _Skiplist.erase(_Key);
-        return count != 0;
+        auto _Record = _Recorder.begin(_Stats_op::remove);
+        _Sweep_step();
+
+        auto _Apply = [&] {
+            // 已过期的键同样删除，但视为不存在
+            bool _Live = !_Is_expired(_Key);
+            if (!_Expiry.empty()) {
+                _Expiry.clear(_Key);
+            }
+
+            _Release(_Key);
+            auto count = _Skiplist.erase(_Key);
+            return count != 0 && _Live;
+        };
+
+        // 键不存在时没有修改，不写入日志
+        if (_Wal && _Skiplist.contains(_Key)) {
+            return _Wal->append(_Write_ahead_log::encode_erase(_Key), _Apply);
+        }
+
+        return _Apply();
     }
 
     /**
@@ -88,7 +414,256 @@ public:
      */
     bool contains(const key_type & _Key) const noexcept
     {
-        return _Skiplist.contains(_Key);
+        return _Skiplist.contains(_Key) && !_Is_expired(_Key);
+    }
+
+    /**
+     * @brief 查询与给定值相等的键是否存在，要求比较器支持异构查找
+     * @param _Key 与键可比较的值，例如`std::string_view`
+     * @return 是否存在
+     */
+    template <typename _Kty, typename _Cmp = key_compare, typename = typename std::enable_if<_Is_transparent<_Cmp>::value>::type>
+    bool contains(const _Kty & _Key) const noexcept
+    {
+        return _Skiplist.contains(_Key) && !_Is_expired(_Key);
+    }
+
+    /**
+     * @brief 设置已有键的存活时间
+     * @param _Key 键
+     * @param _Ttl 存活时间，不大于0时键立即过期
+     * @return 键是否存在
+     */
+    bool expire(const key_type & _Key, duration _Ttl)
+    {
+        if (!contains(_Key)) {
+            return false;
+        }
+
+        auto _Deadline = clock_type::now() + _Ttl;
+        auto _Apply = [&] {
+            _Expiry.set(_Key, _Deadline);
+            return true;
+        };
+
+        return _Wal ? _Wal->append(_Write_ahead_log::encode_expire(_Key, _To_wall_deadline(_Deadline)), _Apply) : _Apply();
+    }
+
+    /**
+     * @brief 获取键的剩余存活时间
+     * @param _Key 键
+     * @return 剩余存活时间，键不存在或没有设置过期时间时为空
+     */
+    std::optional<duration> ttl(const key_type & _Key) const
+    {
+        const auto * _Deadline = _Expiry.empty() ? nullptr : _Expiry.find(_Key);
+        auto _Now = clock_type::now();
+
+        if (_Deadline == nullptr || !(_Now < *_Deadline) || !_Skiplist.contains(_Key)) {
+            return std::nullopt;
+        }
+
+        return *_Deadline - _Now;
+    }
+
+    /**
+     * @brief 清除键的过期时间，使其永久保存
+     * @param _Key 键
+     * @return 是否清除成功，键不存在或没有设置过期时间时为false
+     */
+    bool persist(const key_type & _Key)
+    {
+        if (_Expiry.empty() || _Expiry.find(_Key) == nullptr || !contains(_Key)) {
+            return false;
+        }
+
+        auto _Apply = [&] {
+            return _Expiry.clear(_Key);
+        };
+
+        return _Wal ? _Wal->append(_Write_ahead_log::encode_expire(_Key, 0), _Apply) : _Apply();
+    }
+
+    /**
+     * @brief 清理已经过期的键
+     * @details 按过期时间顺序删除，每次最多删除_Limit个，调用者可以据此控制每次清理的耗时。
+     * 写操作会顺带清理最多`EXPIRE_STEP`个，读多写少时应当定期调用。
+     * 开启了预写日志时，整批删除作为一次追加写入日志
+     * @param _Limit 最多删除的个数
+     * @return 删除的个数
+     */
+    size_type sweep(size_type _Limit = static_cast<size_type>(-1))
+    {
+        if (_Expiry.empty() || _Limit == 0) {
+            return 0;
+        }
+
+        std::string _Records;
+        auto _Now = clock_type::now();
+
+        if (_Wal) {
+            size_type _Count = 0;
+            _Expiry.for_each_expired(_Now, [&](const key_type & _Key) {
+                _Records.append(_Write_ahead_log::encode_erase(_Key));
+                return ++_Count < _Limit;
+            });
+        }
+
+        auto _Apply = [&] {
+            return _Expiry.pop_expired(_Now, _Limit, [&](const key_type & _Key) {
+                _Release(_Key);
+                _Skiplist.erase(_Key);
+            });
+        };
+
+        return _Records.empty() ? _Apply() : _Wal->append(_Records, _Apply);
+    }
+
+    /**
+     * @brief 批量获取值
+     * @details 按键排序后用手指查找依次处理，每个键只从与上一个键的查找路径分叉的层级开始向下查找
+     * @param _Keys 键
+     * @param _Values 用于接收值，与键一一对应，不存在的键对应默认值
+     * @return 存在的键的个数
+     */
+    size_type multi_get(const std::vector<key_type> & _Keys, std::vector<value_type> & _Values) const
+    {
+        std::vector<size_type> _Order = _Sorted_order(_Keys, [](const key_type & _Key) -> const key_type & {
+            return _Key;
+        });
+        typename skiplist_type::finger _Finger;
+        auto _Last = _Skiplist.end();
+        auto _Now = clock_type::now();
+        size_type _Found = 0;
+
+        _Values.assign(_Keys.size(), value_type());
+        for (size_type _Index : _Order) {
+            auto _It = _Skiplist.find(_Keys[_Index], _Finger);
+            if (_It != _Last && !_Is_expired(_It->first, _Now)) {
+                _Touch(_It);
+                _Values[_Index] = _It->second;
+                ++_Found;
+            }
+        }
+
+        return _Found;
+    }
+
+    /**
+     * @brief 批量插入键值对
+     * @details 按键排序后用手指查找依次插入，批次内重复的键以先出现的为准。
+     * 开启了预写日志时，整批实际插入的键值对作为一次追加写入日志
+     * @param _Pairs 键值对
+     * @return 插入成功的个数
+     */
+    size_type multi_put(const std::vector<std::pair<key_type, value_type>> & _Pairs)
+    {
+        std::vector<size_type> _Order = _Sorted_order(_Pairs, [](const std::pair<key_type, value_type> & _Pair) -> const key_type & {
+            return _Pair.first;
+        });
+        std::string _Records;
+        size_type _Inserted = 0;
+
+        _Sweep_step();
+        auto _Now = clock_type::now();
+
+        if (_Wal) {
+            // 预先确定实际插入的键值对并写入日志：批次内第一次出现，并且不存在或已经过期
+            _Order = _Plan_batch(_Order, _Pairs, [](const std::pair<key_type, value_type> & _Pair) -> const key_type & {
+                return _Pair.first;
+            }, [this, _Now](typename skiplist_type::const_iterator _It) {
+                return _It == _Skiplist.end() || _Is_expired(_It->first, _Now);
+            });
+
+            for (size_type _Index : _Order) {
+                _Records.append(_Write_ahead_log::encode_set(_Pairs[_Index].first, _Pairs[_Index].second));
+            }
+        }
+
+        auto _Apply = [&] {
+            typename skiplist_type::finger _Finger;
+
+            for (size_type _Index : _Order) {
+                const std::pair<key_type, value_type> & _Pair = _Pairs[_Index];
+                if (_Is_expired(_Pair.first, _Now)) {
+                    _Expiry.clear(_Pair.first);
+                    _Release(_Pair.first);
+                    _Skiplist.erase(_Pair.first, _Finger);
+                }
+
+                auto _Result = _Skiplist.insert(pair_type(_Pair.first, _Pair.second), _Finger);
+                if (!_Result.second) {
+                    continue;
+                }
+
+                _Charge(_Result.first);
+                ++_Inserted;
+            }
+        };
+
+        if (_Records.empty()) {
+            _Apply();
+        } else {
+            _Wal->append(_Records, _Apply);
+        }
+
+        _Evict_if_needed();
+        return _Inserted;
+    }
+
+    /**
+     * @brief 批量删除键值对
+     * @details 按键排序后用手指查找依次删除，开启了预写日志时整批作为一次追加写入日志
+     * @param _Keys 键
+     * @return 删除成功的个数
+     */
+    size_type multi_remove(const std::vector<key_type> & _Keys)
+    {
+        std::vector<size_type> _Order = _Sorted_order(_Keys, [](const key_type & _Key) -> const key_type & {
+            return _Key;
+        });
+        std::string _Records;
+        size_type _Removed = 0;
+
+        _Sweep_step();
+        auto _Now = clock_type::now();
+
+        if (_Wal) {
+            // 预先确定实际删除的键并写入日志：批次内第一次出现并且存在，已过期的键同样删除
+            _Order = _Plan_batch(_Order, _Keys, [](const key_type & _Key) -> const key_type & {
+                return _Key;
+            }, [this](typename skiplist_type::const_iterator _It) {
+                return _It != _Skiplist.end();
+            });
+
+            for (size_type _Index : _Order) {
+                _Records.append(_Write_ahead_log::encode_erase(_Keys[_Index]));
+            }
+        }
+
+        auto _Apply = [&] {
+            typename skiplist_type::finger _Finger;
+
+            for (size_type _Index : _Order) {
+                bool _Live = !_Is_expired(_Keys[_Index], _Now);
+                if (!_Expiry.empty()) {
+                    _Expiry.clear(_Keys[_Index]);
+                }
+
+                _Release(_Keys[_Index]);
+                if (_Skiplist.erase(_Keys[_Index], _Finger) != 0 && _Live) {
+                    ++_Removed;
+                }
+            }
+        };
+
+        if (_Records.empty()) {
+            _Apply();
+        } else {
+            _Wal->append(_Records, _Apply);
+        }
+
+        return _Removed;
     }
 
     /**
@@ -108,6 +683,1148 @@ public:
     {
         return _Skiplist.size();
     }
+
+    /**
+     * @brief 按键的升序访问[_Start, _End)范围内的键值对
+     * @details 以O(log n)定位起点后沿第0层向后遍历，回调中不能修改当前储存
+     * @param _Start 起始键（包含）
+     * @param _End 结束键（不包含）
+     * @param _Limit 最多访问的个数
+     * @param _Callback 回调，参数为键和值
+     * @return 访问的个数
+     */
+    template <typename _Fn>
+    size_type scan(const key_type & _Start, const key_type & _End, size_type _Limit, _Fn _Callback) const
+    {
+        return _Scan(_Start, &_End, _Limit, _Callback);
+    }
+
+    /**
+     * @brief 按键的升序访问以给定前缀开头的键值对
+     * @details 要求键为`std::string`且使用默认的字典序
+     * @param _Prefix 前缀
+     * @param _Limit 最多访问的个数
+     * @param _Callback 回调，参数为键和值
+     * @return 访问的个数
+     */
+    template <typename _Fn>
+    size_type prefix_scan(const key_type & _Prefix, size_type _Limit, _Fn _Callback) const
+    {
+        key_type _End = _Prefix;
+        return _Scan(_Prefix, _Prefix_successor(_End) ? &_End : nullptr, _Limit, _Callback);
+    }
+
+    /**
+     * @brief 按键的降序访问[_Start, _End)范围内的键值对
+     * @details 以O(log n)定位终点后沿第0层的向后指针遍历，回调中不能修改当前储存
+     * @param _Start 起始键（包含）
+     * @param _End 结束键（不包含），从小于它的最大键开始
+     * @param _Limit 最多访问的个数
+     * @param _Callback 回调，参数为键和值
+     * @return 访问的个数
+     */
+    template <typename _Fn>
+    size_type reverse_scan(const key_type & _Start, const key_type & _End, size_type _Limit, _Fn _Callback) const
+    {
+        key_compare _Comp = _Skiplist.key_comp();
+        size_type _Count = 0;
+        auto _First = _Skiplist.begin();
+        auto _Now = clock_type::now();
+
+        for (auto _It = _Skiplist.lower_bound(_End); _It != _First && _Count < _Limit;) {
+            --_It;
+            if (_Comp(_It->first, _Start)) {
+                break;
+            }
+
+            if (_Is_expired(_It->first, _Now)) {
+                continue;
+            }
+
+            _Callback(_It->first, _It->second);
+            ++_Count;
+        }
+
+        return _Count;
+    }
+
+    /**
+     * @brief 按键的升序访问从第_Offset个开始的键值对，用于分页
+     * @details 以O(log n)定位到指定位置，不需要逐个跳过前面的元素。位置计入尚未清理的过期键
+     * @param _Offset 从0开始的起始位置
+     * @param _Limit 最多访问的个数
+     * @param _Callback 回调，参数为键和值
+     * @return 访问的个数
+     */
+    template <typename _Fn>
+    size_type scan(size_type _Offset, size_type _Limit, _Fn _Callback) const
+    {
+        size_type _Count = 0;
+        auto _Last = _Skiplist.end();
+        auto _Now = clock_type::now();
+
+        for (auto _It = _Skiplist.select(_Offset); _It != _Last && _Count < _Limit; ++_It) {
+            if (_Is_expired(_It->first, _Now)) {
+                continue;
+            }
+
+            _Callback(_It->first, _It->second);
+            ++_Count;
+        }
+
+        return _Count;
+    }
+
+    /**
+     * @brief 获取键的排名
+     * @param _Key 键
+     * @return 小于键的元素个数，键存在时即为它从0开始的位置
+     */
+    size_type rank(const key_type & _Key) const noexcept
+    {
+        return _Skiplist.rank(_Key);
+    }
+
+    /**
+     * @brief 获取指定位置的键值对
+     * @param _Index 从0开始的位置
+     * @param _Key 用于接收键
+     * @param _Value 用于接收值
+     * @return 位置是否有效，该位置的键已过期时为false
+     */
+    bool select(size_type _Index, key_type & _Key, value_type & _Value) const
+    {
+        auto _It = _Skiplist.select(_Index);
+        if (_It == _Skiplist.end() || _Is_expired(_It->first)) {
+            return false;
+        }
+
+        _Key = _It->first;
+        _Value = _It->second;
+        return true;
+    }
+
+    /**
+     * @brief 统计[_Low, _High)范围内的键值对个数
+     * @param _Low 起始键（包含）
+     * @param _High 结束键（不包含）
+     * @return 个数
+     */
+    size_type count_range(const key_type & _Low, const key_type & _High) const noexcept
+    {
+        return _Skiplist.count_range(_Low, _High);
+    }
+
+    /**
+     * @brief 设置内存预算
+     * @details 占用按跳表节点、键和值在堆上持有的内存统计。设置时重新统计全部键，
+     * 之后每次写操作使占用超出预算时，从随机采样的`EVICTION_SAMPLES`个键中淘汰最差的一个，
+     * 直到回到预算以内，已过期的键优先被删除。开启了预写日志时，淘汰作为删除写入日志
+     * @param _Bytes 字节数，为0时不限制
+     * @param _Policy 淘汰策略
+     */
+    void set_memory_limit(size_type _Bytes, eviction_policy _Policy = eviction_policy::lru)
+    {
+        _Memory_limit = _Bytes;
+        _Tracker = _Access_tracker(_Policy);
+        _Recount_memory();
+        _Evict_if_needed();
+    }
+
+    /**
+     * @brief 获取内存预算
+     * @return 字节数，为0时不限制
+     */
+    size_type memory_limit() const noexcept
+    {
+        return _Memory_limit;
+    }
+
+    /**
+     * @brief 获取已使用的内存
+     * @return 字节数，没有设置预算时不统计，为0
+     */
+    size_type memory_usage() const noexcept
+    {
+        return _Memory_used;
+    }
+
+    /**
+     * @brief 获取因超出预算而淘汰的键的个数
+     * @return 个数
+     */
+    size_type evictions() const noexcept
+    {
+        return _Evictions;
+    }
+
+    /**
+     * @brief 获取统计快照
+     * @details 塔高分布和内存占用需要遍历所有节点，复杂度为O(n)，不适合频繁调用
+     * @return 快照
+     */
+    kvstore_stats stats() const
+    {
+        kvstore_stats _Result;
+        _Recorder.fill(_Result);
+
+        _Result.size = _Skiplist.size();
+        _Result.tower_heights.assign(static_cast<std::size_t>(_Skiplist.level_limit()), 0);
+
+        for (auto _It = _Skiplist.begin(); _It != _Skiplist.end(); ++_It) {
+            level_type _Level = _Skiplist.node_level(_It);
+            if (static_cast<std::size_t>(_Level) >= _Result.tower_heights.size()) {
+                _Result.tower_heights.resize(static_cast<std::size_t>(_Level) + 1, 0);
+            }
+            ++_Result.tower_heights[static_cast<std::size_t>(_Level)];
+
+            _Result.key_bytes += sizeof(key_type) + _Heap_size<key_type>::of(_It->first);
+            _Result.value_bytes += sizeof(value_type) + _Heap_size<value_type>::of(_It->second);
+            _Result.tower_bytes += _Skiplist.node_size(_It) - sizeof(pair_type);
+        }
+
+        return _Result;
+    }
+
+private:
+    /**
+     * @brief 插入键值对，键值对在跳表节点内原地构造
+     * @details 日志记录在修改之前编码，之后才会移动键和值。过期时间在淘汰之前设置，
+     * 新插入的键因占用超出预算被立即淘汰时，过期时间随之清除
+     * @param _Key 键
+     * @param _Value 值
+     * @param _Deadline 过期时间，为空时不设置
+     * @return 是否插入成功，插入后被立即淘汰时返回false
+     */
+    template <typename _K, typename _V>
+    bool _Put(_K && _Key, _V && _Value, const typename expiry_type::time_point * _Deadline = nullptr)
+    {
+        auto _Record = _Recorder.begin(_Stats_op::put);
+        _Sweep_step();
+        auto _Now = clock_type::now();
+        const key_type * _Inserted_key = nullptr;
+
+        auto _Apply = [&] {
+            _Purge_expired(_Key, _Now);
+
+            auto _Result = _Skiplist.try_emplace(std::forward<_K>(_Key), std::forward<_V>(_Value));
+            if (_Result.second) {
+                _Charge(_Result.first);
+                _Inserted_key = &_Result.first->first;
+
+                // 新插入的键不能沿用残留的过期时间
+                if (_Deadline != nullptr) {
+                    _Expiry.set(*_Inserted_key, *_Deadline);
+                } else if (!_Expiry.empty()) {
+                    _Expiry.clear(*_Inserted_key);
+                }
+            }
+
+            return _Result.second;
+        };
+
+        // 键已存在时没有修改，不写入日志
+        bool _Exists = _Wal && _Skiplist.contains(_Key) && !_Is_expired(_Key, _Now);
+        bool _Inserted = false;
+
+        if (_Wal && !_Exists) {
+            std::string _Records = _Write_ahead_log::encode_set(_Key, _Value);
+            if (_Deadline != nullptr) {
+                _Records.append(_Write_ahead_log::encode_expire(_Key, _To_wall_deadline(*_Deadline)));
+            }
+            _Inserted = _Wal->append(_Records, _Apply);
+        } else {
+            _Inserted = _Apply();
+        }
+
+        return _Evict_if_needed(_Inserted_key) && _Inserted;
+    }
+
+    /**
+     * @brief 更新键值对，键存在时赋值，不存在时原地构造
+     * @param _Key 键
+     * @param _Value 值
+     * @return 是否更新成功
+     */
+    template <typename _K, typename _V>
+    bool _Update(_K && _Key, _V && _Value)
+    {
+        auto _Record = _Recorder.begin(_Stats_op::put);
+        _Sweep_step();
+
+        auto _Apply = [&] {
+            if (!_Expiry.empty()) {
+                _Expiry.clear(_Key);
+            }
+
+            if (_Memory_limit == 0) {
+                _Skiplist.insert_or_assign(std::forward<_K>(_Key), std::forward<_V>(_Value));
+                return true;
+            }
+
+            // 值的大小可能改变，先扣除旧的占用
+            auto _Old = _Skiplist.find(_Key);
+            if (_Old != _Skiplist.end()) {
+                _Memory_used -= _Entry_size(_Old);
+            }
+
+            auto _Result = _Skiplist.insert_or_assign(std::forward<_K>(_Key), std::forward<_V>(_Value));
+            _Memory_used += _Entry_size(_Result.first);
+            if (_Result.second) {
+                _Skiplist.access_mark(_Result.first) = _Tracker.initial();
+            } else {
+                _Tracker.touch(_Skiplist.access_mark(_Result.first));
+            }
+
+            return true;
+        };
+
+        bool _Updated = _Wal ? _Wal->append(_Write_ahead_log::encode_set(_Key, _Value), _Apply) : _Apply();
+        _Evict_if_needed();
+        return _Updated;
+    }
+
+    /**
+     * @brief 判断键是否已经过期
+     * @details 没有任何键设置过期时间时不读取时钟
+     * @param _Key 键
+     * @return 是否已经过期
+     */
+    template <typename _Kty>
+    bool _Is_expired(const _Kty & _Key) const
+    {
+        return !_Expiry.empty() && _Expiry.expired(_Key, clock_type::now());
+    }
+
+    /**
+     * @brief 判断键在给定时间是否已经过期
+     * @param _Key 键
+     * @param _Now 当前时间
+     * @return 是否已经过期
+     */
+    bool _Is_expired(const key_type & _Key, typename expiry_type::time_point _Now) const
+    {
+        return !_Expiry.empty() && _Expiry.expired(_Key, _Now);
+    }
+
+    /**
+     * @brief 删除已经过期但尚未清理的键，使之后的插入可以成功
+     * @param _Key 键
+     * @param _Now 当前时间
+     */
+    void _Purge_expired(const key_type & _Key, typename expiry_type::time_point _Now)
+    {
+        if (_Is_expired(_Key, _Now)) {
+            _Expiry.clear(_Key);
+            _Release(_Key);
+            _Skiplist.erase(_Key);
+        }
+    }
+
+    /**
+     * @brief 计算一个元素占用的内存
+     * @param _It 指向元素的迭代器
+     * @return 字节数
+     */
+    size_type _Entry_size(typename skiplist_type::const_iterator _It) const noexcept
+    {
+        return _Skiplist.node_size(_It) + _Heap_size<key_type>::of(_It->first) + _Heap_size<value_type>::of(_It->second);
+    }
+
+    /**
+     * @brief 记录一次命中
+     * @param _It 指向元素的迭代器
+     */
+    void _Touch(typename skiplist_type::const_iterator _It) const noexcept
+    {
+        if (_Memory_limit != 0) {
+            _Tracker.touch(_Skiplist.access_mark(_It));
+        }
+    }
+
+    /**
+     * @brief 统计新插入的元素
+     * @param _It 指向元素的迭代器
+     */
+    void _Charge(typename skiplist_type::const_iterator _It) noexcept
+    {
+        if (_Memory_limit != 0) {
+            _Memory_used += _Entry_size(_It);
+            _Skiplist.access_mark(_It) = _Tracker.initial();
+        }
+    }
+
+    /**
+     * @brief 扣除即将删除的元素的占用
+     * @details 只在设置了预算时多一次查找
+     * @param _Key 键
+     */
+    void _Release(const key_type & _Key) noexcept
+    {
+        if (_Memory_limit != 0) {
+            auto _It = _Skiplist.find(_Key);
+            if (_It != _Skiplist.end()) {
+                _Memory_used -= _Entry_size(_It);
+            }
+        }
+    }
+
+    /**
+     * @brief 重新统计全部元素的占用，并重置访问标记
+     */
+    void _Recount_memory() noexcept
+    {
+        _Memory_used = 0;
+        if (_Memory_limit == 0) {
+            return;
+        }
+
+        for (auto _It = _Skiplist.begin(); _It != _Skiplist.end(); ++_It) {
+            _Memory_used += _Entry_size(_It);
+            _Skiplist.access_mark(_It) = _Tracker.initial();
+        }
+    }
+
+    /**
+     * @brief 占用超出预算时淘汰元素
+     * @details 每淘汰一个元素需要采样`EVICTION_SAMPLES`次，每次按排名O(log n)定位，
+     * 与插入本身的复杂度相同。至少保留一个元素。开启了预写日志时，
+     * 每轮最多选出`EVICTION_BATCH`个元素，写入日志后再删除
+     * @param _Watched 需要关注的元素的键，为空时不关注
+     * @return 关注的元素是否仍然存在
+     */
+    bool _Evict_if_needed(const key_type * _Watched = nullptr)
+    {
+        auto _Now = clock_type::now();
+        bool _Survived = true;
+
+        while (_Memory_limit != 0 && _Memory_used > _Memory_limit && _Skiplist.size() > 1) {
+            std::vector<std::pair<typename skiplist_type::iterator, bool>> _Victims = _Plan_evictions(_Now);
+            std::string _Records;
+
+            if (_Wal) {
+                for (const auto & _Victim : _Victims) {
+                    _Records.append(_Write_ahead_log::encode_erase(_Victim.first->first));
+                }
+            }
+
+            auto _Apply = [&] {
+                for (const auto & _Victim : _Victims) {
+                    _Memory_used -= _Entry_size(_Victim.first);
+                    if (!_Expiry.empty()) {
+                        _Expiry.clear(_Victim.first->first);
+                    }
+
+                    if (&_Victim.first->first == _Watched) {
+                        _Survived = false;
+                    }
+
+                    _Skiplist.erase(_Victim.first);
+                    if (!_Victim.second) {
+                        ++_Evictions;
+                    }
+                }
+            };
+
+            if (_Records.empty()) {
+                _Apply();
+            } else {
+                _Wal->append(_Records, _Apply);
+            }
+        }
+
+        return _Survived;
+    }
+
+    /**
+     * @brief 选出一轮要淘汰的元素，不修改跳表
+     * @details 已过期的键优先，其余的按采样选出，直到预计的占用不超出预算
+     * @param _Now 当前时间
+     * @return 指向元素的迭代器，以及元素是否已经过期
+     */
+    std::vector<std::pair<typename skiplist_type::iterator, bool>> _Plan_evictions(typename expiry_type::time_point _Now)
+    {
+        std::vector<std::pair<typename skiplist_type::iterator, bool>> _Victims;
+        size_type _Projected = _Memory_used;
+
+        auto _Needs_more = [&] {
+            return _Projected > _Memory_limit && _Victims.size() < EVICTION_BATCH && _Skiplist.size() - _Victims.size() > 1;
+        };
+
+        _Expiry.for_each_expired(_Now, [&](const key_type & _Key) {
+            if (!_Needs_more()) {
+                return false;
+            }
+
+            auto _It = _Skiplist.find(_Key);
+            if (_It != _Skiplist.end()) {
+                _Projected -= _Entry_size(_It);
+                _Victims.emplace_back(_It, true);
+            }
+            return true;
+        });
+
+        while (_Needs_more()) {
+            auto _It = _Sample_victim([&_Victims](typename skiplist_type::iterator _Candidate) {
+                for (const auto & _Victim : _Victims) {
+                    if (_Victim.first == _Candidate) {
+                        return true;
+                    }
+                }
+                return false;
+            });
+
+            _Projected -= _Entry_size(_It);
+            _Victims.emplace_back(_It, false);
+        }
+
+        return _Victims;
+    }
+
+    /**
+     * @brief 随机采样若干个元素，选出最应该被淘汰的一个
+     * @param _Excluded 判断元素是否已经被选中，被选中的元素不参与采样
+     * @return 指向元素的迭代器，跳表中至少要有一个未被选中的元素
+     */
+    template <typename _Fn>
+    typename skiplist_type::iterator _Sample_victim(_Fn _Excluded) noexcept
+    {
+        _Xorshift_random & _Random = _Xorshift_random::local();
+        auto _Victim = _Skiplist.end();
+        std::uint32_t _Worst = 0;
+
+        for (size_type _Sample = 0; _Sample < EVICTION_SAMPLES || _Victim == _Skiplist.end(); ++_Sample) {
+            auto _It = _Skiplist.select(static_cast<size_type>(_Random() % _Skiplist.size()));
+            if (_Excluded(_It)) {
+                continue;
+            }
+
+            std::uint32_t _Score = _Tracker.score(_Skiplist.access_mark(_It));
+            if (_Victim == _Skiplist.end() || _Score > _Worst) {
+                _Victim = _It;
+                _Worst = _Score;
+            }
+        }
+
+        return _Victim;
+    }
+
+    /**
+     * @brief 写操作顺带清理少量过期键
+     */
+    void _Sweep_step()
+    {
+        if (!_Expiry.empty()) {
+            sweep(EXPIRE_STEP);
+        }
+    }
+
+    /**
+     * @brief 从按键排序的下标中选出实际生效的操作
+     * @details 批次内重复的键只保留第一次出现
+     * @param _Order 按键升序排列的下标
+     * @param _Items 元素
+     * @param _Key_of 从元素中取出键
+     * @param _Effective 根据查找结果判断操作是否生效
+     * @return 生效的操作的下标
+     */
+    template <typename _Ty_item, typename _Fn_key, typename _Fn_effective>
+    std::vector<size_type> _Plan_batch(const std::vector<size_type> & _Order, const std::vector<_Ty_item> & _Items,
+                                       _Fn_key _Key_of, _Fn_effective _Effective) const
+    {
+        std::vector<size_type> _Planned;
+        typename skiplist_type::finger _Finger;
+        key_compare _Comp = _Skiplist.key_comp();
+        const key_type * _Previous = nullptr;
+
+        for (size_type _Index : _Order) {
+            const key_type & _Key = _Key_of(_Items[_Index]);
+            bool _Duplicate = _Previous != nullptr && !_Comp(*_Previous, _Key);
+            _Previous = &_Key;
+
+            if (!_Duplicate && _Effective(_Skiplist.find(_Key, _Finger))) {
+                _Planned.push_back(_Index);
+            }
+        }
+
+        return _Planned;
+    }
+
+    /**
+     * @brief 计算一批元素按键升序排列的下标
+     * @details 已经有序时不排序，排序是稳定的，相等的键保持原来的先后顺序
+     * @param _Items 元素
+     * @param _Key_of 从元素中取出键
+     * @return 下标
+     */
+    template <typename _Ty_item, typename _Fn>
+    std::vector<size_type> _Sorted_order(const std::vector<_Ty_item> & _Items, _Fn _Key_of) const
+    {
+        std::vector<size_type> _Order(_Items.size());
+        std::iota(_Order.begin(), _Order.end(), size_type(0));
+
+        key_compare _Comp = _Skiplist.key_comp();
+        auto _Less = [&](size_type _Left, size_type _Right) {
+            return _Comp(_Key_of(_Items[_Left]), _Key_of(_Items[_Right]));
+        };
+
+        if (!std::is_sorted(_Order.begin(), _Order.end(), _Less)) {
+            std::stable_sort(_Order.begin(), _Order.end(), _Less);
+        }
+
+        return _Order;
+    }
+
+    /**
+     * @brief 按键的升序访问[_Start, _End)范围内的键值对
+     * @param _Start 起始键（包含）
+     * @param _End 结束键（不包含），为空时直到末尾
+     * @param _Limit 最多访问的个数
+     * @param _Callback 回调
+     * @return 访问的个数
+     */
+    template <typename _Fn>
+    size_type _Scan(const key_type & _Start, const key_type * _End, size_type _Limit, _Fn & _Callback) const
+    {
+        key_compare _Comp = _Skiplist.key_comp();
+        size_type _Count = 0;
+        auto _Last = _Skiplist.end();
+        auto _Now = clock_type::now();
+
+        for (auto _It = _Skiplist.lower_bound(_Start); _It != _Last && _Count < _Limit; ++_It) {
+            if (_End != nullptr && !_Comp(_It->first, *_End)) {
+                break;
+            }
+
+            if (_Is_expired(_It->first, _Now)) {
+                continue;
+            }
+
+            _Callback(_It->first, _It->second);
+            ++_Count;
+        }
+
+        return _Count;
+    }
+};
+
+/**
+ * @brief 使用无锁跳表的KV储存
+ * @details 所有操作都可以被多个线程并发调用，值以拷贝的方式返回。
+ * 节点内存不经过分配器，`_Alloc`在该策略下不起作用
+ * @tparam _Key 键类型
+ * @tparam _Value 值类型
+ * @tparam _Compare 比较器类型
+ * @tparam _Alloc 分配器类型
+ */
+template <
+    typename _Ty_key,
+    typename _Ty_value,
+    typename _Ty_compare,
+    typename _Ty_alloc
+> class KVStore<_Ty_key, _Ty_value, _Ty_compare, _Ty_alloc, lock_free_policy>
+{
+public:
+    using key_type = _Ty_key;
+    using value_type = _Ty_value;
+    using pair_type = std::pair<const _Ty_key, _Ty_value>;
+    using size_type = std::size_t;
+    using level_type = int;
+    using key_compare = _Ty_compare;
+    using allocator_type = _Ty_alloc;
+    using const_iterator = typename _Concurrent_skiplist<key_type, value_type, key_compare>::const_iterator;
+
+protected:
+    _Concurrent_skiplist<key_type, value_type, key_compare> _Skiplist;     // 并发跳表
+    std::unique_ptr<_Write_ahead_log> _Wal;                                 // 预写日志，未开启时为空
+    _Stats_recorder _Recorder;                                              // 操作统计，未定义`WW_KVSTORE_STATS`时为空
+
+public:
+    KVStore() = default;
+
+    explicit KVStore(level_type _Max_level)
+        : _Skiplist(_Max_level)
+    {
+    }
+
+    explicit KVStore(const key_compare & _Compare)
+        : _Skiplist(MAX_LEVEL, _Compare)
+    {
+    }
+
+    ~KVStore() = default;
+
+public:
+    /**
+     * @brief 开启预写日志
+     * @details 不能与其他操作并发调用。开启后写操作的记录写入日志之后才生效，
+     * 并发的写操作通过组提交共享同一次刷盘，再按记录的顺序依次生效
+     * @param _Options 日志选项
+     * @return 重放的记录个数
+     */
+    std::size_t open(const wal_options & _Options)
+    {
+        std::unique_ptr<_Write_ahead_log> _Log(new _Write_ahead_log(_Options));
+
+        std::size_t _Count = _Log->open([this](_Write_ahead_log::record_type _Type, const char * _First, const char * _Last) {
+            return _Write_ahead_log::decode<key_type, value_type>(_Type, _First, _Last,
+                [this](const key_type & _Key, const value_type & _Value) { _Skiplist.insert_or_assign(_Key, _Value); },
+                [this](const key_type & _Key, const value_type & _Value) { _Skiplist.insert(_Key, _Value); },
+                [this](const key_type & _Key) { _Skiplist.erase(_Key); },
+                [](const key_type &, std::uint64_t) {});
+        });
+
+        _Wal = std::move(_Log);
+        return _Count;
+    }
+
+    /**
+     * @brief 关闭预写日志，不能与其他操作并发调用
+     */
+    void close() noexcept
+    {
+        _Wal.reset();
+    }
+
+    /**
+     * @brief 将当前内容写入检查点文件
+     * @details 可以与读操作并发。与写操作并发时得到的是一个模糊快照，
+     * 因此开启了预写日志时不能与写操作并发，检查点完成后清空日志
+     * @param _Path 文件路径
+     * @return 写出的键值对个数
+     */
+    size_type checkpoint(const std::string & _Path)
+    {
+        _Checkpoint_writer _Writer(_Path);
+
+        for (auto _It = _Skiplist.begin(); _It != _Skiplist.end(); ++_It) {
+            _Writer.add(_It->first, _It->second);
+        }
+
+        size_type _Count = _Writer.finish();
+
+        if (_Wal) {
+            _Wal->reset();
+        }
+
+        return _Count;
+    }
+
+    /**
+     * @brief 从检查点文件加载，替换当前的全部内容
+     * @details 不能与其他操作并发调用，应当在`open`之前调用
+     * @param _Path 文件路径
+     * @return 加载的键值对个数
+     */
+    size_type load(const std::string & _Path)
+    {
+        _Checkpoint_reader _Reader(_Path);
+        typename _Concurrent_skiplist<key_type, value_type, key_compare>::sorted_builder _Builder(_Skiplist);
+
+        std::uint64_t _Now = _Wall_now();
+
+        // 不支持过期时间，已经过期的键不加载，其余的永久保存
+        _Reader.for_each<key_type, value_type>([&](key_type && _Key, value_type && _Value, std::uint64_t _Wall_deadline) {
+            if (_Wall_deadline == 0 || _Now < _Wall_deadline) {
+                _Builder.append(_Key, _Value);
+            }
+        });
+
+        return _Skiplist.size();
+    }
+
+    /**
+     * @brief 获取值
+     * @param _Key 键
+     * @return 值，不存在时为空
+     */
+    std::optional<value_type> get(const key_type & _Key) const
+    {
+        auto _Record = _Recorder.begin(_Stats_op::get);
+
+        value_type _Value = value_type();
+        bool _Found = _Skiplist.get(_Key, _Value);
+        _Record.hit(_Found);
+
+        if (!_Found) {
+            return std::nullopt;
+        }
+
+        return _Value;
+    }
+
+    /**
+     * @brief 获取值，不存在时返回给定的默认值
+     * @param _Key 键
+     * @param _Default 默认值
+     * @return 值
+     */
+    value_type get_or_default(const key_type & _Key, const value_type & _Default = value_type()) const
+    {
+        auto _Record = _Recorder.begin(_Stats_op::get);
+
+        value_type _Value = value_type();
+        bool _Found = _Skiplist.get(_Key, _Value);
+        _Record.hit(_Found);
+
+        return _Found ? _Value : _Default;
+    }
+
+    /**
+     * @brief 获取值并赋值给已有对象，可以复用对象已经持有的内存
+     * @param _Key 键
+     * @param _Value 用于接收值，不存在时不修改
+     * @return 是否存在
+     */
+    bool get_into(const key_type & _Key, value_type & _Value) const
+    {
+        auto _Record = _Recorder.begin(_Stats_op::get);
+
+        bool _Found = _Skiplist.get(_Key, _Value);
+        _Record.hit(_Found);
+        return _Found;
+    }
+
+    /**
+     * @brief 插入键值对
+     * @param _Key 键
+     * @param _Value 值
+     * @return 是否插入成功
+     */
+    bool put(const key_type & _Key, const value_type & _Value)
+    {
+        auto _Record = _Recorder.begin(_Stats_op::put);
+
+        // 事先判断键是否存在与修改之间可能有其他线程修改同一个键，因此总是写入日志。
+        // 记录按插入语义重放，与修改按相同的顺序生效，键已存在时重放同样插入失败
+        if (_Wal) {
+            return _Wal->append(_Write_ahead_log::encode_insert(_Key, _Value), [&] {
+                return _Skiplist.insert(_Key, _Value);
+            });
+        }
+
+        return _Skiplist.insert(_Key, _Value);
+    }
+
+    /**
+     * @brief 更新键值对，不存在时插入
+     * @param _Key 键
+     * @param _Value 值
+     * @return 是否更新成功
+     */
+    bool update(const key_type & _Key, const value_type & _Value)
+    {
+        auto _Record = _Recorder.begin(_Stats_op::put);
+
+        if (_Wal) {
+            return _Wal->append(_Write_ahead_log::encode_set(_Key, _Value), [&] {
+                _Skiplist.insert_or_assign(_Key, _Value);
+                return true;
+            });
+        }
+
+        _Skiplist.insert_or_assign(_Key, _Value);
+        return true;
+    }
+
+    /**
+     * @brief 删除键值对
+     * @param _Key 键
+     * @return 是否删除成功
+     */
+    bool remove(const key_type & _Key)
+    {
+        auto _Record = _Recorder.begin(_Stats_op::remove);
+
+        // 与插入相同，总是写入日志，键不存在时重放同样删除失败
+        if (_Wal) {
+            return _Wal->append(_Write_ahead_log::encode_erase(_Key), [&] {
+                return _Skiplist.erase(_Key) != 0;
+            });
+        }
+
+        return _Skiplist.erase(_Key) != 0;
+    }
+
+    /**
+     * @brief 查询键是否存在
+     * @param _Key 键
+     * @return 是否存在
+     */
+    bool contains(const key_type & _Key) const
+    {
+        return _Skiplist.contains(_Key);
+    }
+
+    /**
+     * @brief 判断是否为空
+     * @return 是否为空
+     */
+    bool empty() const noexcept
+    {
+        return _Skiplist.empty();
+    }
+
+    /**
+     * @brief 获取元素数量
+     * @return 元素数量
+     */
+    size_type size() const noexcept
+    {
+        return _Skiplist.size();
+    }
+
+    /**
+     * @brief 获取统计快照
+     * @details 无锁跳表的节点层级不对外暴露，快照中没有塔高分布和链接占用。
+     * 键和值的占用由遍历得到，遍历期间的并发修改可能被看到也可能看不到
+     * @return 快照
+     */
+    kvstore_stats stats() const
+    {
+        kvstore_stats _Result;
+        _Recorder.fill(_Result);
+
+        _Result.size = _Skiplist.size();
+        for (auto _It = _Skiplist.begin(); _It != _Skiplist.end(); ++_It) {
+            _Result.key_bytes += sizeof(key_type) + _Heap_size<key_type>::of(_It->first);
+            _Result.value_bytes += sizeof(value_type) + _Heap_size<value_type>::of(_It->second);
+        }
+
+        return _Result;
+    }
+
+    /**
+     * @brief 返回指向起始的迭代器，迭代期间允许其他线程修改
+     */
+    const_iterator begin() const
+    {
+        return _Skiplist.begin();
+    }
+
+    /**
+     * @brief 返回指向末尾的迭代器
+     */
+    const_iterator end() const noexcept
+    {
+        return _Skiplist.end();
+    }
+
+    /**
+     * @brief 返回指向首个不小于给定键的元素的迭代器
+     * @param _Key 键
+     * @return 迭代器
+     */
+    const_iterator lower_bound(const key_type & _Key) const
+    {
+        return _Skiplist.lower_bound(_Key);
+    }
+
+    /**
+     * @brief 按键的升序访问[_Start, _End)范围内的键值对
+     * @details 以O(log n)定位起点后沿第0层向后遍历，遍历期间其他线程的修改可能被看到也可能看不到
+     * @param _Start 起始键（包含）
+     * @param _End 结束键（不包含）
+     * @param _Limit 最多访问的个数
+     * @param _Callback 回调，参数为键和值
+     * @return 访问的个数
+     */
+    template <typename _Fn>
+    size_type scan(const key_type & _Start, const key_type & _End, size_type _Limit, _Fn _Callback) const
+    {
+        return _Scan(_Start, &_End, _Limit, _Callback);
+    }
+
+    /**
+     * @brief 按键的升序访问以给定前缀开头的键值对
+     * @details 要求键为`std::string`且使用默认的字典序
+     * @param _Prefix 前缀
+     * @param _Limit 最多访问的个数
+     * @param _Callback 回调，参数为键和值
+     * @return 访问的个数
+     */
+    template <typename _Fn>
+    size_type prefix_scan(const key_type & _Prefix, size_type _Limit, _Fn _Callback) const
+    {
+        key_type _End = _Prefix;
+        return _Scan(_Prefix, _Prefix_successor(_End) ? &_End : nullptr, _Limit, _Callback);
+    }
+
+private:
+    /**
+     * @brief 按键的升序访问[_Start, _End)范围内的键值对
+     * @param _Start 起始键（包含）
+     * @param _End 结束键（不包含），为空时直到末尾
+     * @param _Limit 最多访问的个数
+     * @param _Callback 回调
+     * @return 访问的个数
+     */
+    template <typename _Fn>
+    size_type _Scan(const key_type & _Start, const key_type * _End, size_type _Limit, _Fn & _Callback) const
+    {
+        key_compare _Comp = _Skiplist.key_comp();
+        size_type _Count = 0;
+        auto _Last = _Skiplist.end();
+
+        for (auto _It = _Skiplist.lower_bound(_Start); _It != _Last && _Count < _Limit; ++_It) {
+            if (_End != nullptr && !_Comp(_It->first, *_End)) {
+                break;
+            }
+
+            _Callback(_It->first, _It->second);
+            ++_Count;
+        }
+
+        return _Count;
+    }
+};
+
+/**
+ * @brief 内存映射只读快照的KV储存
+ * @details 直接从`checkpoint`写出的文件中查询，不构建跳表，打开时只读取索引。
+ * 不支持修改，所有操作都可以被多个线程并发调用，值以拷贝的方式返回。
+ * `_Alloc`在该策略下不起作用
+ * @tparam _Key 键类型
+ * @tparam _Value 值类型
+ * @tparam _Compare 比较器类型
+ * @tparam _Alloc 分配器类型
+ */
+template <
+    typename _Ty_key,
+    typename _Ty_value,
+    typename _Ty_compare,
+    typename _Ty_alloc
+> class KVStore<_Ty_key, _Ty_value, _Ty_compare, _Ty_alloc, mapped_snapshot_policy>
+{
+public:
+    using key_type = _Ty_key;
+    using value_type = _Ty_value;
+    using pair_type = std::pair<const _Ty_key, _Ty_value>;
+    using size_type = std::size_t;
+    using key_compare = _Ty_compare;
+    using allocator_type = _Ty_alloc;
+
+protected:
+    _Mapped_snapshot<key_type, value_type, key_compare> _Snapshot;        // 只读快照
+
+public:
+    /**
+     * @brief 打开检查点文件
+     * @param _Path 文件路径
+     * @param _Compare 比较器，必须与写出检查点时的顺序一致
+     */
+    explicit KVStore(const std::string & _Path, const key_compare & _Compare = key_compare())
+        : _Snapshot(_Path, _Compare)
+    {
+    }
+
+    ~KVStore() = default;
+
+public:
+    /**
+     * @brief 获取值
+     * @param _Key 键
+     * @return 值，不存在时为空
+     */
+    std::optional<value_type> get(const key_type & _Key) const
+    {
+        value_type _Value = value_type();
+        if (!_Snapshot.get(_Key, _Value)) {
+            return std::nullopt;
+        }
+
+        return _Value;
+    }
+
+    /**
+     * @brief 获取值，不存在时返回给定的默认值
+     * @param _Key 键
+     * @param _Default 默认值
+     * @return 值
+     */
+    value_type get_or_default(const key_type & _Key, const value_type & _Default = value_type()) const
+    {
+        value_type _Value = value_type();
+        return _Snapshot.get(_Key, _Value) ? _Value : _Default;
+    }
+
+    /**
+     * @brief 获取值并赋值给已有对象，可以复用对象已经持有的内存
+     * @param _Key 键
+     * @param _Value 用于接收值，不存在时不修改
+     * @return 是否存在
+     */
+    bool get_into(const key_type & _Key, value_type & _Value) const
+    {
+        return _Snapshot.get(_Key, _Value);
+    }
+
+    /**
+     * @brief 查询键是否存在
+     * @param _Key 键
+     * @return 是否存在
+     */
+    bool contains(const key_type & _Key) const
+    {
+        return _Snapshot.contains(_Key);
+    }
+
+    /**
+     * @brief 判断是否为空
+     * @return 是否为空
+     */
+    bool empty() const noexcept
+    {
+        return _Snapshot.empty();
+    }
+
+    /**
+     * @brief 获取元素数量
+     * @return 元素数量
+     */
+    size_type size() const noexcept
+    {
+        return _Snapshot.size();
+    }
+
+    /**
+     * @brief 按键的升序遍历所有键值对
+     * @param _Callback 回调，参数为键和值
+     */
+    template <typename _Fn>
+    void for_each(_Fn _Callback) const
+    {
+        _Snapshot.scan(nullptr, nullptr, static_cast<size_type>(-1), _Callback);
+    }
+
+    /**
+     * @brief 按键的升序访问[_Start, _End)范围内的键值对
+     * @param _Start 起始键（包含）
+     * @param _End 结束键（不包含）
+     * @param _Limit 最多访问的个数
+     * @param _Callback 回调，参数为键和值
+     * @return 访问的个数
+     */
+    template <typename _Fn>
+    size_type scan(const key_type & _Start, const key_type & _End, size_type _Limit, _Fn _Callback) const
+    {
+        return _Snapshot.scan(&_Start, &_End, _Limit, _Callback);
+    }
+
+    /**
+     * @brief 按键的升序访问以给定前缀开头的键值对
+     * @details 要求键为`std::string`且使用默认的字典序
+     * @param _Prefix 前缀
+     * @param _Limit 最多访问的个数
+     * @param _Callback 回调，参数为键和值
+     * @return 访问的个数
+     */
+    template <typename _Fn>
+    size_type prefix_scan(const key_type & _Prefix, size_type _Limit, _Fn _Callback) const
+    {
+        key_type _End = _Prefix;
+        return _Snapshot.scan(&_Prefix, _Prefix_successor(_End) ? &_End : nullptr, _Limit, _Callback);
+    }
 };
 
 } // namespace WW
@@ -0,0 +1,352 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <Checkpoint.h>
+#include <Expiry.h>
+
+namespace WW
+{
+
+/**
+ * @brief 内存映射的只读快照
+ * @details 以只读方式映射一个检查点文件，查找时先在稀疏索引（每个数据块的第一个键）上二分，
+ * 再在对应的数据块内顺序查找，不会把数据反序列化为跳表节点。
+ * 文件页由操作系统的页缓存管理，多个进程映射同一个文件时共享物理内存。
+ * 打开时只读取尾部和索引块，数据块在第一次被访问时校验。已经过期的条目在查找和遍历时不可见，
+ * 但仍然计入`size`。所有操作都可以被多个线程并发调用
+ * @tparam _Key 键类型
+ * @tparam _Value 值类型
+ * @tparam _Compare 比较器类型，必须与写出检查点时的顺序一致
+ */
+template <
+    typename _Ty_key,
+    typename _Ty_value,
+    typename _Ty_compare = std::less<_Ty_key>
+> class _Mapped_snapshot
+{
+public:
+    using key_type = _Ty_key;
+    using value_type = _Ty_value;
+    using size_type = std::size_t;
+    using key_compare = _Ty_compare;
+
+private:
+    using _Block_handle = _Checkpoint_format::block_handle;
+
+    key_compare _Comp;                                  // 比较器
+    const char * _Data;                                 // 映射起始
+    size_type _Mapped_size;                             // 映射大小
+    std::vector<_Block_handle> _Index;                  // 数据块位置列表
+    std::vector<key_type> _First_keys;                  // 每个数据块的第一个键
+    std::unique_ptr<std::atomic<bool>[]> _Verified;     // 数据块是否已经通过校验
+    size_type _Size;                                    // 条目总数
+
+public:
+    explicit _Mapped_snapshot(const std::string & _Path, const key_compare & _Compare = key_compare())
+        : _Comp(_Compare)
+        , _Data(nullptr)
+        , _Mapped_size(0)
+        , _Index()
+        , _First_keys()
+        , _Verified()
+        , _Size(0)
+    {
+        _Map(_Path);
+
+        try {
+            _Read_index();
+        } catch (...) {
+            ::munmap(const_cast<char *>(_Data), _Mapped_size);
+            throw;
+        }
+    }
+
+    _Mapped_snapshot(const _Mapped_snapshot &) = delete;
+
+    _Mapped_snapshot & operator=(const _Mapped_snapshot &) = delete;
+
+    ~_Mapped_snapshot()
+    {
+        ::munmap(const_cast<char *>(_Data), _Mapped_size);
+    }
+
+public:
+    /**
+     * @brief 获取指定键的值
+     * @param _Key 键
+     * @param _Value 用于接收值
+     * @return 是否存在
+     */
+    bool get(const key_type & _Key, value_type & _Value) const
+    {
+        return _Find(_Key, &_Value);
+    }
+
+    /**
+     * @brief 查询一个键是否存在
+     * @param _Key 键
+     * @return 是否存在
+     */
+    bool contains(const key_type & _Key) const
+    {
+        return _Find(_Key, nullptr);
+    }
+
+    /**
+     * @brief 获取元素数量
+     * @return 元素数量
+     */
+    size_type size() const noexcept
+    {
+        return _Size;
+    }
+
+    /**
+     * @brief 判断是否为空
+     * @return 是否为空
+     */
+    bool empty() const noexcept
+    {
+        return _Size == 0;
+    }
+
+    /**
+     * @brief 按键的升序访问[_Start, _End)范围内的键值对
+     * @param _Start 起始键（包含），为空时从头开始
+     * @param _End 结束键（不包含），为空时直到末尾
+     * @param _Limit 最多访问的个数
+     * @param _Callback 回调，参数为键和值
+     * @return 访问的个数
+     */
+    template <typename _Fn>
+    size_type scan(const key_type * _Start, const key_type * _End, size_type _Limit, _Fn & _Callback) const
+    {
+        size_type _Count = 0;
+        size_type _Block = _Start == nullptr ? 0 : _Block_of(*_Start);
+
+        key_type _Key = key_type();
+        value_type _Value = value_type();
+        std::uint64_t _Now = _Wall_now();
+
+        for (; _Block < _Index.size() && _Count < _Limit; ++_Block) {
+            _Checkpoint_block_cursor _Cursor = _Open_block(_Block);
+
+            while (_Count < _Limit && _Cursor.next()) {
+                _Decode_key(_Cursor, _Key);
+
+                if (_Start != nullptr && _Comp(_Key, *_Start)) {
+                    continue;
+                }
+
+                if (_End != nullptr && !_Comp(_Key, *_End)) {
+                    return _Count;
+                }
+
+                if (_Cursor.expired(_Now)) {
+                    continue;
+                }
+
+                _Decode_value(_Cursor, _Value);
+                _Callback(static_cast<const key_type &>(_Key), static_cast<const value_type &>(_Value));
+                ++_Count;
+            }
+        }
+
+        return _Count;
+    }
+
+private:
+    /**
+     * @brief 映射文件
+     * @param _Path 文件路径
+     */
+    void _Map(const std::string & _Path)
+    {
+        int _Fd = ::open(_Path.c_str(), O_RDONLY);
+        if (_Fd < 0) {
+            _Throw_system_error("snapshot open");
+        }
+
+        struct stat _Stat;
+        if (::fstat(_Fd, &_Stat) != 0) {
+            int _Code = errno;
+            ::close(_Fd);
+            errno = _Code;
+            _Throw_system_error("snapshot stat");
+        }
+
+        _Mapped_size = static_cast<size_type>(_Stat.st_size);
+        if (_Mapped_size < _Checkpoint_format::FOOTER_SIZE + _Checkpoint_format::CHECKSUM_SIZE) {
+            ::close(_Fd);
+            _Checkpoint_format::throw_corrupted();
+        }
+
+        void * _Address = ::mmap(nullptr, _Mapped_size, PROT_READ, MAP_SHARED, _Fd, 0);
+        int _Code = errno;
+
+        // 映射建立后文件描述符不再需要
+        ::close(_Fd);
+
+        if (_Address == MAP_FAILED) {
+            errno = _Code;
+            _Throw_system_error("snapshot mmap");
+        }
+
+        _Data = static_cast<const char *>(_Address);
+    }
+
+    /**
+     * @brief 读取尾部和索引块，并反序列化每个数据块的第一个键
+     */
+    void _Read_index()
+    {
+        _Checkpoint_format::footer _Footer = _Checkpoint_format::decode_footer(
+            _Data + _Mapped_size - _Checkpoint_format::FOOTER_SIZE, _Mapped_size);
+
+        _Index = _Checkpoint_format::decode_index(_Data + _Footer._Index_offset,
+                                                  static_cast<size_type>(_Footer._Index_size),
+                                                  _Footer._Index_offset);
+        _Size = static_cast<size_type>(_Footer._Count);
+
+        _First_keys.reserve(_Index.size());
+        for (const _Block_handle & _Handle : _Index) {
+            key_type _Key = key_type();
+            const char * _First = _Handle._First_key.data();
+            const char * _Last = _First + _Handle._First_key.size();
+
+            if (!_Key_codec<key_type>::decode(_First, _Last, _Key) || _First != _Last) {
+                _Checkpoint_format::throw_corrupted();
+            }
+
+            _First_keys.push_back(std::move(_Key));
+        }
+
+        _Verified.reset(new std::atomic<bool>[_Index.size()]);
+        for (size_type _Block = 0; _Block < _Index.size(); ++_Block) {
+            _Verified[_Block].store(false, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief 计算可能包含键的数据块
+     * @param _Key 键
+     * @return 数据块下标，键小于所有键时为0
+     */
+    size_type _Block_of(const key_type & _Key) const
+    {
+        // 第一个首键大于目标键的数据块的前一个
+        auto _It = std::upper_bound(_First_keys.begin(), _First_keys.end(), _Key, _Comp);
+        return _It == _First_keys.begin() ? 0 : static_cast<size_type>(_It - _First_keys.begin() - 1);
+    }
+
+    /**
+     * @brief 打开一个数据块，第一次访问时校验
+     * @param _Block 数据块下标
+     * @return 数据块游标
+     */
+    _Checkpoint_block_cursor _Open_block(size_type _Block) const
+    {
+        const _Block_handle & _Handle = _Index[_Block];
+        const char * _First = _Data + _Handle._Offset;
+        size_type _Size = static_cast<size_type>(_Handle._Size);
+
+        if (!_Verified[_Block].load(std::memory_order_acquire)) {
+            // 多个线程可能同时校验同一个数据块，结果相同，不需要互斥
+            if (!_Checkpoint_format::verify(_First, _Size)) {
+                _Checkpoint_format::throw_corrupted();
+            }
+            _Verified[_Block].store(true, std::memory_order_release);
+        }
+
+        return _Checkpoint_block_cursor(_First, _First + _Size);
+    }
+
+    /**
+     * @brief 查找键
+     * @param _Key 键
+     * @param _Value 用于接收值，为空时只判断是否存在
+     * @return 是否存在
+     */
+    bool _Find(const key_type & _Key, value_type * _Value) const
+    {
+        if (_Index.empty() || _Comp(_Key, _First_keys.front())) {
+            return false;
+        }
+
+        _Checkpoint_block_cursor _Cursor = _Open_block(_Block_of(_Key));
+        key_type _Cur = key_type();
+
+        while (_Cursor.next()) {
+            _Decode_key(_Cursor, _Cur);
+
+            if (!_Comp(_Cur, _Key)) {
+                if (_Comp(_Key, _Cur) || _Cursor.expired(_Wall_now())) {
+                    return false;
+                }
+
+                if (_Value != nullptr) {
+                    _Decode_value(_Cursor, *_Value);
+                }
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    /**
+     * @brief 反序列化游标当前的键
+     * @param _Cursor 游标
+     * @param _Key 用于接收键
+     */
+    static void _Decode_key(const _Checkpoint_block_cursor & _Cursor, key_type & _Key)
+    {
+        const char * _First = _Cursor.key().data();
+        const char * _Last = _First + _Cursor.key().size();
+
+        if (!_Key_codec<key_type>::decode(_First, _Last, _Key) || _First != _Last) {
+            _Checkpoint_format::throw_corrupted();
+        }
+    }
+
+    /**
+     * @brief 反序列化游标当前的值
+     * @param _Cursor 游标
+     * @param _Value 用于接收值
+     */
+    static void _Decode_value(const _Checkpoint_block_cursor & _Cursor, value_type & _Value)
+    {
+        const char * _First = _Cursor.value_data();
+        const char * _Last = _First + _Cursor.value_size();
+
+        if (!_Codec<value_type>::decode(_First, _Last, _Value) || _First != _Last) {
+            _Checkpoint_format::throw_corrupted();
+        }
+    }
+
+    /**
+     * @brief 根据errno抛出异常
+     * @param _What 描述
+     */
+    [[noreturn]] static void _Throw_system_error(const char * _What)
+    {
+        throw std::system_error(errno, std::generic_category(), _What);
+    }
+};
+
+} // namespace WW
@@ -0,0 +1,357 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+
+namespace WW
+{
+
+/**
+ * @brief 分级内存池
+ * @details 按`GRANULARITY`字节将小块内存划分为多个大小等级，每个等级维护一个空闲链表，
+ * 空闲链表为空时从当前内存页中顺序切分，内存页用尽时再向系统申请新的内存页。
+ * 超过`MAX_BLOCK_SIZE`的请求直接交给全局`operator new`，并在前面加上头部串成双向链表，
+ * `release`时一并释放。内存池不是线程安全的
+ */
+class _Pool_resource
+{
+public:
+    using size_type = std::size_t;
+
+    static constexpr size_type GRANULARITY = alignof(std::max_align_t);    // 大小等级粒度
+    static constexpr size_type MAX_BLOCK_SIZE = 512;                        // 由内存池管理的最大块大小
+    static constexpr size_type CHUNK_SIZE = 64 * 1024;                      // 内存页大小
+    static constexpr size_type CLASS_COUNT = MAX_BLOCK_SIZE / GRANULARITY;  // 大小等级个数
+
+private:
+    /**
+     * @brief 空闲块，复用被释放内存的前几个字节
+     */
+    struct _Free_block
+    {
+        _Free_block * _Next;
+    };
+
+    /**
+     * @brief 内存页头部，内存页通过它串成链表
+     */
+    struct alignas(std::max_align_t) _Chunk_header
+    {
+        _Chunk_header * _Next;
+    };
+
+    /**
+     * @brief 大块内存头部，大块内存通过它串成双向链表，单独释放时可以直接摘除
+     */
+    struct alignas(std::max_align_t) _Large_header
+    {
+        _Large_header * _Prev;
+        _Large_header * _Next;
+    };
+
+    _Free_block * _Free_list[CLASS_COUNT];  // 各大小等级的空闲链表
+    _Chunk_header * _Chunks;                // 内存页链表
+    _Large_header * _Large_blocks;          // 大块内存链表
+    char * _Cursor;                         // 当前内存页中未切分部分的起始位置
+    char * _Chunk_end;                      // 当前内存页的末尾
+    size_type _Chunk_count;                 // 内存页个数
+    size_type _Large_count;                 // 大块内存个数
+    size_type _Bytes_in_use;                // 已分配给使用者的字节数
+
+public:
+    _Pool_resource() noexcept
+        : _Free_list()
+        , _Chunks(nullptr)
+        , _Large_blocks(nullptr)
+        , _Cursor(nullptr)
+        , _Chunk_end(nullptr)
+        , _Chunk_count(0)
+        , _Large_count(0)
+        , _Bytes_in_use(0)
+    {
+    }
+
+    _Pool_resource(const _Pool_resource &) = delete;
+
+    _Pool_resource & operator=(const _Pool_resource &) = delete;
+
+    ~_Pool_resource()
+    {
+        release();
+    }
+
+public:
+    /**
+     * @brief 分配内存
+     * @param _Bytes 字节数
+     * @return 内存地址
+     */
+    void * allocate(size_type _Bytes)
+    {
+        if (_Bytes > MAX_BLOCK_SIZE) {
+            return _Allocate_large(_Bytes);
+        }
+
+        size_type _Index = _Class_index(_Bytes);
+        size_type _Block_size = (_Index + 1) * GRANULARITY;
+        _Bytes_in_use += _Block_size;
+
+        // 优先复用空闲块
+        _Free_block * _Block = _Free_list[_Index];
+        if (_Block != nullptr) {
+            _Free_list[_Index] = _Block->_Next;
+            return _Block;
+        }
+
+        // 当前内存页剩余空间不足，申请新的内存页
+        if (static_cast<size_type>(_Chunk_end - _Cursor) < _Block_size) {
+            _Allocate_chunk();
+        }
+
+        void * _Memory = _Cursor;
+        _Cursor += _Block_size;
+        return _Memory;
+    }
+
+    /**
+     * @brief 释放内存
+     * @param _Ptr 内存地址
+     * @param _Bytes 分配时的字节数
+     */
+    void deallocate(void * _Ptr, size_type _Bytes) noexcept
+    {
+        if (_Bytes > MAX_BLOCK_SIZE) {
+            _Deallocate_large(_Ptr);
+            return;
+        }
+
+        size_type _Index = _Class_index(_Bytes);
+        _Bytes_in_use -= (_Index + 1) * GRANULARITY;
+
+        // 放回对应大小等级的空闲链表
+        _Free_block * _Block = static_cast<_Free_block *>(_Ptr);
+        _Block->_Next = _Free_list[_Index];
+        _Free_list[_Index] = _Block;
+    }
+
+    /**
+     * @brief 一次性释放所有内存页和大块内存
+     * @details 调用后所有由内存池分配的内存全部失效，使用者需要保证不再访问它们
+     */
+    void release() noexcept
+    {
+        while (_Chunks != nullptr) {
+            _Chunk_header * _Next = _Chunks->_Next;
+            ::operator delete(_Chunks);
+            _Chunks = _Next;
+        }
+
+        while (_Large_blocks != nullptr) {
+            _Large_header * _Next = _Large_blocks->_Next;
+            ::operator delete(_Large_blocks);
+            _Large_blocks = _Next;
+        }
+
+        for (size_type _Index = 0; _Index < CLASS_COUNT; ++_Index) {
+            _Free_list[_Index] = nullptr;
+        }
+
+        _Cursor = nullptr;
+        _Chunk_end = nullptr;
+        _Chunk_count = 0;
+        _Large_count = 0;
+        _Bytes_in_use = 0;
+    }
+
+    /**
+     * @brief 获取内存页个数
+     * @return 内存页个数
+     */
+    size_type chunk_count() const noexcept
+    {
+        return _Chunk_count;
+    }
+
+    /**
+     * @brief 获取未释放的大块内存个数
+     * @return 大块内存个数
+     */
+    size_type large_block_count() const noexcept
+    {
+        return _Large_count;
+    }
+
+    /**
+     * @brief 获取已分配给使用者的字节数，不包括直接交给`operator new`的大块内存
+     * @return 字节数
+     */
+    size_type bytes_in_use() const noexcept
+    {
+        return _Bytes_in_use;
+    }
+
+private:
+    /**
+     * @brief 计算字节数对应的大小等级
+     * @param _Bytes 字节数
+     * @return 大小等级下标
+     */
+    static size_type _Class_index(size_type _Bytes) noexcept
+    {
+        return _Bytes == 0 ? 0 : (_Bytes - 1) / GRANULARITY;
+    }
+
+    /**
+     * @brief 分配大块内存并挂到大块内存链表的头部
+     * @param _Bytes 字节数
+     * @return 头部之后的内存地址
+     */
+    void * _Allocate_large(size_type _Bytes)
+    {
+        _Large_header * _Block = static_cast<_Large_header *>(::operator new(sizeof(_Large_header) + _Bytes));
+        _Block->_Prev = nullptr;
+        _Block->_Next = _Large_blocks;
+        if (_Large_blocks != nullptr) {
+            _Large_blocks->_Prev = _Block;
+        }
+        _Large_blocks = _Block;
+        ++_Large_count;
+
+        return _Block + 1;
+    }
+
+    /**
+     * @brief 从大块内存链表中摘除并释放大块内存
+     * @param _Ptr `_Allocate_large`返回的内存地址
+     */
+    void _Deallocate_large(void * _Ptr) noexcept
+    {
+        _Large_header * _Block = static_cast<_Large_header *>(_Ptr) - 1;
+        if (_Block->_Prev != nullptr) {
+            _Block->_Prev->_Next = _Block->_Next;
+        } else {
+            _Large_blocks = _Block->_Next;
+        }
+
+        if (_Block->_Next != nullptr) {
+            _Block->_Next->_Prev = _Block->_Prev;
+        }
+
+        --_Large_count;
+        ::operator delete(_Block);
+    }
+
+    /**
+     * @brief 申请一个新的内存页，旧内存页的剩余部分被丢弃
+     */
+    void _Allocate_chunk()
+    {
+        _Chunk_header * _Chunk = static_cast<_Chunk_header *>(::operator new(CHUNK_SIZE));
+        _Chunk->_Next = _Chunks;
+        _Chunks = _Chunk;
+        ++_Chunk_count;
+
+        _Cursor = reinterpret_cast<char *>(_Chunk) + sizeof(_Chunk_header);
+        _Chunk_end = reinterpret_cast<char *>(_Chunk) + CHUNK_SIZE;
+    }
+};
+
+/**
+ * @brief 基于分级内存池的分配器
+ * @details 满足标准分配器要求，拷贝和重绑定得到的分配器共享同一个内存池，
+ * 默认构造的分配器拥有一个独立的内存池
+ * @tparam _Ty 元素类型
+ */
+template <typename _Ty>
+class _Pool_allocator
+{
+public:
+    using value_type = _Ty;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using resource_type = _Pool_resource;
+
+    static_assert(alignof(_Ty) <= alignof(std::max_align_t), "over-aligned types are not supported");
+
+private:
+    // 允许不同元素类型的分配器共享内存池
+    template <typename _Other>
+    friend class _Pool_allocator;
+
+    std::shared_ptr<resource_type> _Resource;   // 内存池
+
+public:
+    _Pool_allocator()
+        : _Resource(std::make_shared<resource_type>())
+    {
+    }
+
+    template <typename _Other>
+    _Pool_allocator(const _Pool_allocator<_Other> & _Other_alloc) noexcept
+        : _Resource(_Other_alloc._Resource)
+    {
+    }
+
+public:
+    /**
+     * @brief 分配能容纳`_Count`个元素的内存
+     * @param _Count 元素个数
+     * @return 内存地址
+     */
+    _Ty * allocate(size_type _Count)
+    {
+        return static_cast<_Ty *>(_Resource->allocate(_Count * sizeof(_Ty)));
+    }
+
+    /**
+     * @brief 释放内存
+     * @param _Ptr 内存地址
+     * @param _Count 元素个数
+     */
+    void deallocate(_Ty * _Ptr, size_type _Count) noexcept
+    {
+        _Resource->deallocate(_Ptr, _Count * sizeof(_Ty));
+    }
+
+    /**
+     * @brief 一次性释放内存池中的所有内存
+     */
+    void release() noexcept
+    {
+        _Resource->release();
+    }
+
+    /**
+     * @brief 判断内存池是否只被当前分配器使用
+     * @details 只有独占内存池时，容器才能安全地调用`release`批量释放
+     * @return 是否独占
+     */
+    bool exclusive() const noexcept
+    {
+        return _Resource.use_count() == 1;
+    }
+
+    /**
+     * @brief 获取内存池
+     * @return 内存池
+     */
+    const resource_type & resource() const noexcept
+    {
+        return *_Resource;
+    }
+
+    template <typename _Other>
+    bool operator==(const _Pool_allocator<_Other> & _Other_alloc) const noexcept
+    {
+        return _Resource == _Other_alloc._Resource;
+    }
+
+    template <typename _Other>
+    bool operator!=(const _Pool_allocator<_Other> & _Other_alloc) const noexcept
+    {
+        return !(*this == _Other_alloc);
+    }
+};
+
+} // namespace WW
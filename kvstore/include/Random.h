@@ -0,0 +1,211 @@
+#pragma once
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+
+namespace WW
+{
+
+/**
+ * @brief 计算64位整数末尾0的个数
+ * @param _Word 整数，不能为0
+ * @return 末尾0的个数
+ */
+inline int _Count_trailing_zeros(std::uint64_t _Word) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(_Word);
+#else
+    // De Bruijn序列，先取出最低位的1
+    static const int _Table[64] = {
+        0, 1, 48, 2, 57, 49, 28, 3, 61, 58, 50, 42, 38, 29, 17, 4,
+        62, 55, 59, 36, 53, 51, 43, 22, 45, 39, 33, 30, 24, 18, 12, 5,
+        63, 47, 56, 27, 60, 41, 37, 16, 54, 35, 52, 21, 44, 32, 23, 11,
+        46, 26, 40, 15, 34, 20, 31, 10, 25, 14, 19, 9, 13, 8, 7, 6
+    };
+    return _Table[((_Word & (0 - _Word)) * 0x03F79D71B4CB0A89ull) >> 58];
+#endif
+}
+
+/**
+ * @brief xorshift64*随机数生成器
+ * @details 状态只有一个64位整数，每次生成只需要三次移位异或和一次乘法。
+ * 每个线程通过`local`使用各自的实例，不同线程之间没有任何共享状态
+ */
+class _Xorshift_random
+{
+public:
+    using result_type = std::uint64_t;
+
+private:
+    result_type _State;     // 状态，不能为0
+
+public:
+    explicit _Xorshift_random(result_type _Seed) noexcept
+        : _State(0)
+    {
+        seed(_Seed);
+    }
+
+public:
+    /**
+     * @brief 获取当前线程的生成器
+     * @details 首次使用时以时钟和线程局部变量的地址播种，不同线程得到不同的序列，且不会抛出异常
+     * @return 生成器
+     */
+    static _Xorshift_random & local() noexcept
+    {
+        static thread_local result_type _Anchor = 0;
+        static thread_local _Xorshift_random _Instance(
+            static_cast<result_type>(std::chrono::steady_clock::now().time_since_epoch().count())
+            ^ static_cast<result_type>(reinterpret_cast<std::uintptr_t>(&_Anchor)));
+        return _Instance;
+    }
+
+    /**
+     * @brief 重新播种
+     * @details 种子先经过splitmix64混合，任何种子（包括0）都能得到非0且分布良好的状态
+     * @param _Seed 种子
+     */
+    void seed(result_type _Seed) noexcept
+    {
+        _Seed += 0x9E3779B97F4A7C15ull;
+        _Seed = (_Seed ^ (_Seed >> 30)) * 0xBF58476D1CE4E5B9ull;
+        _Seed = (_Seed ^ (_Seed >> 27)) * 0x94D049BB133111EBull;
+        _Seed ^= _Seed >> 31;
+
+        _State = _Seed == 0 ? 0x9E3779B97F4A7C15ull : _Seed;
+    }
+
+    /**
+     * @brief 生成一个随机数
+     * @return 随机数
+     */
+    result_type operator()() noexcept
+    {
+        _State ^= _State >> 12;
+        _State ^= _State << 25;
+        _State ^= _State >> 27;
+        return _State * 0x2545F4914F6CDD1Dull;
+    }
+};
+
+/**
+ * @brief 为当前线程的层级生成器播种
+ * @details 跳表的节点层级由线程局部的生成器决定，在同一个线程中以相同的种子和相同的操作序列，
+ * 可以得到完全相同的跳表形状，用于可复现的基准测试
+ * @param _Seed 种子
+ */
+inline void seed_level_random(std::uint64_t _Seed)
+{
+    _Xorshift_random::local().seed(_Seed);
+}
+
+/**
+ * @brief 跳表的层级分布
+ * @details 节点以概率p晋升到上一层，层级索引服从几何分布，每个节点平均有1/(1-p)个链接。
+ * p越小节点越省内存，查找路径越长。p为1/2^k时由一个随机数末尾0的个数除以k得到层级，
+ * 其他p由一个均匀随机数取对数得到，两种方式都只消耗一个随机数
+ */
+class level_distribution
+{
+private:
+    double _Probability;        // 晋升概率
+    int _Shift;                 // p为1/2^k时为k，否则为0
+    double _Inverse_log;        // 1/ln(p)
+
+public:
+    /**
+     * @brief 构造层级分布
+     * @param _P 晋升概率，限制在[1/65536, 15/16]之间
+     */
+    explicit level_distribution(double _P = 0.5) noexcept
+        : _Probability(_P < 1.0 / 65536 ? 1.0 / 65536 : (_P > 15.0 / 16 ? 15.0 / 16 : _P))
+        , _Shift(0)
+        , _Inverse_log(1.0 / std::log(_Probability))
+    {
+        for (int _K = 1; _K <= 16; ++_K) {
+            if (_Probability == std::ldexp(1.0, -_K)) {
+                _Shift = _K;
+                break;
+            }
+        }
+    }
+
+public:
+    /**
+     * @brief p = 1/2，默认分布
+     */
+    static level_distribution half() noexcept
+    {
+        return level_distribution(0.5);
+    }
+
+    /**
+     * @brief p = 1/4，链接更少，查找路径略长
+     */
+    static level_distribution quarter() noexcept
+    {
+        return level_distribution(0.25);
+    }
+
+    /**
+     * @brief p = 1/e，理论上期望比较次数最少
+     */
+    static level_distribution inverse_e() noexcept
+    {
+        return level_distribution(0.36787944117144233);
+    }
+
+    /**
+     * @brief 获取晋升概率
+     * @return 晋升概率
+     */
+    double probability() const noexcept
+    {
+        return _Probability;
+    }
+
+    /**
+     * @brief 由一个随机数计算层级索引
+     * @param _Word 均匀分布的随机数
+     * @param _Max_level_index 最大层级索引
+     * @return 层级索引，范围为[0, _Max_level_index]
+     */
+    int operator()(std::uint64_t _Word, int _Max_level_index) const noexcept
+    {
+        int _Level = 0;
+
+        if (_Shift != 0) {
+            // 置上最高位，保证不为0
+            _Level = _Count_trailing_zeros(_Word | (1ull << 63)) / _Shift;
+        } else {
+            // 取高53位构造(0, 1]上的均匀分布，P(-ln(u)/-ln(p) >= k) = p^k
+            double _Uniform = static_cast<double>((_Word >> 11) + 1) * (1.0 / 9007199254740992.0);
+            double _Scaled = std::log(_Uniform) * _Inverse_log;
+            _Level = _Scaled < _Max_level_index ? static_cast<int>(_Scaled) : _Max_level_index;
+        }
+
+        return _Level < _Max_level_index ? _Level : _Max_level_index;
+    }
+
+    /**
+     * @brief 按序号计算批量构建时的层级索引
+     * @details p为1/2^k时取序号末尾0的个数除以k，得到期望形状，否则返回-1表示需要随机生成
+     * @param _Sequence 序号，从1开始
+     * @param _Max_level_index 最大层级索引
+     * @return 层级索引
+     */
+    int sequence_level(std::uint64_t _Sequence, int _Max_level_index) const noexcept
+    {
+        if (_Shift == 0) {
+            return -1;
+        }
+
+        int _Level = _Count_trailing_zeros(_Sequence | (1ull << 63)) / _Shift;
+        return _Level < _Max_level_index ? _Level : _Max_level_index;
+    }
+};
+
+} // namespace WW
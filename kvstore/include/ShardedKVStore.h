@@ -0,0 +1,338 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <utility>
+#include <vector>
+
+#include <SkipList.h>
+
+namespace WW
+{
+
+/**
+ * @brief 分片KV储存
+ * @details 按键的哈希值将键值对划分到多个相互独立的跳表中，每个分片有自己的读写锁，
+ * 单键操作只会锁住一个分片。有序遍历和范围查询对所有分片加读锁后做k路归并
+ * @tparam _Key 键类型
+ * @tparam _Value 值类型
+ * @tparam _Hash 哈希函数类型
+ * @tparam _Alloc 分配器类型，每个分片默认构造一个独立的分配器。
+ * 分配器的状态只受所在分片的锁保护，例如`_Pool_allocator`的各分片各自拥有一个内存池
+ */
+template <
+    typename _Ty_key,
+    typename _Ty_value,
+    typename _Ty_hash = std::hash<_Ty_key>,
+    typename _Ty_alloc = std::allocator<std::pair<const _Ty_key, _Ty_value>>
+> class ShardedKVStore
+{
+public:
+    using key_type = _Ty_key;
+    using value_type = _Ty_value;
+    using pair_type = std::pair<const _Ty_key, _Ty_value>;
+    using size_type = std::size_t;
+    using hasher = _Ty_hash;
+    using allocator_type = _Ty_alloc;
+    using skiplist_type = _Skiplist<key_type, value_type, std::less<key_type>, allocator_type>;
+
+    static constexpr size_type DEFAULT_SHARD_COUNT = 16;   // 默认分片个数
+
+private:
+    using _Const_iterator = typename skiplist_type::const_iterator;
+
+    /**
+     * @brief 分片，独占缓存行，避免相邻分片的锁产生伪共享
+     */
+    struct alignas(64) _Shard
+    {
+        mutable std::shared_mutex _Mutex;       // 读写锁
+        skiplist_type _Skiplist;                // 跳表，分配器不与其他分片共享
+    };
+
+    /**
+     * @brief 归并时每个分片的游标
+     */
+    struct _Cursor
+    {
+        _Const_iterator _Cur;
+        _Const_iterator _End;
+    };
+
+    std::vector<std::unique_ptr<_Shard>> _Shards;  // 分片
+    hasher _Hasher;                                 // 哈希函数
+
+public:
+    ShardedKVStore()
+        : ShardedKVStore(DEFAULT_SHARD_COUNT)
+    {
+    }
+
+    explicit ShardedKVStore(size_type _Shard_count, const hasher & _Hash = hasher())
+        : _Shards()
+        , _Hasher(_Hash)
+    {
+        if (_Shard_count == 0) {
+            _Shard_count = 1;
+        }
+
+        _Shards.reserve(_Shard_count);
+        for (size_type _Index = 0; _Index < _Shard_count; ++_Index) {
+            _Shards.emplace_back(new _Shard());
+        }
+    }
+
+    ShardedKVStore(const ShardedKVStore &) = delete;
+
+    ShardedKVStore & operator=(const ShardedKVStore &) = delete;
+
+    ~ShardedKVStore() = default;
+
+public:
+    /**
+     * @brief 获取值
+     * @param _Key 键
+     * @return 值，不存在时为空
+     */
+    std::optional<value_type> get(const key_type & _Key) const
+    {
+        const _Shard & _Target = _Shard_of(_Key);
+        std::shared_lock<std::shared_mutex> _Lock(_Target._Mutex);
+
+        auto _It = _Target._Skiplist.find(_Key);
+        if (_It == _Target._Skiplist.end()) {
+            return std::nullopt;
+        }
+
+        return _It->second;
+    }
+
+    /**
+     * @brief 获取值，不存在时返回给定的默认值
+     * @param _Key 键
+     * @param _Default 默认值
+     * @return 值
+     */
+    value_type get_or_default(const key_type & _Key, const value_type & _Default = value_type()) const
+    {
+        const _Shard & _Target = _Shard_of(_Key);
+        std::shared_lock<std::shared_mutex> _Lock(_Target._Mutex);
+
+        auto _It = _Target._Skiplist.find(_Key);
+        return _It == _Target._Skiplist.end() ? _Default : _It->second;
+    }
+
+    /**
+     * @brief 获取值并赋值给已有对象，可以复用对象已经持有的内存
+     * @param _Key 键
+     * @param _Value 用于接收值，不存在时不修改
+     * @return 是否存在
+     */
+    bool get_into(const key_type & _Key, value_type & _Value) const
+    {
+        const _Shard & _Target = _Shard_of(_Key);
+        std::shared_lock<std::shared_mutex> _Lock(_Target._Mutex);
+
+        auto _It = _Target._Skiplist.find(_Key);
+        if (_It == _Target._Skiplist.end()) {
+            return false;
+        }
+
+        _Value = _It->second;
+        return true;
+    }
+
+    /**
+     * @brief 插入键值对
+     * @param _Key 键
+     * @param _Value 值
+     * @return 是否插入成功
+     */
+    bool put(const key_type & _Key, const value_type & _Value)
+    {
+        _Shard & _Target = _Shard_of(_Key);
+        std::unique_lock<std::shared_mutex> _Lock(_Target._Mutex);
+
+        return _Target._Skiplist.insert(pair_type(_Key, _Value)).second;
+    }
+
+    /**
+     * @brief 更新键值对，不存在时插入
+     * @param _Key 键
+     * @param _Value 值
+     * @return 是否更新成功
+     */
+    bool update(const key_type & _Key, const value_type & _Value)
+    {
+        _Shard & _Target = _Shard_of(_Key);
+        std::unique_lock<std::shared_mutex> _Lock(_Target._Mutex);
+
+        _Target._Skiplist.insert_or_assign(_Key, _Value);
+        return true;
+    }
+
+    /**
+     * @brief 删除键值对
+     * @param _Key 键
+     * @return 是否删除成功
+     */
+    bool remove(const key_type & _Key)
+    {
+        _Shard & _Target = _Shard_of(_Key);
+        std::unique_lock<std::shared_mutex> _Lock(_Target._Mutex);
+
+        return _Target._Skiplist.erase(_Key) != 0;
+    }
+
+    /**
+     * @brief 查询键是否存在
+     * @param _Key 键
+     * @return 是否存在
+     */
+    bool contains(const key_type & _Key) const
+    {
+        const _Shard & _Target = _Shard_of(_Key);
+        std::shared_lock<std::shared_mutex> _Lock(_Target._Mutex);
+
+        return _Target._Skiplist.contains(_Key);
+    }
+
+    /**
+     * @brief 获取元素数量
+     * @details 逐个分片累加，并发修改时只是一个近似值
+     * @return 元素数量
+     */
+    size_type size() const
+    {
+        size_type _Size = 0;
+
+        for (const auto & _Shard_ptr : _Shards) {
+            std::shared_lock<std::shared_mutex> _Lock(_Shard_ptr->_Mutex);
+            _Size += _Shard_ptr->_Skiplist.size();
+        }
+
+        return _Size;
+    }
+
+    /**
+     * @brief 判断是否为空
+     * @return 是否为空
+     */
+    bool empty() const
+    {
+        return size() == 0;
+    }
+
+    /**
+     * @brief 获取分片个数
+     * @return 分片个数
+     */
+    size_type shard_count() const noexcept
+    {
+        return _Shards.size();
+    }
+
+    /**
+     * @brief 按键的升序遍历所有键值对
+     * @details 遍历期间持有所有分片的读锁，回调中不能修改当前储存
+     * @param _Callback 回调，参数为键和值
+     */
+    template <typename _Fn>
+    void for_each(_Fn _Callback) const
+    {
+        _Merge(nullptr, nullptr, static_cast<size_type>(-1), _Callback);
+    }
+
+    /**
+     * @brief 按键的升序访问[_Start, _End)范围内的键值对
+     * @details 遍历期间持有所有分片的读锁，回调中不能修改当前储存
+     * @param _Start 起始键（包含）
+     * @param _End 结束键（不包含）
+     * @param _Limit 最多访问的个数
+     * @param _Callback 回调，参数为键和值
+     * @return 访问的个数
+     */
+    template <typename _Fn>
+    size_type scan(const key_type & _Start, const key_type & _End, size_type _Limit, _Fn _Callback) const
+    {
+        return _Merge(&_Start, &_End, _Limit, _Callback);
+    }
+
+private:
+    /**
+     * @brief 计算键所属的分片
+     * @param _Key 键
+     * @return 分片
+     */
+    _Shard & _Shard_of(const key_type & _Key) const
+    {
+        // 对哈希值再做一次混合，避免整数键的恒等哈希只落在少数分片上
+        std::uint64_t _Hash = static_cast<std::uint64_t>(_Hasher(_Key)) * 0x9E3779B97F4A7C15ull;
+        return *_Shards[(_Hash >> 32) % _Shards.size()];
+    }
+
+    /**
+     * @brief 对所有分片做k路归并
+     * @param _Start 起始键，为空时从头开始
+     * @param _End 结束键，为空时直到末尾
+     * @param _Limit 最多访问的个数
+     * @param _Callback 回调
+     * @return 访问的个数
+     */
+    template <typename _Fn>
+    size_type _Merge(const key_type * _Start, const key_type * _End, size_type _Limit, _Fn & _Callback) const
+    {
+        // 按分片下标顺序加读锁，与单键操作不会形成环
+        std::vector<std::shared_lock<std::shared_mutex>> _Locks;
+        _Locks.reserve(_Shards.size());
+
+        std::vector<_Cursor> _Heap;
+        _Heap.reserve(_Shards.size());
+
+        for (const auto & _Shard_ptr : _Shards) {
+            _Locks.emplace_back(_Shard_ptr->_Mutex);
+
+            const skiplist_type & _List = _Shard_ptr->_Skiplist;
+            _Const_iterator _First = _Start == nullptr ? _List.begin() : _List.lower_bound(*_Start);
+            if (_First != _List.end()) {
+                _Heap.push_back(_Cursor{_First, _List.end()});
+            }
+        }
+
+        // 小顶堆，堆顶为当前最小的键
+        auto _Greater = [](const _Cursor & _Left, const _Cursor & _Right) {
+            return _Right._Cur->first < _Left._Cur->first;
+        };
+        std::make_heap(_Heap.begin(), _Heap.end(), _Greater);
+
+        size_type _Count = 0;
+        while (!_Heap.empty() && _Count < _Limit) {
+            std::pop_heap(_Heap.begin(), _Heap.end(), _Greater);
+            _Cursor & _Top = _Heap.back();
+
+            if (_End != nullptr && !(_Top._Cur->first < *_End)) {
+                // 堆顶已经超出范围，其余分片只会更大
+                break;
+            }
+
+            _Callback(_Top._Cur->first, _Top._Cur->second);
+            ++_Count;
+
+            if (++_Top._Cur == _Top._End) {
+                _Heap.pop_back();
+            } else {
+                std::push_heap(_Heap.begin(), _Heap.end(), _Greater);
+            }
+        }
+
+        return _Count;
+    }
+};
+
+} // namespace WW
@@ -1,11 +1,26 @@
 #pragma once
 
-#include <cstdlib>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <stdexcept>
+#include <string>
+#include <tuple>
 #include <utility>
-#include <vector>
 
 #include <Common.h>
+#include <Random.h>
+#include <Stats.h>
+
+#if defined(__AVX2__) || defined(__SSE4_2__)
+#include <immintrin.h>
+#endif
 
 namespace WW
 {
@@ -14,14 +29,87 @@ namespace WW
  * @brief 跳表
  * @tparam _Key 键类型
  * @tparam _Value 值类型
+ * @tparam _Compare 比较器类型
+ * @tparam _Alloc 分配器类型
  */
 template <
     typename _Ty_key,
-    typename _Ty_value
+    typename _Ty_value,
+    typename _Ty_compare,
+    typename _Ty_alloc
 > class _Skiplist;
 
+/**
+ * @brief 节点中缓存的键的表示
+ * @details 默认不缓存。缓存值的顺序必须与键的升序一致：缓存值小于时键一定小于，
+ * `exact`为true时缓存值相等即键相等，否则相等时还要比较完整的键
+ * @tparam _Key 键类型
+ */
+template <typename _Ty_key, typename = void>
+struct _Key_cache
+{
+    static constexpr bool enabled = false;
+    static constexpr bool exact = false;
+    using type = unsigned char;
+
+    static type make(const _Ty_key &) noexcept
+    {
+        return 0;
+    }
+};
+
+/**
+ * @brief 不超过64位的整数键，缓存键本身
+ */
+template <typename _Ty_key>
+struct _Key_cache<_Ty_key, typename std::enable_if<std::is_integral<_Ty_key>::value && !std::is_same<_Ty_key, bool>::value
+                                                   && sizeof(_Ty_key) <= sizeof(std::uint64_t)>::type>
+{
+    static constexpr bool enabled = true;
+    static constexpr bool exact = true;
+    using type = _Ty_key;
+
+    static type make(_Ty_key _Key) noexcept
+    {
+        return _Key;
+    }
+};
+
+/**
+ * @brief 字符串键，缓存前8个字节按大端序组成的整数，不足8个字节时以0补齐
+ * @details 与`std::string`的比较一样按无符号字节比较，前缀不同时一次整数比较即可得到结果，
+ * 不必访问字符串在堆上的缓冲区
+ */
+template <>
+struct _Key_cache<std::string>
+{
+    static constexpr bool enabled = true;
+    static constexpr bool exact = false;
+    using type = std::uint64_t;
+
+    static type make(const std::string & _Key) noexcept
+    {
+        unsigned char _Bytes[8] = {};
+        std::memcpy(_Bytes, _Key.data(), _Key.size() < 8 ? _Key.size() : 8);
+
+        type _Prefix = 0;
+        for (unsigned char _Byte : _Bytes) {
+            _Prefix = (_Prefix << 8) | _Byte;
+        }
+        return _Prefix;
+    }
+};
+
 /**
  * @brief 跳表节点
+ * @details 向前数组以柔性数组的形式紧跟在键值对之后，与键值对位于同一块内存中，
+ * 节点必须通过`_Skiplist`按`allocation_size`分配内存后原地构造。
+ * 第0层另有一个向后指针，第一个节点的向后指针为空，头节点的向后指针指向最后一个节点。
+ * 每一层的链接同时记录跨度，即沿第0层到达向前节点需要的步数，只有向前节点不为空时跨度才有意义。
+ * 层级之后的对齐填充中存放一个32位的访问标记，跳表本身不使用，供上层记录访问时间或频率。
+ * 键为不超过64位的整数或字符串时，向前数组之后紧跟第1层及以上每一层向前节点的键的缓存值（见`_Key_cache`），
+ * 没有向前节点时为最大值，查找时在上层不必为了比较而访问向前节点，整数键还可以一次比较多层。第0层不缓存，
+ * 一半的节点只有第0层，不增加它们的大小，而第0层的向前节点通常正是要找的节点，无论如何都要访问
  * @tparam _Key 键类型
  * @tparam _Value 值类型
  */
@@ -34,33 +122,95 @@ public:
     using key_type = _Ty_key;
     using value_type = _Ty_value;
     using pair_type = std::pair<const _Ty_key, _Ty_value>;
+    using size_type = std::size_t;
     using level_type = int;
     using node_pointer = _Skip_list_node<_Ty_key, _Ty_value> *;
 
+    using cache_traits = _Key_cache<_Ty_key>;
+    using cache_type = typename cache_traits::type;
+
+    /**
+     * @brief 是否在节点中缓存向前节点的键
+     */
+    static constexpr bool caches_keys = cache_traits::enabled;
+
+    /**
+     * @brief 节点内存的分配单位，分配器以它为元素类型分配节点
+     */
+    struct alignas(alignof(pair_type) > alignof(node_pointer) ? alignof(pair_type) : alignof(node_pointer)) storage_type
+    {
+        unsigned char _Bytes[sizeof(node_pointer)];
+    };
+
 private:
+    /**
+     * @brief 某一层的链接
+     */
+    struct _Link
+    {
+        node_pointer _Next;                 // 向前节点
+        size_type _Span;                    // 跨度
+    };
+
     pair_type _Data;                        // 键值对
-    std::vector<node_pointer> _Forward;     // 向前数组
+    node_pointer _Backward;                 // 第0层的向后指针
+    level_type _Level;                      // 层级
+    mutable std::uint32_t _Mark;            // 访问标记，占用层级之后的对齐填充
+    _Link _Forward[1];                      // 向前数组，实际长度为_Level + 1
 
 public:
-    _Skip_list_node()
-        : _Skip_list_node(pair_type(), 0)
+    /**
+     * @brief 构造节点
+     * @param _Level 层级
+     * @param _Arguments 键值对的构造参数，为空时默认构造
+     */
+    template <typename... _Args>
+    explicit _Skip_list_node(level_type _Level, _Args &&... _Arguments)
+        : _Data(std::forward<_Args>(_Arguments)...)
+        , _Backward(nullptr)
+        , _Level(_Level)
+        , _Mark(0)
     {
+        for (level_type _Index = 0; _Index <= _Level; ++_Index) {
+            _Forward[_Index]._Next = nullptr;
+            _Forward[_Index]._Span = 0;
+        }
+
+        if constexpr (caches_keys) {
+            for (level_type _Index = 0; _Index < _Level; ++_Index) {
+                _Upper_keys()[_Index] = (std::numeric_limits<cache_type>::max)();
+            }
+        }
     }
 
-    explicit _Skip_list_node(level_type _Level)
-        : _Skip_list_node(pair_type(), _Level)
+    _Skip_list_node(const _Skip_list_node &) = delete;
+
+    _Skip_list_node & operator=(const _Skip_list_node &) = delete;
+
+    ~_Skip_list_node() = default;
+
+public:
+    /**
+     * @brief 计算指定层级的节点所需的内存大小
+     * @param _Level 层级
+     * @return 字节数
+     */
+    static constexpr size_type allocation_size(level_type _Level) noexcept
     {
+        // 自身已经包含了第0层的链接
+        return sizeof(_Skip_list_node) + _Level * sizeof(_Link) + (caches_keys ? _Level * sizeof(cache_type) : 0);
     }
 
-    _Skip_list_node(const pair_type & _Pair, level_type _Level)
-        : _Data(_Pair)
-        , _Forward(_Level + 1, nullptr)
+    /**
+     * @brief 计算指定层级的节点所需的分配单位个数
+     * @param _Level 层级
+     * @return 分配单位个数
+     */
+    static constexpr size_type allocation_units(level_type _Level) noexcept
     {
+        return (allocation_size(_Level) + sizeof(storage_type) - 1) / sizeof(storage_type);
     }
 
-    ~_Skip_list_node() = default;
-
-public:
     /**
      * @brief 获取键值对
      * @return 键值对
@@ -74,9 +224,9 @@ public:
      * @brief 获取层级
      * @return 层级
      */
-    const level_type level() const noexcept
+    level_type level() const noexcept
     {
-        return _Forward.size() - 1;
+        return _Level;
     }
 
     /**
@@ -86,7 +236,7 @@ public:
      */
     node_pointer & forward(level_type _Level) noexcept
     {
-        return _Forward[_Level];
+        return _Forward[_Level]._Next;
     }
 
     /**
@@ -96,7 +246,146 @@ public:
      */
     const node_pointer & forward(level_type _Level) const noexcept
     {
-        return _Forward[_Level];
+        return _Forward[_Level]._Next;
+    }
+
+    /**
+     * @brief 设置该节点在指定层级的向前节点
+     * @details 修改向前节点必须通过该函数，以同步缓存的键
+     * @param _Level 层级
+     * @param _Next 向前节点
+     */
+    void set_forward(level_type _Level, node_pointer _Next) noexcept
+    {
+        _Forward[_Level]._Next = _Next;
+
+        if constexpr (caches_keys) {
+            if (_Level > 0) {
+                _Upper_keys()[_Level - 1] = _Next == nullptr ? (std::numeric_limits<cache_type>::max)()
+                                                             : cache_traits::make(_Next->_Data.first);
+            }
+        }
+    }
+
+    /**
+     * @brief 计算从第0层到指定层级中，向前节点的键小于给定键的层数
+     * @details 更高层的向前节点不会比低层的更近，满足条件的层级总是从第0层开始连续，
+     * 返回值减1就是查找时应当前进的层级，为0时说明不能再前进。
+     * 只能在缓存了键时调用。上层比较缓存值，缓存值相等且不精确时才访问该层的向前节点比较完整的键，
+     * 64位整数键在支持AVX2或SSE4.2时一次比较多层。上层都不满足时才访问第0层的向前节点
+     * @param _Top 最高层级，不超过节点的层级
+     * @param _Key 键
+     * @param _Cached 键的缓存值
+     * @return 层数，范围为[0, _Top + 1]
+     */
+    level_type levels_before(level_type _Top, const key_type & _Key, cache_type _Cached) const noexcept
+    {
+        // 第_Level层的缓存值位于_Keys[_Level - 1]
+        const cache_type * _Keys = _Upper_keys();
+        level_type _Level = _Top;
+
+#if defined(__AVX2__) || defined(__SSE4_2__)
+        if constexpr (cache_traits::exact && sizeof(cache_type) == 8) {
+            // 有符号比较，无符号的键翻转最高位后顺序不变
+            const long long _Bias = std::is_signed<cache_type>::value ? 0 : (std::numeric_limits<long long>::min)();
+
+#if defined(__AVX2__)
+            const __m256i _Bias_vector = _mm256_set1_epi64x(_Bias);
+            const __m256i _Target = _mm256_xor_si256(_mm256_set1_epi64x(static_cast<long long>(_Cached)), _Bias_vector);
+
+            // 一次比较[_Level - 3, _Level]四层
+            for (; _Level >= 4; _Level -= 4) {
+                __m256i _Next = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(_Keys + _Level - 4));
+                __m256i _Less = _mm256_cmpgt_epi64(_Target, _mm256_xor_si256(_Next, _Bias_vector));
+                int _Mask = _mm256_movemask_pd(_mm256_castsi256_pd(_Less));
+
+                if (_Mask != 0) {
+                    // 满足条件的层级从低位开始连续，最高的满足条件的通道即为答案
+                    return _Level - 3 + (_Mask >= 8 ? 3 : _Mask >= 4 ? 2 : _Mask >= 2 ? 1 : 0) + 1;
+                }
+            }
+#else
+            const __m128i _Bias_vector = _mm_set1_epi64x(_Bias);
+            const __m128i _Target = _mm_xor_si128(_mm_set1_epi64x(static_cast<long long>(_Cached)), _Bias_vector);
+
+            // 一次比较[_Level - 1, _Level]两层
+            for (; _Level >= 2; _Level -= 2) {
+                __m128i _Next = _mm_loadu_si128(reinterpret_cast<const __m128i *>(_Keys + _Level - 2));
+                __m128i _Less = _mm_cmpgt_epi64(_Target, _mm_xor_si128(_Next, _Bias_vector));
+                int _Mask = _mm_movemask_pd(_mm_castsi128_pd(_Less));
+
+                if (_Mask != 0) {
+                    return _Level - 1 + (_Mask >> 1) + 1;
+                }
+            }
+#endif
+        }
+#endif
+
+        // 从上往下找到第一个满足条件的层级
+        for (; _Level >= 1; --_Level) {
+            if (_Keys[_Level - 1] < _Cached) {
+                return _Level + 1;
+            }
+
+            if constexpr (!cache_traits::exact) {
+                // 缓存值相等时比较完整的键，最大值也可能表示没有向前节点
+                node_pointer _Next = _Forward[_Level]._Next;
+                if (_Keys[_Level - 1] == _Cached && _Next != nullptr && _Next->_Data.first < _Key) {
+                    return _Level + 1;
+                }
+            }
+        }
+
+        node_pointer _Next = _Forward[0]._Next;
+        return _Top >= 0 && _Next != nullptr && _Next->_Data.first < _Key ? 1 : 0;
+    }
+
+    /**
+     * @brief 获取该节点在指定层级到向前节点的跨度
+     * @param _Level 层级
+     * @return 跨度
+     */
+    size_type & span(level_type _Level) noexcept
+    {
+        return _Forward[_Level]._Span;
+    }
+
+    /**
+     * @brief 获取该节点在指定层级到向前节点的跨度
+     * @param _Level 层级
+     * @return 跨度
+     */
+    size_type span(level_type _Level) const noexcept
+    {
+        return _Forward[_Level]._Span;
+    }
+
+    /**
+     * @brief 获取该节点在第0层的向后节点
+     * @return 节点指针
+     */
+    node_pointer & backward() noexcept
+    {
+        return _Backward;
+    }
+
+    /**
+     * @brief 获取该节点在第0层的向后节点
+     * @return 节点指针
+     */
+    const node_pointer & backward() const noexcept
+    {
+        return _Backward;
+    }
+
+    /**
+     * @brief 获取访问标记
+     * @return 访问标记
+     */
+    std::uint32_t & mark() const noexcept
+    {
+        return _Mark;
     }
 
     /**
@@ -107,10 +396,30 @@ public:
     {
         _Data.second = value;
     }
+
+private:
+    /**
+     * @brief 获取第1层及以上缓存的键，紧跟在向前数组之后
+     * @return 键数组
+     */
+    cache_type * _Upper_keys() noexcept
+    {
+        return reinterpret_cast<cache_type *>(_Forward + _Level + 1);
+    }
+
+    /**
+     * @brief 获取第1层及以上缓存的键，紧跟在向前数组之后
+     * @return 键数组
+     */
+    const cache_type * _Upper_keys() const noexcept
+    {
+        return reinterpret_cast<const cache_type *>(_Forward + _Level + 1);
+    }
 };
 
 /**
  * @brief 跳表常量迭代器
+ * @details 末尾迭代器的节点为空，为了能从末尾向前移动，迭代器同时持有跳表的头节点
  */
 template <
     typename _Ty_key,
@@ -118,10 +427,13 @@ template <
 > class _Skiplist_const_iterator
 {
 public:
-    using iterator_category = std::forward_iterator_tag;
+    using iterator_category = std::bidirectional_iterator_tag;
     using key_type = _Ty_key;
     using value_type = _Ty_value;
     using pair_type = std::pair<const _Ty_key, _Ty_value>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const pair_type *;
+    using reference = const pair_type &;
 
     using node_type = _Skip_list_node<key_type, value_type>;
     using node_pointer = _Skip_list_node<key_type, value_type> *;
@@ -129,15 +441,18 @@ public:
 
 protected:
     node_pointer _Node;             // 节点指针
+    node_pointer _Head;             // 所属跳表的头节点
 
 public:
     _Skiplist_const_iterator()
         : _Node(nullptr)
+        , _Head(nullptr)
     { //空迭代器
     }
 
-    _Skiplist_const_iterator(const node_pointer _Node)
+    _Skiplist_const_iterator(const node_pointer _Node, const node_pointer _Head = nullptr)
         : _Node(const_cast<node_pointer>(_Node))
+        , _Head(const_cast<node_pointer>(_Head))
     {
     }
 
@@ -166,6 +481,20 @@ public:
         return _Tmp;
     }
 
+    self & operator--() noexcept
+    {
+        // 末尾迭代器的前一个是最后一个节点
+        _Node = _Node == nullptr ? _Head->backward() : _Node->backward();
+        return *this;
+    }
+
+    self operator--(int) noexcept
+    {
+        self _Tmp = *this;
+        --*this;
+        return _Tmp;
+    }
+
     bool operator==(const self & _Other) const noexcept
     {
         return _Node == _Other._Node;
@@ -178,7 +507,8 @@ public:
 
 protected:
     // 允许跳表类访问私有成员
-    friend class _Skiplist<_Ty_key, _Ty_value>;
+    template <typename, typename, typename, typename>
+    friend class _Skiplist;
 
     /**
      * @brief 获取迭代器所持有的节点指针
@@ -199,10 +529,13 @@ template <
 > class _Skiplist_iterator : public _Skiplist_const_iterator<_Ty_key, _Ty_value>
 {
 public:
-    using iterator_category = std::forward_iterator_tag;
+    using iterator_category = std::bidirectional_iterator_tag;
     using key_type = _Ty_key;
     using value_type = _Ty_value;
     using pair_type = std::pair<const _Ty_key, _Ty_value>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = pair_type *;
+    using reference = pair_type &;
 
     using node_type = _Skip_list_node<key_type, value_type>;
     using node_pointer = _Skip_list_node<key_type, value_type> *;
@@ -215,8 +548,8 @@ public:
     { //空迭代器
     }
 
-    _Skiplist_iterator(node_pointer _Node)
-        : base(_Node)
+    _Skiplist_iterator(node_pointer _Node, node_pointer _Head = nullptr)
+        : base(_Node, _Head)
     {
     }
 
@@ -243,16 +576,64 @@ public:
         ++*this;
         return _Tmp;
     }
+
+    self & operator--() noexcept
+    {
+        base::operator--();
+        return *this;
+    }
+
+    self operator--(int) noexcept
+    {
+        self _Tmp = *this;
+        --*this;
+        return _Tmp;
+    }
+};
+
+/**
+ * @brief 判断分配器是否支持批量释放
+ * @details 要求分配器提供`release()`和`exclusive()`，例如`_Pool_allocator`
+ */
+template <typename _Ty_alloc, typename = void>
+struct _Has_bulk_release : std::false_type
+{
+};
+
+template <typename _Ty_alloc>
+struct _Has_bulk_release<_Ty_alloc, decltype(
+    std::declval<_Ty_alloc &>().release(),
+    static_cast<void>(static_cast<bool>(std::declval<const _Ty_alloc &>().exclusive()))
+)> : std::true_type
+{
+};
+
+/**
+ * @brief 判断比较器是否支持异构查找
+ * @details 比较器声明了`is_transparent`时，查找类接口可以直接接受与键可比较的其他类型，例如`std::less<>`
+ */
+template <typename _Ty_compare, typename = void>
+struct _Is_transparent : std::false_type
+{
+};
+
+template <typename _Ty_compare>
+struct _Is_transparent<_Ty_compare, std::void_t<typename _Ty_compare::is_transparent>> : std::true_type
+{
 };
 
 /**
  * @brief 跳表
  * @tparam _Key 键类型
  * @tparam _Value 值类型
+ * @tparam _Compare 比较器类型，键的相等也由它判断：`!comp(a, b) && !comp(b, a)`
+ * @tparam _Alloc 分配器类型，会被重绑定到节点的分配单位
  */
 template <
     typename _Ty_key,
-    typename _Ty_value
+    typename _Ty_value,
+    typename _Ty_compare = std::less<_Ty_key>,
+    typename _Ty_alloc = std::allocator<std::pair<const _Ty_key, _Ty_value>>
 > class _Skiplist
 {
 public:
@@ -260,31 +641,78 @@ public:
     using value_type = _Ty_value;
     using pair_type = std::pair<const _Ty_key, _Ty_value>;
     using size_type = std::size_t;
+    using key_compare = _Ty_compare;
+    using allocator_type = _Ty_alloc;
     using iterator = _Skiplist_iterator<key_type, value_type>;
     using const_iterator = _Skiplist_const_iterator<key_type, value_type>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
 
     using level_type = int;
     using node_type = _Skip_list_node<key_type, value_type>;
     using node_pointer = _Skip_list_node<key_type, value_type> *;
 
 private:
+    using _Node_storage = typename node_type::storage_type;
+    using _Node_alloc_traits = typename std::allocator_traits<_Ty_alloc>::template rebind_traits<_Node_storage>;
+    using _Node_allocator = typename _Node_alloc_traits::allocator_type;
+
+    /**
+     * @brief 查找时能否只比较节点中缓存的键
+     * @details 要求节点缓存了键、按默认的升序比较，并且查找的键与键类型相同
+     */
+    template <typename _Kty>
+    static constexpr bool _Uses_key_cache = node_type::caches_keys && std::is_same<_Kty, key_type>::value
+        && (std::is_same<key_compare, std::less<key_type>>::value || std::is_same<key_compare, std::less<>>::value);
+
+    _Node_allocator _Alloc;             // 节点分配器
+    key_compare _Comp;                  // 比较器
     node_pointer _Head;                 // 头节点
     level_type _Max_level_index;        // 最大层级索引
     level_type _Current_level_index;    // 当前最高层级索引
     size_type _Size;                    // 节点个数
+    level_distribution _Distribution;   // 层级分布
+    level_type _Level_cap_index;        // 随元素数量增长的层级索引上限
+    double _Next_cap_size;              // 层级索引上限下一次增长时的元素数量
 
 public:
     _Skiplist()
-        : _Skiplist(MAX_LEVEL)
+        : _Skiplist(MAX_LEVEL_LIMIT)
     {
     }
 
     explicit _Skiplist(level_type _Max_level)
-        : _Head(_Create_node(_Max_level - 1))
-        , _Max_level_index(_Max_level - 1)
+        : _Skiplist(_Max_level, allocator_type())
+    {
+    }
+
+    explicit _Skiplist(const allocator_type & _Allocator)
+        : _Skiplist(MAX_LEVEL_LIMIT, _Allocator)
+    {
+    }
+
+    explicit _Skiplist(const key_compare & _Compare, const allocator_type & _Allocator = allocator_type())
+        : _Skiplist(MAX_LEVEL_LIMIT, _Compare, _Allocator)
+    {
+    }
+
+    _Skiplist(level_type _Max_level, const allocator_type & _Allocator)
+        : _Skiplist(_Max_level, key_compare(), _Allocator)
+    {
+    }
+
+    _Skiplist(level_type _Max_level, const key_compare & _Compare, const allocator_type & _Allocator)
+        : _Alloc(_Allocator)
+        , _Comp(_Compare)
+        , _Head(_Create_head(_Clamp_max_level(_Max_level) - 1))
+        , _Max_level_index(_Clamp_max_level(_Max_level) - 1)
         , _Current_level_index(0)
         , _Size(0)
+        , _Distribution()
+        , _Level_cap_index(0)
+        , _Next_cap_size(0)
     {
+        _Reset_level_cap();
     }
 
     ~_Skiplist()
@@ -293,10 +721,28 @@ public:
         clear();
 
         // 删除头节点
-        _Destroy_node(_Head);
+        _Destroy_head(_Head);
     }
 
 public:
+    /**
+     * @brief 获取分配器
+     * @return 分配器
+     */
+    allocator_type get_allocator() const noexcept
+    {
+        return allocator_type(_Alloc);
+    }
+
+    /**
+     * @brief 获取比较器
+     * @return 比较器
+     */
+    key_compare key_comp() const
+    {
+        return _Comp;
+    }
+
     // 元素访问
 
     /**
@@ -330,7 +776,7 @@ public:
      */
     value_type & operator[](const key_type & _Key)
     {
-        return _Get_or_insert(_Key);
+        return _Try_emplace(_Key).first->second;
     }
 
     /**
@@ -338,7 +784,7 @@ public:
      */
     value_type & operator[](key_type && _Key)
     {
-        return _Get_or_insert(std::move(_Key));
+        return _Try_emplace(std::move(_Key)).first->second;
     }
 
     // 迭代器
@@ -348,7 +794,7 @@ public:
      */
     iterator begin() noexcept
     {
-        return ++iterator(_Head);
+        return ++iterator(_Head, _Head);
     }
 
     /**
@@ -356,7 +802,7 @@ public:
      */
     const_iterator begin() const noexcept
     {
-        return ++const_iterator(_Head);
+        return ++const_iterator(_Head, _Head);
     }
 
     /**
@@ -372,7 +818,7 @@ public:
      */
     iterator end() noexcept
     {
-        return iterator(nullptr);
+        return iterator(nullptr, _Head);
     }
 
     /**
@@ -380,7 +826,7 @@ public:
      */
     const_iterator end() const noexcept
     {
-        return const_iterator(nullptr);
+        return const_iterator(nullptr, _Head);
     }
 
     /**
@@ -391,6 +837,54 @@ public:
         return end();
     }
 
+    /**
+     * @brief 返回指向逆向起始的迭代器
+     */
+    reverse_iterator rbegin() noexcept
+    {
+        return reverse_iterator(end());
+    }
+
+    /**
+     * @brief 返回指向逆向起始的迭代器
+     */
+    const_reverse_iterator rbegin() const noexcept
+    {
+        return const_reverse_iterator(end());
+    }
+
+    /**
+     * @brief 返回指向逆向起始的迭代器
+     */
+    const_reverse_iterator crbegin() const noexcept
+    {
+        return rbegin();
+    }
+
+    /**
+     * @brief 返回指向逆向末尾的迭代器
+     */
+    reverse_iterator rend() noexcept
+    {
+        return reverse_iterator(begin());
+    }
+
+    /**
+     * @brief 返回指向逆向末尾的迭代器
+     */
+    const_reverse_iterator rend() const noexcept
+    {
+        return const_reverse_iterator(begin());
+    }
+
+    /**
+     * @brief 返回指向逆向末尾的迭代器
+     */
+    const_reverse_iterator crend() const noexcept
+    {
+        return rend();
+    }
+
     // 容量
 
     /**
@@ -411,6 +905,38 @@ public:
         return _Size == 0;
     }
 
+    // 层级分布
+
+    /**
+     * @brief 获取层级分布
+     * @return 层级分布
+     */
+    const level_distribution & get_level_distribution() const noexcept
+    {
+        return _Distribution;
+    }
+
+    /**
+     * @brief 设置层级分布
+     * @details 只影响之后插入的节点，已有节点的层级不变
+     * @param _New_distribution 层级分布
+     */
+    void set_level_distribution(const level_distribution & _New_distribution) noexcept
+    {
+        _Distribution = _New_distribution;
+        _Reset_level_cap();
+    }
+
+    /**
+     * @brief 获取新节点当前允许的最大层级
+     * @details 为floor(log(1/p)(n)) + 2，随元素数量增长，不超过构造时指定的最大层级
+     * @return 层级
+     */
+    level_type level_limit() const noexcept
+    {
+        return _Level_cap_index + 1;
+    }
+
     // 修改器
 
     /**
@@ -418,20 +944,16 @@ public:
      */
     void clear() noexcept
     {
-        node_pointer _Cur = _Head->forward(0);
-
-        while (_Cur != nullptr) {
-            node_pointer _Next = _Cur->forward(0);
-            _Destroy_node(_Cur);
-            _Cur = _Next;
-        }
+        _Destroy_all_nodes(_Has_bulk_release<_Node_allocator>());
 
         for (level_type _Level = 0; _Level <= _Current_level_index; ++_Level) {
-            _Head->forward(_Level) = nullptr;
+            _Head->set_forward(_Level, nullptr);
         }
 
+        _Head->backward() = nullptr;
         _Current_level_index = 0;
         _Size = 0;
+        _Reset_level_cap();
     }
 
     /**
@@ -455,232 +977,1109 @@ public:
     }
 
     /**
-     * @brief 擦除元素
-     * @param _Pos 迭代器
-     * @return 后随被删除元素的迭代器
+     * @brief 在节点内原地构造键值对，当不存在键时插入
+     * @details 需要先构造出键值对才能得到键，键已经存在时会销毁刚构造的节点，
+     * 已知键时应当使用`try_emplace`
+     * @param _Arguments 键值对的构造参数
+     * @return `std::pair<iterator, bool>`
      */
-    iterator erase(const_iterator _Pos)
+    template <typename... _Args>
+    std::pair<iterator, bool> emplace(_Args &&... _Arguments)
     {
-        // 由于跳表的特性，_Pos代表的节点有自己的最高层级
-        // 只需要在这些层级中删除即可
+        node_pointer _New_node = _Create_node(_Random_level_index(), std::forward<_Args>(_Arguments)...);
 
-        if (_Pos == end()) {
-            return end();
-        }
-
-        level_type _Pos_max_level_index = _Pos._Get_node()->level();
-
-        node_pointer _Cur = nullptr;
-        for (level_type _Level = _Pos_max_level_index; _Level > 0; --_Level) {
-            // 从头节点开始
-            _Cur = _Head;
-
-            while (_Cur->forward(_Level) != _Pos._Get_node()) {
-                _Cur = _Cur->forward(_Level);
-            }
+        node_pointer _Update_list[MAX_LEVEL_LIMIT];
+        size_type _Rank_list[MAX_LEVEL_LIMIT];
+        node_pointer _Ptr = _Find_with_update(_New_node->data().first, _Update_list, _Rank_list);
 
-            // 找到该节点的前驱节点，开始跳过
-            _Cur->forward(_Level) = _Cur->forward(_Level)->forward(_Level);
+        if (_Ptr != nullptr && !_Comp(_New_node->data().first, _Ptr->data().first)) {
+            _Destroy_node(_New_node);
+            return {iterator(_Ptr, _Head), false};
         }
 
-        // 第0层手动删除，因为需要返回迭代器
-        _Cur = _Head;
+        _Link_node(_New_node, _Update_list, _Rank_list);
 
-        while (_Cur->forward(0) != _Pos._Get_node()) {
-            _Cur = _Cur->forward(0);
+        return {iterator(_New_node, _Head), true};
+    }
+
+    /**
+     * @brief 当不存在键时，用键和参数在节点内原地构造键值对并插入
+     * @details 键已经存在时不会构造值，参数也不会被移动
+     * @param _Key 键
+     * @param _Arguments 值的构造参数
+     * @return `std::pair<iterator, bool>`
+     */
+    template <typename... _Args>
+    std::pair<iterator, bool> try_emplace(const key_type & _Key, _Args &&... _Arguments)
+    {
+        return _Try_emplace(_Key, std::forward<_Args>(_Arguments)...);
+    }
+
+    /**
+     * @brief 当不存在键时，用键和参数在节点内原地构造键值对并插入
+     * @details 键已经存在时不会构造值，键和参数也不会被移动
+     * @param _Key 键
+     * @param _Arguments 值的构造参数
+     * @return `std::pair<iterator, bool>`
+     */
+    template <typename... _Args>
+    std::pair<iterator, bool> try_emplace(key_type && _Key, _Args &&... _Arguments)
+    {
+        return _Try_emplace(std::move(_Key), std::forward<_Args>(_Arguments)...);
+    }
+
+    /**
+     * @brief 键存在时赋值，不存在时原地构造并插入
+     * @param _Key 键
+     * @param _Obj 值
+     * @return `std::pair<iterator, bool>`，插入时为true，赋值时为false
+     */
+    template <typename _Mapped>
+    std::pair<iterator, bool> insert_or_assign(const key_type & _Key, _Mapped && _Obj)
+    {
+        return _Insert_or_assign(_Key, std::forward<_Mapped>(_Obj));
+    }
+
+    /**
+     * @brief 键存在时赋值，不存在时原地构造并插入
+     * @param _Key 键
+     * @param _Obj 值
+     * @return `std::pair<iterator, bool>`，插入时为true，赋值时为false
+     */
+    template <typename _Mapped>
+    std::pair<iterator, bool> insert_or_assign(key_type && _Key, _Mapped && _Obj)
+    {
+        return _Insert_or_assign(std::move(_Key), std::forward<_Mapped>(_Obj));
+    }
+
+    /**
+     * @brief 擦除元素
+     * @details 键唯一，按节点的键自顶向下查找即可得到每一层的前驱，期望复杂度为O(log n)
+     * @param _Pos 迭代器
+     * @return 后随被删除元素的迭代器
+     */
+    iterator erase(const_iterator _Pos)
+    {
+        if (_Pos == end()) {
+            return end();
+        }
+
+        node_pointer _Update_list[MAX_LEVEL_LIMIT];
+        node_pointer _Ptr = _Find_with_update(_Pos->first, _Update_list);
+        node_pointer _Next_ptr = _Ptr->forward(0);
+
+        _Unlink(_Ptr, _Update_list);
+        _Destroy_node(_Ptr);
+        _Shrink_level();
+
+        return iterator(_Next_ptr, _Head);
+    }
+
+    /**
+     * @brief 擦除[_First, _Last)范围内的元素
+     * @details 两端的前驱各查找一次，每一层只拼接一次，之后沿第0层逐个释放节点，
+     * 复杂度为O(log n + k)
+     * @param _First 起始迭代器
+     * @param _Last 结束迭代器
+     * @return 后随最后一个被删除元素的迭代器
+     */
+    iterator erase(const_iterator _First, const_iterator _Last)
+    {
+        if (_First == _Last) {
+            return iterator(_Last._Get_node(), _Head);
+        }
+
+        node_pointer _First_update[MAX_LEVEL_LIMIT];
+        node_pointer _Last_update[MAX_LEVEL_LIMIT];
+        size_type _First_rank[MAX_LEVEL_LIMIT] = {};
+        size_type _Last_rank[MAX_LEVEL_LIMIT] = {};
+
+        node_pointer _Cur = _Find_with_update(_First->first, _First_update, _First_rank);
+        node_pointer _End = _Last._Get_node();
+
+        if (_End == nullptr) {
+            _Find_last(_Last_update, _Last_rank);
+        } else {
+            _Find_with_update(_End->data().first, _Last_update, _Last_rank);
+        }
+
+        // 两端第0层前驱的排名之差即为被删除的节点个数
+        size_type _Count = _Last_rank[0] - _First_rank[0];
+
+        for (level_type _Level = 0; _Level <= _Current_level_index; ++_Level) {
+            node_pointer _Pred = _First_update[_Level];
+
+            // 两端前驱不同时，该层有节点在范围内，前驱直接跨到范围之后
+            if (_Pred != _Last_update[_Level]) {
+                _Pred->span(_Level) = _Last_rank[_Level] + _Last_update[_Level]->span(_Level) - _First_rank[_Level];
+                _Pred->set_forward(_Level, _Last_update[_Level]->forward(_Level));
+            }
+
+            _Pred->span(_Level) -= _Count;
+        }
+
+        // 后继不存在时由头节点记录新的最后一个节点
+        (_End == nullptr ? _Head : _End)->backward() = _Cur->backward();
+        _Size -= _Count;
+
+        while (_Cur != _End) {
+            node_pointer _Next = _Cur->forward(0);
+            _Destroy_node(_Cur);
+            _Cur = _Next;
+        }
+
+        _Shrink_level();
+
+        return iterator(_End, _Head);
+    }
+
+    /**
+     * @brief 删除指定键的元素
+     * @param _Key 键
+     * @return 被删除的元素个数
+     */
+    size_type erase(const key_type & _Key) noexcept
+    {
+        return _Erase(_Key);
+    }
+
+    /**
+     * @brief 删除与给定值相等的元素，要求比较器支持异构查找
+     * @param _Key 与键可比较的值
+     * @return 被删除的元素个数
+     */
+    template <typename _Kty, typename _Cmp = key_compare, typename = typename std::enable_if<
+        _Is_transparent<_Cmp>::value && !std::is_convertible<const _Kty &, const_iterator>::value>::type>
+    size_type erase(const _Kty & _Key) noexcept
+    {
+        return _Erase(_Key);
+    }
+
+    // 查找
+
+    /**
+     * @brief 寻找带有特定键的元素
+     * @param _Key 键
+     * @return 迭代器
+     */
+    iterator find(const key_type & _Key) noexcept
+    {
+        return iterator(_Find(_Key), _Head);
+    }
+
+    /**
+     * @brief 寻找带有特定键的元素
+     * @param _Key 键
+     * @return 迭代器
+     */
+    const_iterator find(const key_type & _Key) const noexcept
+    {
+        return const_iterator(_Find(_Key), _Head);
+    }
+
+    /**
+     * @brief 寻找与给定值相等的元素，要求比较器支持异构查找
+     * @param _Key 与键可比较的值
+     * @return 迭代器
+     */
+    template <typename _Kty, typename _Cmp = key_compare, typename = typename std::enable_if<_Is_transparent<_Cmp>::value>::type>
+    iterator find(const _Kty & _Key) noexcept
+    {
+        return iterator(_Find(_Key), _Head);
+    }
+
+    /**
+     * @brief 寻找与给定值相等的元素，要求比较器支持异构查找
+     * @param _Key 与键可比较的值
+     * @return 迭代器
+     */
+    template <typename _Kty, typename _Cmp = key_compare, typename = typename std::enable_if<_Is_transparent<_Cmp>::value>::type>
+    const_iterator find(const _Kty & _Key) const noexcept
+    {
+        return const_iterator(_Find(_Key), _Head);
+    }
+
+    /**
+     * @brief 获取元素的访问标记
+     * @details 标记不增加节点大小，跳表本身不读写它，插入时为0
+     * @param _Where 指向元素的迭代器，不能为尾后迭代器
+     * @return 访问标记
+     */
+    std::uint32_t & access_mark(const_iterator _Where) const noexcept
+    {
+        return _Where._Node->mark();
+    }
+
+    /**
+     * @brief 获取元素所在节点占用的字节数
+     * @details 包括键值对和各层的链接，不包括键和值自身在堆上持有的内存
+     * @param _Where 指向元素的迭代器，不能为尾后迭代器
+     * @return 字节数
+     */
+    size_type node_size(const_iterator _Where) const noexcept
+    {
+        return node_type::allocation_units(_Where._Node->level()) * sizeof(_Node_storage);
+    }
+
+    /**
+     * @brief 获取元素所在节点的层级索引
+     * @param _Where 指向元素的迭代器，不能为尾后迭代器
+     * @return 层级索引，节点有`层级索引 + 1`层链接
+     */
+    level_type node_level(const_iterator _Where) const noexcept
+    {
+        return _Where._Node->level();
+    }
+
+    /**
+     * @brief 查询一个键是否存在
+     * @param _Key 键
+     * @return 是否存在
+     */
+    bool contains(const key_type & _Key) const noexcept
+    {
+        node_pointer _Node_ptr = _Find(_Key);
+        return _Node_ptr != nullptr;
+    }
+
+    /**
+     * @brief 查询与给定值相等的键是否存在，要求比较器支持异构查找
+     * @param _Key 与键可比较的值
+     * @return 是否存在
+     */
+    template <typename _Kty, typename _Cmp = key_compare, typename = typename std::enable_if<_Is_transparent<_Cmp>::value>::type>
+    bool contains(const _Kty & _Key) const noexcept
+    {
+        return _Find(_Key) != nullptr;
+    }
+
+    /**
+     * @brief 返回指向首个不小于给定键的元素的迭代器
+     * @param _Key 键
+     * @return 迭代器
+     */
+    iterator lower_bound(const key_type & _Key) noexcept
+    {
+        return iterator(_Lower_bound(_Key), _Head);
+    }
+
+    /**
+     * @brief 返回指向首个不小于给定键的元素的迭代器
+     * @param _Key 键
+     * @return 迭代器
+     */
+    const_iterator lower_bound(const key_type & _Key) const noexcept
+    {
+        return const_iterator(_Lower_bound(_Key), _Head);
+    }
+
+    /**
+     * @brief 返回指向首个不小于给定值的元素的迭代器，要求比较器支持异构查找
+     * @param _Key 与键可比较的值
+     * @return 迭代器
+     */
+    template <typename _Kty, typename _Cmp = key_compare, typename = typename std::enable_if<_Is_transparent<_Cmp>::value>::type>
+    iterator lower_bound(const _Kty & _Key) noexcept
+    {
+        return iterator(_Lower_bound(_Key), _Head);
+    }
+
+    /**
+     * @brief 返回指向首个不小于给定值的元素的迭代器，要求比较器支持异构查找
+     * @param _Key 与键可比较的值
+     * @return 迭代器
+     */
+    template <typename _Kty, typename _Cmp = key_compare, typename = typename std::enable_if<_Is_transparent<_Cmp>::value>::type>
+    const_iterator lower_bound(const _Kty & _Key) const noexcept
+    {
+        return const_iterator(_Lower_bound(_Key), _Head);
+    }
+
+    /**
+     * @brief 返回指向首个大于给定键的元素的迭代器
+     * @param _Key 键
+     * @return 迭代器
+     */
+    iterator upper_bound(const key_type & _Key) noexcept
+    {
+        return iterator(_Upper_bound(_Key), _Head);
+    }
+
+    /**
+     * @brief 返回指向首个大于给定键的元素的迭代器
+     * @param _Key 键
+     * @return 迭代器
+     */
+    const_iterator upper_bound(const key_type & _Key) const noexcept
+    {
+        return const_iterator(_Upper_bound(_Key), _Head);
+    }
+
+    /**
+     * @brief 返回指向首个大于给定值的元素的迭代器，要求比较器支持异构查找
+     * @param _Key 与键可比较的值
+     * @return 迭代器
+     */
+    template <typename _Kty, typename _Cmp = key_compare, typename = typename std::enable_if<_Is_transparent<_Cmp>::value>::type>
+    iterator upper_bound(const _Kty & _Key) noexcept
+    {
+        return iterator(_Upper_bound(_Key), _Head);
+    }
+
+    /**
+     * @brief 返回指向首个大于给定值的元素的迭代器，要求比较器支持异构查找
+     * @param _Key 与键可比较的值
+     * @return 迭代器
+     */
+    template <typename _Kty, typename _Cmp = key_compare, typename = typename std::enable_if<_Is_transparent<_Cmp>::value>::type>
+    const_iterator upper_bound(const _Kty & _Key) const noexcept
+    {
+        return const_iterator(_Upper_bound(_Key), _Head);
+    }
+
+    /**
+     * @brief 返回与给定键相等的元素范围
+     * @details 键是唯一的，范围内最多只有一个元素，只需要一次查找
+     * @param _Key 键
+     * @return `std::pair<lower_bound, upper_bound>`
+     */
+    std::pair<iterator, iterator> equal_range(const key_type & _Key) noexcept
+    {
+        auto _Range = _Equal_range(_Key);
+        return {iterator(_Range.first, _Head), iterator(_Range.second, _Head)};
+    }
+
+    /**
+     * @brief 返回与给定键相等的元素范围
+     * @param _Key 键
+     * @return `std::pair<lower_bound, upper_bound>`
+     */
+    std::pair<const_iterator, const_iterator> equal_range(const key_type & _Key) const noexcept
+    {
+        auto _Range = _Equal_range(_Key);
+        return {const_iterator(_Range.first, _Head), const_iterator(_Range.second, _Head)};
+    }
+
+    /**
+     * @brief 返回与给定值相等的元素范围，要求比较器支持异构查找
+     * @param _Key 与键可比较的值
+     * @return `std::pair<lower_bound, upper_bound>`
+     */
+    template <typename _Kty, typename _Cmp = key_compare, typename = typename std::enable_if<_Is_transparent<_Cmp>::value>::type>
+    std::pair<iterator, iterator> equal_range(const _Kty & _Key) noexcept
+    {
+        auto _Range = _Equal_range(_Key);
+        return {iterator(_Range.first, _Head), iterator(_Range.second, _Head)};
+    }
+
+    /**
+     * @brief 返回与给定值相等的元素范围，要求比较器支持异构查找
+     * @param _Key 与键可比较的值
+     * @return `std::pair<lower_bound, upper_bound>`
+     */
+    template <typename _Kty, typename _Cmp = key_compare, typename = typename std::enable_if<_Is_transparent<_Cmp>::value>::type>
+    std::pair<const_iterator, const_iterator> equal_range(const _Kty & _Key) const noexcept
+    {
+        auto _Range = _Equal_range(_Key);
+        return {const_iterator(_Range.first, _Head), const_iterator(_Range.second, _Head)};
+    }
+
+    // 排名
+
+    /**
+     * @brief 获取键的排名
+     * @details 沿途累加跨度，期望复杂度为O(log n)
+     * @param _Key 键
+     * @return 小于键的元素个数，键存在时即为它从0开始的位置
+     */
+    size_type rank(const key_type & _Key) const noexcept
+    {
+        return _Rank(_Key);
+    }
+
+    /**
+     * @brief 获取指定位置的元素
+     * @param _Index 从0开始的位置
+     * @return 迭代器，越界时为`end()`
+     */
+    iterator select(size_type _Index) noexcept
+    {
+        return iterator(_Select(_Index), _Head);
+    }
+
+    /**
+     * @brief 获取指定位置的元素
+     * @param _Index 从0开始的位置
+     * @return 迭代器，越界时为`end()`
+     */
+    const_iterator select(size_type _Index) const noexcept
+    {
+        return const_iterator(_Select(_Index), _Head);
+    }
+
+    /**
+     * @brief 统计[_Low, _High)范围内的元素个数
+     * @param _Low 起始键（包含）
+     * @param _High 结束键（不包含）
+     * @return 元素个数
+     */
+    size_type count_range(const key_type & _Low, const key_type & _High) const noexcept
+    {
+        if (!_Comp(_Low, _High)) {
+            return 0;
+        }
+
+        return _Rank(_High) - _Rank(_Low);
+    }
+
+    // 手指查找
+
+    /**
+     * @brief 手指，记录上一次查找在每一层的前驱
+     * @details 按键的升序处理一批键时，后一个键的查找路径与前一个键的路径在高层往往相同，
+     * 只需要从两者分叉的层级继续向下查找，相邻两个键之间相距d个元素时期望复杂度为O(log d)。
+     * 键不是升序时退化为从头节点开始的完整查找，结果仍然正确。
+     * 手指只能与同一个跳表的带手指的接口一起使用，跳表被其他接口修改后需要使用新的手指
+     */
+    class finger
+    {
+    private:
+        friend class _Skiplist;
+
+        const _Skiplist * _List;                    // 所属跳表，为空时尚未使用
+        node_pointer _Update_list[MAX_LEVEL_LIMIT]; // 每一层的前驱
+        size_type _Rank_list[MAX_LEVEL_LIMIT];      // 每一层前驱的排名
+
+    public:
+        finger() noexcept
+            : _List(nullptr)
+        {
+        }
+    };
+
+    /**
+     * @brief 从手指开始寻找带有特定键的元素
+     * @param _Key 键
+     * @param _Finger 手指
+     * @return 迭代器
+     */
+    iterator find(const key_type & _Key, finger & _Finger) noexcept
+    {
+        return iterator(_Find_from_finger(_Key, _Finger), _Head);
+    }
+
+    /**
+     * @brief 从手指开始寻找带有特定键的元素
+     * @param _Key 键
+     * @param _Finger 手指
+     * @return 迭代器
+     */
+    const_iterator find(const key_type & _Key, finger & _Finger) const noexcept
+    {
+        return const_iterator(_Find_from_finger(_Key, _Finger), _Head);
+    }
+
+    /**
+     * @brief 从手指开始查找插入位置，当不存在键时插入一个键值对
+     * @param _Pair 键值对
+     * @param _Finger 手指
+     * @return `std::pair<iterator, bool>`
+     */
+    std::pair<iterator, bool> insert(const pair_type & _Pair, finger & _Finger)
+    {
+        return _Insert(_Pair, _Finger);
+    }
+
+    /**
+     * @brief 从手指开始查找插入位置，当不存在键时插入一个键值对
+     * @param _Pair 键值对
+     * @param _Finger 手指
+     * @return `std::pair<iterator, bool>`
+     */
+    std::pair<iterator, bool> insert(pair_type && _Pair, finger & _Finger)
+    {
+        return _Insert(std::move(_Pair), _Finger);
+    }
+
+    /**
+     * @brief 从手指开始查找，删除指定键的元素
+     * @param _Key 键
+     * @param _Finger 手指
+     * @return 被删除的元素个数
+     */
+    size_type erase(const key_type & _Key, finger & _Finger) noexcept
+    {
+        node_pointer _Ptr = _Find_with_finger(_Key, _Finger);
+
+        if (_Ptr == nullptr || _Comp(_Key, _Ptr->data().first)) {
+            return 0;
+        }
+
+        // 前驱都在被删除的节点之前，删除后手指仍然有效
+        _Unlink(_Ptr, _Finger._Update_list);
+        _Destroy_node(_Ptr);
+        _Shrink_level();
+
+        return 1;
+    }
+
+    // 批量构建
+
+    /**
+     * @brief 有序构建器
+     * @details 从按键严格升序的数据构建跳表：每个节点直接链接到各层的末尾，不需要查找，整体为O(n)。
+     * p为1/2^k时节点层级由序号确定，第i个节点的层级索引为i的二进制末尾0的个数除以k，得到完全平衡的跳表，
+     * 其他p随机生成。
+     * 构建器创建时会清空跳表，构建期间不能通过其他方式修改跳表
+     */
+    class sorted_builder
+    {
+    private:
+        _Skiplist & _List;                          // 目标跳表
+        node_pointer _Tail[MAX_LEVEL_LIMIT];        // 每一层的最后一个节点
+        size_type _Tail_rank[MAX_LEVEL_LIMIT];      // 每一层最后一个节点的排名
+        size_type _Count;                           // 已追加的节点个数
+
+    public:
+        explicit sorted_builder(_Skiplist & _List)
+            : _List(_List)
+            , _Count(0)
+        {
+            _List.clear();
+
+            for (level_type _Level = 0; _Level <= _List._Max_level_index; ++_Level) {
+                _Tail[_Level] = _List._Head;
+                _Tail_rank[_Level] = 0;
+            }
+        }
+
+        sorted_builder(const sorted_builder &) = delete;
+
+        sorted_builder & operator=(const sorted_builder &) = delete;
+
+    public:
+        /**
+         * @brief 在末尾追加一个键值对
+         * @param _Pair 键值对，键必须大于之前追加的所有键
+         */
+        void append(const pair_type & _Pair)
+        {
+            _Append(_Pair);
+        }
+
+        /**
+         * @brief 在末尾追加一个键值对，移动其中的值
+         * @param _Pair 键值对，键必须大于之前追加的所有键
+         */
+        void append(pair_type && _Pair)
+        {
+            _Append(std::move(_Pair));
+        }
+
+    private:
+        /**
+         * @brief 在末尾追加一个键值对
+         * @param _Pair 键值对
+         */
+        template <typename _P>
+        void _Append(_P && _Pair)
+        {
+            if (_Count != 0 && !_List._Comp(_Tail[0]->data().first, _Pair.first)) {
+                _List._Throw_unsorted();
+            }
+
+            // p为1/2^k时按序号生成期望形状，否则随机生成
+            level_type _New_level_index = _List._Distribution.sequence_level(_Count + 1, _List._Max_level_index);
+            if (_New_level_index < 0) {
+                _New_level_index = _List._Random_level_index();
+            }
+
+            node_pointer _New_node = _List._Create_node(_New_level_index, std::forward<_P>(_Pair));
+            _New_node->backward() = _Count == 0 ? nullptr : _Tail[0];
+            _List._Head->backward() = _New_node;
+
+            for (level_type _Level = 0; _Level <= _New_level_index; ++_Level) {
+                _Tail[_Level]->set_forward(_Level, _New_node);
+                _Tail[_Level]->span(_Level) = _Count + 1 - _Tail_rank[_Level];
+                _Tail[_Level] = _New_node;
+                _Tail_rank[_Level] = _Count + 1;
+            }
+
+            if (_New_level_index > _List._Current_level_index) {
+                _List._Current_level_index = _New_level_index;
+            }
+
+            ++_List._Size;
+            ++_Count;
+            _List._Grow_level_cap();
+        }
+    };
+
+private:
+    /**
+     * @brief 将最大层级限制在[1, MAX_LEVEL_LIMIT]之间
+     * @param _Max_level 最大层级
+     * @return 限制后的最大层级
+     */
+    static level_type _Clamp_max_level(level_type _Max_level) noexcept
+    {
+        if (_Max_level < 1) {
+            return 1;
+        }
+
+        return _Max_level < MAX_LEVEL_LIMIT ? _Max_level : MAX_LEVEL_LIMIT;
+    }
+
+    /**
+     * @brief 随机生成一个层级索引
+     * @details 使用线程局部的生成器，每次只消耗一个随机数
+     * @return 层级索引
+     */
+    level_type _Random_level_index() const noexcept
+    {
+        return _Distribution(_Xorshift_random::local()(), _Level_cap_index);
+    }
+
+    /**
+     * @brief 元素数量达到阈值时提高层级索引上限
+     * @details 上限为1 + floor(log(1/p)(n))，使最高层的期望节点数保持为常数，
+     * 查找始终是O(log n)。删除元素时上限不会降低，已有的高层节点仍然有用
+     */
+    void _Grow_level_cap() noexcept
+    {
+        while (static_cast<double>(_Size) >= _Next_cap_size && _Level_cap_index < _Max_level_index) {
+            ++_Level_cap_index;
+            _Next_cap_size /= _Distribution.probability();
+        }
+    }
+
+    /**
+     * @brief 按当前元素数量和层级分布重新计算层级索引上限
+     */
+    void _Reset_level_cap() noexcept
+    {
+        _Level_cap_index = _Max_level_index < 1 ? _Max_level_index : 1;
+        _Next_cap_size = 1.0 / _Distribution.probability();
+        _Grow_level_cap();
+    }
+
+    /**
+     * @brief 创建头节点
+     * @details 头节点不经过节点分配器，这样批量释放节点时可以保留头节点
+     * @param _Level 层级
+     * @return 节点指针
+     */
+    node_pointer _Create_head(level_type _Level) const
+    {
+        void * _Memory = ::operator new(node_type::allocation_size(_Level));
+
+        try {
+            return ::new (_Memory) node_type(_Level);
+        } catch (...) {
+            ::operator delete(_Memory);
+            throw;
         }
+    }
 
-        node_pointer _Next_ptr = _Cur->forward(0)->forward(0);
-        _Cur->forward(0) = _Next_ptr;
+    /**
+     * @brief 销毁头节点
+     * @param _Node 节点指针
+     */
+    void _Destroy_head(node_pointer _Node) const noexcept
+    {
+        _Node->~node_type();
+        ::operator delete(_Node);
+    }
 
-        // 删除节点
-        _Destroy_node(_Pos._Get_node());
+    /**
+     * @brief 创建一个节点
+     * @details 键值对与向前数组在同一次分配中得到，键值对在节点内原地构造
+     * @param _Level 层级
+     * @param _Arguments 键值对的构造参数
+     * @return 节点指针
+     */
+    template <typename... _Args>
+    node_pointer _Create_node(level_type _Level, _Args &&... _Arguments)
+    {
+        size_type _Units = node_type::allocation_units(_Level);
+        _Node_storage * _Memory = _Node_alloc_traits::allocate(_Alloc, _Units);
+
+        try {
+            return ::new (static_cast<void *>(_Memory)) node_type(_Level, std::forward<_Args>(_Arguments)...);
+        } catch (...) {
+            _Node_alloc_traits::deallocate(_Alloc, _Memory, _Units);
+            throw;
+        }
+    }
 
-        // 检查是否需要降低跳表的高度
-        while (_Current_level_index > 0 && _Head->forward(_Current_level_index) == nullptr) {
-            --_Current_level_index;
+    /**
+     * @brief 销毁一个节点
+     * @param _Node 节点指针
+     */
+    void _Destroy_node(node_pointer _Node) noexcept
+    {
+        size_type _Units = node_type::allocation_units(_Node->level());
+        _Node->~node_type();
+        _Node_alloc_traits::deallocate(_Alloc, reinterpret_cast<_Node_storage *>(_Node), _Units);
+    }
+
+    /**
+     * @brief 逐个销毁除头节点外的所有节点
+     */
+    void _Destroy_all_nodes(std::false_type) noexcept
+    {
+        node_pointer _Cur = _Head->forward(0);
+
+        while (_Cur != nullptr) {
+            node_pointer _Next = _Cur->forward(0);
+            _Destroy_node(_Cur);
+            _Cur = _Next;
         }
+    }
 
-        // 更新节点个数
-        --_Size;
+    /**
+     * @brief 销毁除头节点外的所有节点，独占内存池时批量释放内存
+     */
+    void _Destroy_all_nodes(std::true_type) noexcept
+    {
+        if (!_Alloc.exclusive()) {
+            _Destroy_all_nodes(std::false_type());
+            return;
+        }
+
+        // 只需要调用析构函数，不需要逐个归还内存
+        if (!std::is_trivially_destructible<pair_type>::value) {
+            node_pointer _Cur = _Head->forward(0);
+
+            while (_Cur != nullptr) {
+                node_pointer _Next = _Cur->forward(0);
+                _Cur->~node_type();
+                _Cur = _Next;
+            }
+        }
 
-        // 返回该节点迭代器
-        return iterator(_Next_ptr);
+        _Alloc.release();
     }
 
     /**
-     * @brief 删除指定键的元素
-     * @param _Key 键
+     * @brief 删除与给定值相等的元素
+     * @param _Key 键或与键可比较的值
      * @return 被删除的元素个数
      */
-    size_type erase(const key_type & _Key) noexcept
+    template <typename _Kty>
+    size_type _Erase(const _Kty & _Key) noexcept
     {
-        std::vector<node_pointer> _Update_list(_Max_level_index + 1, nullptr);
+        node_pointer _Update_list[MAX_LEVEL_LIMIT];
         node_pointer _Ptr = _Find_with_update(_Key, _Update_list);
 
-        if (_Ptr == nullptr || _Ptr->data().first != _Key) {
+        if (_Ptr == nullptr || _Comp(_Key, _Ptr->data().first)) {
             // 不存在这个节点，删除失败
             return 0;
         }
 
-        // 开始删除节点
-        for (level_type _Level = 0; _Level <= _Current_level_index; ++_Level) {
-            if (_Update_list[_Level]->forward(_Level) != _Ptr) {
-                // 从这里开始上层都没有该键值对了
-                break;
+        _Unlink(_Ptr, _Update_list);
+        _Destroy_node(_Ptr);
+        _Shrink_level();
+
+        return 1;
+    }
+
+    /**
+     * @brief 查找每一层的最后一个节点，即尾后位置在每一层的前驱
+     * @param _Update_list 前驱记录数组，长度至少为`_Current_level_index + 1`
+     * @param _Rank_list 每一层前驱的排名，长度至少为`_Current_level_index + 1`
+     */
+    void _Find_last(node_pointer * _Update_list, size_type * _Rank_list) const noexcept
+    {
+        node_pointer _Cur = _Head;
+        size_type _Traversed = 0;
+
+        for (level_type _Level = _Current_level_index; _Level >= 0; --_Level) {
+            while (_Cur->forward(_Level) != nullptr) {
+                _Traversed += _Cur->span(_Level);
+                _Cur = _Cur->forward(_Level);
             }
 
-            // 是该键值对，删除
-            _Update_list[_Level]->forward(_Level) = _Ptr->forward(_Level);
+            _Update_list[_Level] = _Cur;
+            _Rank_list[_Level] = _Traversed;
         }
+    }
 
-        // 删除节点
-        _Destroy_node(_Ptr);
-
-        // 检查是否需要降低跳表的高度
-        while (_Current_level_index > 0 && _Head->forward(_Current_level_index) == nullptr) {
-            --_Current_level_index;
+    /**
+     * @brief 从每一层中摘除一个节点，不释放节点
+     * @param _Ptr 节点指针
+     * @param _Update_list 前驱记录数组，长度至少为`_Current_level_index + 1`，
+     * 不高于节点层级的前驱都指向该节点
+     */
+    void _Unlink(node_pointer _Ptr, node_pointer * _Update_list) noexcept
+    {
+        for (level_type _Level = 0; _Level <= _Current_level_index; ++_Level) {
+            if (_Level <= _Ptr->level()) {
+                // 前驱直接跨过被删除的节点
+                _Update_list[_Level]->span(_Level) += _Ptr->span(_Level) - 1;
+                _Update_list[_Level]->set_forward(_Level, _Ptr->forward(_Level));
+            } else {
+                // 更高的层级只是少跨过一个节点
+                --_Update_list[_Level]->span(_Level);
+            }
         }
 
-        --_Size;
+        // 后继不存在时被删除的是最后一个节点，由头节点记录新的最后一个节点
+        node_pointer _Next = _Ptr->forward(0);
+        (_Next == nullptr ? _Head : _Next)->backward() = _Ptr->backward();
 
-        return 1;
+        --_Size;
     }
 
-    // 查找
-
     /**
-     * @brief 寻找带有特定键的元素
-     * @param _Key 键
-     * @return 迭代器
+     * @brief 删除节点后降低跳表的高度
      */
-    iterator find(const key_type & _Key) noexcept
+    void _Shrink_level() noexcept
     {
-        return iterator(_Find(_Key));
+        while (_Current_level_index > 0 && _Head->forward(_Current_level_index) == nullptr) {
+            --_Current_level_index;
+        }
     }
 
     /**
-     * @brief 寻找带有特定键的元素
-     * @param _Key 键
-     * @return 迭代器
+     * @brief 记录一次自顶向下的查找
+     * @details 定义了`WW_KVSTORE_STATS`时计入线程局部的查找计数，否则为空
      */
-    const_iterator find(const key_type & _Key) const noexcept
+    void _Trace_search() const noexcept
     {
-        return const_iterator(_Find(_Key));
+#ifdef WW_KVSTORE_STATS
+        _Search_trace & _Trace = _Search_trace::local();
+        ++_Trace._Searches;
+        _Trace._Levels += static_cast<std::uint64_t>(_Current_level_index) + 1;
+#endif
     }
 
     /**
-     * @brief 查询一个键是否存在
-     * @param _Key 键
-     * @return 是否存在
+     * @brief 记录比较缓存的键的次数
+     * @param _Count 次数
      */
-    bool contains(const key_type & _Key) const noexcept
+    void _Trace_comparisons(level_type _Count) const noexcept
     {
-        node_pointer _Node_ptr = _Find(_Key);
-        return _Node_ptr != nullptr;
+#ifdef WW_KVSTORE_STATS
+        _Search_trace::local()._Comparisons += static_cast<std::uint64_t>(_Count);
+#else
+        (void)_Count;
+#endif
     }
 
-private:
     /**
-     * @brief 随机生成一个层级
-     * @return 层级
+     * @brief 查找路径上的键比较
+     * @details 定义了`WW_KVSTORE_STATS`时计入线程局部的比较次数，否则与直接调用比较器相同
+     * @param _Left 左操作数
+     * @param _Right 右操作数
+     * @return 左操作数是否小于右操作数
      */
-    level_type _Random_level() const noexcept
+    template <typename _Lty, typename _Rty>
+    bool _Search_less(const _Lty & _Left, const _Rty & _Right) const noexcept
     {
-        level_type _Level = 1;
-
-        while (rand() % 2 && _Level < _Max_level_index) {
-            ++_Level;
-        }
-
-        return _Level;
+#ifdef WW_KVSTORE_STATS
+        ++_Search_trace::local()._Comparisons;
+#endif
+        return _Comp(_Left, _Right);
     }
 
     /**
-     * @brief 创建一个空节点
+     * @brief 查找一个节点
+     * @param _Key 键
      * @return 节点指针
      */
-    node_pointer _Create_node() const noexcept
+    template <typename _Kty>
+    node_pointer _Find(const _Kty & _Key) const noexcept
     {
-        return new node_type();
+        node_pointer _Cur = _Lower_bound(_Key);
+
+        // 已知节点不小于键，只要键也不小于节点就是目标节点
+        if (_Cur != nullptr && !_Comp(_Key, _Cur->data().first)) {
+            return _Cur;
+        }
+
+        return nullptr;
     }
 
     /**
-     * @brief 创建一个指定层级的空节点
-     * @param _Level 层级
-     * @return 节点指针
+     * @brief 查找第一个不小于键的节点
+     * @param _Key 键
+     * @return 节点指针，不存在时为空
      */
-    node_pointer _Create_node(level_type _Level) const noexcept
+    template <typename _Kty>
+    node_pointer _Lower_bound(const _Kty & _Key) const noexcept
     {
-        return new node_type(_Level);
+        // 从头节点开始查找
+        node_pointer _Cur = _Head;
+        _Trace_search();
+
+        if constexpr (_Uses_key_cache<_Kty>) {
+            // 在上层只比较缓存值，确定要前进时才访问向前节点
+            const auto _Cached = node_type::cache_traits::make(_Key);
+
+            for (level_type _Level = _Current_level_index; ; ) {
+                level_type _Before = _Cur->levels_before(_Level, _Key, _Cached);
+                _Trace_comparisons(_Before == 0 ? _Level + 1 : _Level - _Before + 2);
+
+                if (_Before == 0) {
+                    break;
+                }
+
+                _Level = _Before - 1;
+                _Cur = _Cur->forward(_Level);
+            }
+        } else {
+            // 从当前最高层级开始查找
+            for (level_type _Level = _Current_level_index; _Level >= 0; --_Level) {
+                // 在当前层级中前进，直到找到大于等于_key的节点
+                while (_Cur->forward(_Level) != nullptr && _Search_less(_Cur->forward(_Level)->data().first, _Key)) {
+                    _Cur = _Cur->forward(_Level);
+                }
+            }
+        }
+
+        // 到达0层，向后移动一个就是最终找到的节点
+        return _Cur->forward(0);
     }
 
     /**
-     * @brief 创建一个节点
-     * @param _Pair 键值对
-     * @param _Level 层级
-     * @return 节点指针
+     * @brief 查找第一个大于键的节点
+     * @param _Key 键
+     * @return 节点指针，不存在时为空
      */
-    node_pointer _Create_node(const pair_type & _Pair, level_type _Level) const noexcept
+    template <typename _Kty>
+    node_pointer _Upper_bound(const _Kty & _Key) const noexcept
     {
-        return new node_type(_Pair, _Level);
+        node_pointer _Cur = _Head;
+        _Trace_search();
+
+        for (level_type _Level = _Current_level_index; _Level >= 0; --_Level) {
+            // 跳过所有不大于键的节点
+            while (_Cur->forward(_Level) != nullptr && !_Search_less(_Key, _Cur->forward(_Level)->data().first)) {
+                _Cur = _Cur->forward(_Level);
+            }
+        }
+
+        return _Cur->forward(0);
     }
 
     /**
-     * @brief 销毁一个节点
-     * @param _Node 节点指针
+     * @brief 计算小于键的节点个数
+     * @param _Key 键
+     * @return 节点个数
      */
-    void _Destroy_node(node_pointer _Node) const noexcept
+    size_type _Rank(const key_type & _Key) const noexcept
     {
-        delete _Node;
+        node_pointer _Cur = _Head;
+        size_type _Traversed = 0;
+
+        for (level_type _Level = _Current_level_index; _Level >= 0; --_Level) {
+            while (_Cur->forward(_Level) != nullptr && _Comp(_Cur->forward(_Level)->data().first, _Key)) {
+                _Traversed += _Cur->span(_Level);
+                _Cur = _Cur->forward(_Level);
+            }
+        }
+
+        return _Traversed;
     }
 
     /**
-     * @brief 查找一个节点
-     * @param _Key 键
-     * @return 节点指针
+     * @brief 查找指定位置的节点
+     * @param _Index 从0开始的位置
+     * @return 节点指针，越界时为空
      */
-    node_pointer _Find(const key_type & _Key) const noexcept
+    node_pointer _Select(size_type _Index) const noexcept
     {
-        // 从头节点开始查找
+        if (_Index >= _Size) {
+            return nullptr;
+        }
+
+        // 头节点的排名为0，目标节点的排名为_Index + 1
         node_pointer _Cur = _Head;
+        size_type _Traversed = 0;
 
-        // 从当前最高层级开始查找
         for (level_type _Level = _Current_level_index; _Level >= 0; --_Level) {
-            // 在当前层级中前进，直到找到大于等于_key的节点
-            while (_Cur->forward(_Level) != nullptr && _Cur->forward(_Level)->data().first < _Key) {
+            while (_Cur->forward(_Level) != nullptr && _Traversed + _Cur->span(_Level) <= _Index + 1) {
+                _Traversed += _Cur->span(_Level);
                 _Cur = _Cur->forward(_Level);
             }
-        }
-        
-        // 到达0层，向后移动一个就是最终找到的节点
-        _Cur = _Cur->forward(0);
 
-        // 判断该节点是不是目标节点
-        if (_Cur != nullptr && _Cur->data().first == _Key) {
-            return _Cur;
+            if (_Traversed == _Index + 1) {
+                return _Cur;
+            }
         }
 
         return nullptr;
     }
 
+    /**
+     * @brief 查找与键相等的节点范围
+     * @param _Key 键
+     * @return 第一个不小于键的节点和第一个大于键的节点
+     */
+    template <typename _Kty>
+    std::pair<node_pointer, node_pointer> _Equal_range(const _Kty & _Key) const noexcept
+    {
+        node_pointer _First = _Lower_bound(_Key);
+
+        if (_First != nullptr && !_Comp(_Key, _First->data().first)) {
+            return {_First, _First->forward(0)};
+        }
+
+        return {_First, _First};
+    }
+
     /**
      * @brief 带前驱记录的查找节点
      * @param _Key 键
-     * @param _Update_list 前驱记录数组
+     * @param _Update_list 前驱记录数组，长度至少为`_Current_level_index + 1`
+     * @param _Rank_list 每一层前驱的排名（头节点为0），为空时不记录
      * @return 节点指针
      */
-    node_pointer _Find_with_update(const key_type & _Key, std::vector<node_pointer> & _Update_list) const noexcept
+    template <typename _Kty>
+    node_pointer _Find_with_update(const _Kty & _Key, node_pointer * _Update_list,
+                                   size_type * _Rank_list = nullptr) const noexcept
     {
         node_pointer _Cur = _Head;
-
-        // 从顶层向下查找，记录每一层的前驱
-        for (level_type _Level = _Current_level_index; _Level >= 0; --_Level) {
-            while (_Cur->forward(_Level) != nullptr && _Cur->forward(_Level)->data().first < _Key) {
+        size_type _Traversed = 0;
+        _Trace_search();
+
+        if constexpr (_Uses_key_cache<_Kty>) {
+            const auto _Cached = node_type::cache_traits::make(_Key);
+            level_type _Level = _Current_level_index;
+
+            while (true) {
+                level_type _Before = _Cur->levels_before(_Level, _Key, _Cached);
+                _Trace_comparisons(_Before == 0 ? _Level + 1 : _Level - _Before + 2);
+
+                // 不能前进的层级的前驱都是当前节点
+                for (; _Level >= _Before; --_Level) {
+                    _Update_list[_Level] = _Cur;
+                    if (_Rank_list != nullptr) {
+                        _Rank_list[_Level] = _Traversed;
+                    }
+                }
+
+                if (_Before == 0) {
+                    break;
+                }
+
+                _Traversed += _Cur->span(_Level);
                 _Cur = _Cur->forward(_Level);
             }
-
-            _Update_list[_Level] = _Cur;
+        } else {
+            // 从顶层向下查找，记录每一层的前驱
+            for (level_type _Level = _Current_level_index; _Level >= 0; --_Level) {
+                while (_Cur->forward(_Level) != nullptr && _Search_less(_Cur->forward(_Level)->data().first, _Key)) {
+                    _Traversed += _Cur->span(_Level);
+                    _Cur = _Cur->forward(_Level);
+                }
+
+                _Update_list[_Level] = _Cur;
+                if (_Rank_list != nullptr) {
+                    _Rank_list[_Level] = _Traversed;
+                }
+            }
         }
 
         // 到达第0层，下一个就是目标节点
@@ -689,23 +2088,105 @@ private:
         return _Cur;
     }
 
+    /**
+     * @brief 从手指记录的前驱开始查找，并更新手指
+     * @details 键的前驱在每一层都不早于手指的前驱，从下往上找到第一个后继不小于键的层级，
+     * 该层及以上的前驱保持不变，从它的下一层开始按普通的方式向下查找
+     * @param _Key 键
+     * @param _Finger 手指
+     * @return 第一个不小于键的节点
+     */
+    template <typename _Kty>
+    node_pointer _Find_with_finger(const _Kty & _Key, finger & _Finger) const noexcept
+    {
+        node_pointer * _Update_list = _Finger._Update_list;
+        size_type * _Rank_list = _Finger._Rank_list;
+
+        // 首次使用，或者键比上一个键小，从头节点开始
+        if (_Finger._List != this
+            || (_Update_list[0] != _Head && !_Comp(_Update_list[0]->data().first, _Key))) {
+            for (level_type _Level = 0; _Level <= _Max_level_index; ++_Level) {
+                _Update_list[_Level] = _Head;
+                _Rank_list[_Level] = 0;
+            }
+
+            _Finger._List = this;
+        }
+
+        // 从第0层向上，跳过所有前驱已经失效的层级
+        level_type _Level = 0;
+        while (_Level <= _Current_level_index && _Update_list[_Level]->forward(_Level) != nullptr
+               && _Comp(_Update_list[_Level]->forward(_Level)->data().first, _Key)) {
+            ++_Level;
+        }
+
+        if (_Level > 0) {
+            node_pointer _Cur = _Update_list[_Level - 1];
+            size_type _Traversed = _Rank_list[_Level - 1];
+
+            for (--_Level; _Level >= 0; --_Level) {
+                while (_Cur->forward(_Level) != nullptr && _Comp(_Cur->forward(_Level)->data().first, _Key)) {
+                    _Traversed += _Cur->span(_Level);
+                    _Cur = _Cur->forward(_Level);
+                }
+
+                _Update_list[_Level] = _Cur;
+                _Rank_list[_Level] = _Traversed;
+            }
+        }
+
+        return _Update_list[0]->forward(0);
+    }
+
+    /**
+     * @brief 从手指开始查找一个节点
+     * @param _Key 键
+     * @param _Finger 手指
+     * @return 节点指针
+     */
+    node_pointer _Find_from_finger(const key_type & _Key, finger & _Finger) const noexcept
+    {
+        node_pointer _Cur = _Find_with_finger(_Key, _Finger);
+
+        if (_Cur != nullptr && !_Comp(_Key, _Cur->data().first)) {
+            return _Cur;
+        }
+
+        return nullptr;
+    }
+
     /**
      * @brief 创建节点并插入
-     * @param _Pair 键值对
-     * @param _Update_list 前驱记录数组
+     * @param _Update_list 前驱记录数组，长度至少为`_Max_level_index + 1`
+     * @param _Rank_list 每一层前驱的排名，长度至少为`_Max_level_index + 1`
+     * @param _Arguments 键值对的构造参数
      * return 节点指针
      */
-    node_pointer _Create_and_insert(const pair_type & _Pair, std::vector<node_pointer> & _Update_list)
+    template <typename... _Args>
+    node_pointer _Create_and_insert(node_pointer * _Update_list, size_type * _Rank_list, _Args &&... _Arguments)
+    {
+        node_pointer _New_node = _Create_node(_Random_level_index(), std::forward<_Args>(_Arguments)...);
+        _Link_node(_New_node, _Update_list, _Rank_list);
+
+        return _New_node;
+    }
+
+    /**
+     * @brief 将已经创建的节点链接到前驱之后
+     * @param _New_node 节点指针
+     * @param _Update_list 前驱记录数组，长度至少为`_Max_level_index + 1`
+     * @param _Rank_list 每一层前驱的排名，长度至少为`_Max_level_index + 1`
+     */
+    void _Link_node(node_pointer _New_node, node_pointer * _Update_list, size_type * _Rank_list) noexcept
     {
-        // 创建新节点
-        level_type _New_level_index = _Random_level() - 1;
-        node_pointer _New_node = _Create_node(_Pair, _New_level_index);
+        level_type _New_level_index = _New_node->level();
 
         // 如果新节点层级大于当前最高层级，将多出来的这些层级加入更新列表中
         if (_New_level_index > _Current_level_index) {
             for (level_type _Level = _Current_level_index + 1; _Level <= _New_level_index; ++_Level) {
                 // 由于跳表的开头必须是头节点，所以多出来的高度的前置都指向头节点即可
                 _Update_list[_Level] = _Head;
+                _Rank_list[_Level] = 0;
             }
 
             // 更新最高层级
@@ -715,14 +2196,28 @@ private:
         // 开始遍历各层的前置节点并修改
         for (level_type _Level = 0; _Level <= _New_level_index; ++_Level) {
             // 将原来的指针添加到新节点中
-            _New_node->forward(_Level) = _Update_list[_Level]->forward(_Level);
+            _New_node->set_forward(_Level, _Update_list[_Level]->forward(_Level));
             // 将新节点添加到前置节点的向前列表中
-            _Update_list[_Level]->forward(_Level) = _New_node;
+            _Update_list[_Level]->set_forward(_Level, _New_node);
+
+            // 前驱到新节点的步数为两者排名之差，新节点接手前驱剩下的跨度
+            size_type _Distance = _Rank_list[0] - _Rank_list[_Level] + 1;
+            _New_node->span(_Level) = _Update_list[_Level]->span(_Level) + 1 - _Distance;
+            _Update_list[_Level]->span(_Level) = _Distance;
         }
 
-        ++_Size;
+        // 更高层级的前驱多跨过一个节点
+        for (level_type _Level = _New_level_index + 1; _Level <= _Current_level_index; ++_Level) {
+            ++_Update_list[_Level]->span(_Level);
+        }
 
-        return _New_node;
+        // 第0层的向后指针，前驱为头节点时为空
+        node_pointer _Next = _New_node->forward(0);
+        _New_node->backward() = _Update_list[0] == _Head ? nullptr : _Update_list[0];
+        (_Next == nullptr ? _Head : _Next)->backward() = _New_node;
+
+        ++_Size;
+        _Grow_level_cap();
     }
 
     /**
@@ -733,37 +2228,90 @@ private:
     template<typename _P>
     std::pair<iterator, bool> _Insert(_P && _Pair)
     {
-        // 使用一个数组来储存前一个结点的向前指针，为了避免越界，直接初始化大小为最大大小
-        std::vector<node_pointer> _Update_list(_Max_level_index + 1, nullptr);
-        node_pointer _Ptr = _Find_with_update(_Pair.first, _Update_list);
+        // 使用一个栈上数组来储存前一个结点的向前指针，大小为编译期的层级上限，不需要堆分配
+        node_pointer _Update_list[MAX_LEVEL_LIMIT];
+        size_type _Rank_list[MAX_LEVEL_LIMIT];
+        node_pointer _Ptr = _Find_with_update(_Pair.first, _Update_list, _Rank_list);
 
         // 判断是否已经存在
-        if (_Ptr != nullptr && _Ptr->data().first == _Pair.first) {
-            return {iterator(_Ptr), false};
+        if (_Ptr != nullptr && !_Comp(_Pair.first, _Ptr->data().first)) {
+            return {iterator(_Ptr, _Head), false};
         }
 
         // 不存在，创建并插入新节点
-        _Ptr = _Create_and_insert(std::forward<_P>(_Pair), _Update_list);
+        _Ptr = _Create_and_insert(_Update_list, _Rank_list, std::forward<_P>(_Pair));
+
+        return {iterator(_Ptr, _Head), true};
+    }
+
+    /**
+     * @brief 从手指开始查找插入位置，当不存在键时插入一个键值对
+     * @param _Pair 键值对
+     * @param _Finger 手指
+     * @return `std::pair<iterator, bool>`
+     */
+    template <typename _P>
+    std::pair<iterator, bool> _Insert(_P && _Pair, finger & _Finger)
+    {
+        node_pointer _Ptr = _Find_with_finger(_Pair.first, _Finger);
+
+        if (_Ptr != nullptr && !_Comp(_Pair.first, _Ptr->data().first)) {
+            return {iterator(_Ptr, _Head), false};
+        }
+
+        _Ptr = _Create_and_insert(_Finger._Update_list, _Finger._Rank_list, std::forward<_P>(_Pair));
 
-        return {iterator(_Ptr), true};
+        return {iterator(_Ptr, _Head), true};
     }
 
     /**
-     * @brief 获取值或插入
+     * @brief 当不存在键时，用键和参数在节点内原地构造键值对并插入
      * @param _Key 键
-     * return 值
+     * @param _Arguments 值的构造参数
+     * @return `std::pair<iterator, bool>`
      */
-    template <typename _K>
-    value_type & _Get_or_insert(_K && _Key)
+    template <typename _K, typename... _Args>
+    std::pair<iterator, bool> _Try_emplace(_K && _Key, _Args &&... _Arguments)
     {
-        std::vector<node_pointer> _Update_list(_Max_level_index + 1, nullptr);
-        node_pointer _Ptr = _Find_with_update(_Key, _Update_list);
-        if (_Ptr == nullptr || _Ptr->data().first != _Key) {
-            // 不存在该键，创建并插入
-            _Ptr = _Create_and_insert({_Key, value_type()}, _Update_list);
+        node_pointer _Update_list[MAX_LEVEL_LIMIT];
+        size_type _Rank_list[MAX_LEVEL_LIMIT];
+        node_pointer _Ptr = _Find_with_update(_Key, _Update_list, _Rank_list);
+
+        if (_Ptr != nullptr && !_Comp(_Key, _Ptr->data().first)) {
+            // 已经存在，参数不会被使用
+            return {iterator(_Ptr, _Head), false};
         }
 
-        return _Ptr->data().second;
+        _Ptr = _Create_and_insert(_Update_list, _Rank_list, std::piecewise_construct,
+                                  std::forward_as_tuple(std::forward<_K>(_Key)),
+                                  std::forward_as_tuple(std::forward<_Args>(_Arguments)...));
+
+        return {iterator(_Ptr, _Head), true};
+    }
+
+    /**
+     * @brief 键存在时赋值，不存在时原地构造并插入
+     * @param _Key 键
+     * @param _Obj 值
+     * @return `std::pair<iterator, bool>`，插入时为true，赋值时为false
+     */
+    template <typename _K, typename _Mapped>
+    std::pair<iterator, bool> _Insert_or_assign(_K && _Key, _Mapped && _Obj)
+    {
+        node_pointer _Update_list[MAX_LEVEL_LIMIT];
+        size_type _Rank_list[MAX_LEVEL_LIMIT];
+        node_pointer _Ptr = _Find_with_update(_Key, _Update_list, _Rank_list);
+
+        if (_Ptr != nullptr && !_Comp(_Key, _Ptr->data().first)) {
+            _Ptr->data().second = std::forward<_Mapped>(_Obj);
+            return {iterator(_Ptr, _Head), false};
+        }
+
+        _Ptr = _Create_and_insert(_Update_list, _Rank_list, std::piecewise_construct,
+                                  std::forward_as_tuple(std::forward<_K>(_Key)),
+                                  std::forward_as_tuple(std::forward<_Mapped>(_Obj)));
+
+        return {iterator(_Ptr, _Head), true};
     }
 
     /**
@@ -773,6 +2321,14 @@ private:
     {
         throw std::out_of_range("skiplist key not found");
     }
+
+    /**
+     * @brief 抛出键无序异常
+     */
+    [[noreturn]] void _Throw_unsorted() const
+    {
+        throw std::invalid_argument("skiplist keys are not sorted");
+    }
 };
 
 } // namespace WW
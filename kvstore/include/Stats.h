@@ -0,0 +1,430 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace WW
+{
+
+/**
+ * @brief 延迟直方图的桶个数
+ * @details 第0个桶为0纳秒，第i个桶为[2^(i-1), 2^i)纳秒，最后一个桶同时容纳所有更大的值
+ */
+constexpr std::size_t LATENCY_BUCKET_COUNT = 40;
+
+/**
+ * @brief 操作延迟的分布
+ */
+struct latency_snapshot
+{
+    std::uint64_t buckets[LATENCY_BUCKET_COUNT] = {};   // 每个桶的计数，不累计
+    std::uint64_t count = 0;                            // 操作次数
+    std::uint64_t sum = 0;                              // 总耗时，单位为纳秒
+
+    /**
+     * @brief 获取桶的上界
+     * @param _Bucket 桶下标
+     * @return 上界（不包含），单位为纳秒
+     */
+    static std::uint64_t upper_bound(std::size_t _Bucket) noexcept
+    {
+        return 1ull << _Bucket;
+    }
+
+    /**
+     * @brief 估计百分位数
+     * @details 返回第一个累计计数达到要求的桶的上界，最多高估一倍
+     * @param _Percent 百分比，范围为[0, 100]
+     * @return 百分位数，单位为纳秒
+     */
+    std::uint64_t percentile(double _Percent) const noexcept
+    {
+        double _Target = _Percent / 100.0 * static_cast<double>(count);
+        std::uint64_t _Seen = 0;
+
+        for (std::size_t _Bucket = 0; _Bucket < LATENCY_BUCKET_COUNT; ++_Bucket) {
+            _Seen += buckets[_Bucket];
+            if (_Seen != 0 && static_cast<double>(_Seen) >= _Target) {
+                return upper_bound(_Bucket);
+            }
+        }
+
+        return count == 0 ? 0 : upper_bound(LATENCY_BUCKET_COUNT - 1);
+    }
+};
+
+/**
+ * @brief KV储存的统计快照
+ * @details 操作计数、查找代价和延迟只有定义了`WW_KVSTORE_STATS`时才会记录，否则全部为0。
+ * 元素个数、塔高分布和内存占用在获取快照时遍历得到，不依赖该宏
+ */
+struct kvstore_stats
+{
+    bool enabled = false;                       // 是否记录了操作统计
+
+    std::uint64_t gets = 0;                     // 查询次数
+    std::uint64_t puts = 0;                     // 插入和更新次数
+    std::uint64_t removes = 0;                  // 删除次数
+    std::uint64_t hits = 0;                     // 查询命中次数
+    std::uint64_t misses = 0;                   // 查询未命中次数
+
+    std::uint64_t searches = 0;                 // 跳表自顶向下的查找次数
+    std::uint64_t search_levels = 0;            // 查找经过的层数之和
+    std::uint64_t search_comparisons = 0;       // 查找中键比较的次数之和
+
+    std::uint64_t size = 0;                     // 元素个数
+    std::vector<std::uint64_t> tower_heights;   // 下标i为有i+1层链接的节点个数
+    std::uint64_t key_bytes = 0;                // 键占用的字节数，包括键在堆上持有的内存
+    std::uint64_t value_bytes = 0;              // 值占用的字节数，包括值在堆上持有的内存
+    std::uint64_t tower_bytes = 0;              // 节点中键值对以外的部分，即链接和节点头
+
+    latency_snapshot get_latency;               // 查询延迟
+    latency_snapshot put_latency;               // 插入和更新延迟
+    latency_snapshot remove_latency;            // 删除延迟
+};
+
+/**
+ * @brief 跳表查找的线程局部计数
+ * @details 跳表在查找路径上累加，`KVStore`在操作前后取差值，计数不属于任何一个跳表，
+ * 各线程之间也没有共享
+ */
+struct _Search_trace
+{
+    std::uint64_t _Searches;        // 查找次数
+    std::uint64_t _Levels;          // 经过的层数
+    std::uint64_t _Comparisons;     // 比较次数
+
+    static _Search_trace & local() noexcept
+    {
+        static thread_local _Search_trace _Instance = {0, 0, 0};
+        return _Instance;
+    }
+};
+
+/**
+ * @brief 统计的操作类型
+ */
+enum class _Stats_op
+{
+    get,
+    put,
+    remove
+};
+
+#ifdef WW_KVSTORE_STATS
+
+/**
+ * @brief 操作统计的记录器
+ * @details 计数分散在若干个独占缓存行的条带中，每个线程固定使用其中一个，
+ * 线程数不超过条带数时互不竞争。获取快照时累加所有条带
+ */
+class _Stats_recorder
+{
+public:
+    static constexpr std::size_t STRIPE_COUNT = 8;      // 条带个数
+
+private:
+    enum _Counter
+    {
+        _Gets,
+        _Puts,
+        _Removes,
+        _Hits,
+        _Misses,
+        _Searches,
+        _Levels,
+        _Comparisons,
+        _Counter_count
+    };
+
+    struct alignas(64) _Stripe
+    {
+        std::atomic<std::uint64_t> _Counters[_Counter_count];
+        std::atomic<std::uint64_t> _Latency[3][LATENCY_BUCKET_COUNT];
+        std::atomic<std::uint64_t> _Latency_sum[3];
+    };
+
+    std::unique_ptr<_Stripe[]> _Stripes;    // 条带
+
+public:
+    /**
+     * @brief 一次操作的记录，析构时提交
+     */
+    class _Probe
+    {
+    private:
+        const _Stats_recorder * _Owner;
+        _Stats_op _Op;
+        int _Hit;                                               // -1表示不是查询
+        std::chrono::steady_clock::time_point _Start;
+        _Search_trace _Before;
+
+    public:
+        _Probe(const _Stats_recorder * _Owner, _Stats_op _Op) noexcept
+            : _Owner(_Owner)
+            , _Op(_Op)
+            , _Hit(-1)
+            , _Start(std::chrono::steady_clock::now())
+            , _Before(_Search_trace::local())
+        {
+        }
+
+        _Probe(const _Probe &) = delete;
+
+        _Probe & operator=(const _Probe &) = delete;
+
+        ~_Probe()
+        {
+            _Owner->_Commit(*this);
+        }
+
+        /**
+         * @brief 记录查询是否命中
+         * @param _Found 是否命中
+         */
+        void hit(bool _Found) noexcept
+        {
+            _Hit = _Found ? 1 : 0;
+        }
+
+        friend class _Stats_recorder;
+    };
+
+public:
+    _Stats_recorder()
+        : _Stripes(new _Stripe[STRIPE_COUNT]())
+    {
+    }
+
+public:
+    /**
+     * @brief 开始记录一次操作
+     * @param _Op 操作类型
+     * @return 记录，离开作用域时提交
+     */
+    _Probe begin(_Stats_op _Op) const noexcept
+    {
+        return _Probe(this, _Op);
+    }
+
+    /**
+     * @brief 把累计的统计写入快照
+     * @param _Stats 快照
+     */
+    void fill(kvstore_stats & _Stats) const noexcept
+    {
+        std::uint64_t _Totals[_Counter_count] = {};
+        latency_snapshot * _Latencies[3] = {&_Stats.get_latency, &_Stats.put_latency, &_Stats.remove_latency};
+
+        for (std::size_t _Index = 0; _Index < STRIPE_COUNT; ++_Index) {
+            const _Stripe & _Cur = _Stripes[_Index];
+
+            for (int _Counter = 0; _Counter < _Counter_count; ++_Counter) {
+                _Totals[_Counter] += _Cur._Counters[_Counter].load(std::memory_order_relaxed);
+            }
+
+            for (int _Op = 0; _Op < 3; ++_Op) {
+                for (std::size_t _Bucket = 0; _Bucket < LATENCY_BUCKET_COUNT; ++_Bucket) {
+                    std::uint64_t _Count = _Cur._Latency[_Op][_Bucket].load(std::memory_order_relaxed);
+                    _Latencies[_Op]->buckets[_Bucket] += _Count;
+                    _Latencies[_Op]->count += _Count;
+                }
+                _Latencies[_Op]->sum += _Cur._Latency_sum[_Op].load(std::memory_order_relaxed);
+            }
+        }
+
+        _Stats.enabled = true;
+        _Stats.gets = _Totals[_Gets];
+        _Stats.puts = _Totals[_Puts];
+        _Stats.removes = _Totals[_Removes];
+        _Stats.hits = _Totals[_Hits];
+        _Stats.misses = _Totals[_Misses];
+        _Stats.searches = _Totals[_Searches];
+        _Stats.search_levels = _Totals[_Levels];
+        _Stats.search_comparisons = _Totals[_Comparisons];
+    }
+
+private:
+    /**
+     * @brief 获取当前线程使用的条带
+     * @return 条带
+     */
+    _Stripe & _Local_stripe() const noexcept
+    {
+        static std::atomic<std::size_t> _Next(0);
+        static thread_local std::size_t _Index = _Next.fetch_add(1, std::memory_order_relaxed) % STRIPE_COUNT;
+        return _Stripes[_Index];
+    }
+
+    /**
+     * @brief 提交一次操作
+     * @details 条带可能被多个线程共用，但计数只需要最终正确，使用relaxed的原子加
+     * @param _Record 记录
+     */
+    void _Commit(const _Probe & _Record) const noexcept
+    {
+        auto _Elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - _Record._Start).count();
+        std::uint64_t _Nanoseconds = _Elapsed < 0 ? 0 : static_cast<std::uint64_t>(_Elapsed);
+
+        std::size_t _Bucket = _Bit_width(_Nanoseconds);
+        if (_Bucket >= LATENCY_BUCKET_COUNT) {
+            _Bucket = LATENCY_BUCKET_COUNT - 1;
+        }
+
+        const _Search_trace & _After = _Search_trace::local();
+        _Stripe & _Cur = _Local_stripe();
+        int _Op = static_cast<int>(_Record._Op);
+
+        _Cur._Counters[_Gets + _Op].fetch_add(1, std::memory_order_relaxed);
+        if (_Record._Hit >= 0) {
+            _Cur._Counters[_Record._Hit != 0 ? _Hits : _Misses].fetch_add(1, std::memory_order_relaxed);
+        }
+
+        _Cur._Counters[_Searches].fetch_add(_After._Searches - _Record._Before._Searches, std::memory_order_relaxed);
+        _Cur._Counters[_Levels].fetch_add(_After._Levels - _Record._Before._Levels, std::memory_order_relaxed);
+        _Cur._Counters[_Comparisons].fetch_add(_After._Comparisons - _Record._Before._Comparisons, std::memory_order_relaxed);
+
+        _Cur._Latency[_Op][_Bucket].fetch_add(1, std::memory_order_relaxed);
+        _Cur._Latency_sum[_Op].fetch_add(_Nanoseconds, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 计算表示一个整数需要的位数
+     * @param _Value 整数
+     * @return 位数，0为0
+     */
+    static std::size_t _Bit_width(std::uint64_t _Value) noexcept
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return _Value == 0 ? 0 : static_cast<std::size_t>(64 - __builtin_clzll(_Value));
+#else
+        std::size_t _Width = 0;
+        for (; _Value != 0; _Value >>= 1) {
+            ++_Width;
+        }
+        return _Width;
+#endif
+    }
+};
+
+#else
+
+/**
+ * @brief 未定义`WW_KVSTORE_STATS`时的空记录器，所有调用都在编译期消失
+ */
+class _Stats_recorder
+{
+public:
+    struct _Probe
+    {
+        // 提供析构函数，未使用的记录不会引起警告
+        ~_Probe()
+        {
+        }
+
+        void hit(bool) noexcept
+        {
+        }
+    };
+
+public:
+    _Probe begin(_Stats_op) const noexcept
+    {
+        return _Probe();
+    }
+
+    void fill(kvstore_stats &) const noexcept
+    {
+    }
+};
+
+#endif
+
+/**
+ * @brief 以Prometheus文本格式输出统计快照
+ * @param _Stats 快照
+ * @param _Prefix 指标名前缀
+ * @return 文本
+ */
+inline std::string to_prometheus(const kvstore_stats & _Stats, const std::string & _Prefix = "ww_kvstore")
+{
+    std::string _Out;
+
+    auto _Metric = [&](const char * _Name, const char * _Type, const char * _Help) {
+        _Out += "# HELP " + _Prefix + "_" + _Name + " " + _Help + "\n";
+        _Out += "# TYPE " + _Prefix + "_" + _Name + " " + _Type + "\n";
+    };
+
+    auto _Sample = [&](const char * _Name, const std::string & _Labels, std::uint64_t _Value) {
+        _Out += _Prefix + "_" + _Name + (_Labels.empty() ? "" : "{" + _Labels + "}") + " " + std::to_string(_Value) + "\n";
+    };
+
+    _Metric("operations_total", "counter", "Operations by type.");
+    _Sample("operations_total", "op=\"get\"", _Stats.gets);
+    _Sample("operations_total", "op=\"put\"", _Stats.puts);
+    _Sample("operations_total", "op=\"remove\"", _Stats.removes);
+
+    _Metric("get_results_total", "counter", "Lookups by result.");
+    _Sample("get_results_total", "result=\"hit\"", _Stats.hits);
+    _Sample("get_results_total", "result=\"miss\"", _Stats.misses);
+
+    _Metric("searches_total", "counter", "Top-down skiplist searches.");
+    _Sample("searches_total", "", _Stats.searches);
+    _Metric("search_levels_total", "counter", "Levels descended by skiplist searches.");
+    _Sample("search_levels_total", "", _Stats.search_levels);
+    _Metric("search_comparisons_total", "counter", "Key comparisons made by skiplist searches.");
+    _Sample("search_comparisons_total", "", _Stats.search_comparisons);
+
+    _Metric("keys", "gauge", "Number of keys, including expired keys not yet purged.");
+    _Sample("keys", "", _Stats.size);
+
+    _Metric("tower_height_nodes", "gauge", "Nodes by number of levels.");
+    for (std::size_t _Height = 0; _Height < _Stats.tower_heights.size(); ++_Height) {
+        if (_Stats.tower_heights[_Height] != 0) {
+            _Sample("tower_height_nodes", "height=\"" + std::to_string(_Height + 1) + "\"", _Stats.tower_heights[_Height]);
+        }
+    }
+
+    _Metric("memory_bytes", "gauge", "Bytes used by keys, values and skiplist towers.");
+    _Sample("memory_bytes", "part=\"keys\"", _Stats.key_bytes);
+    _Sample("memory_bytes", "part=\"values\"", _Stats.value_bytes);
+    _Sample("memory_bytes", "part=\"towers\"", _Stats.tower_bytes);
+
+    // 直方图的桶是累计的，上界换算为秒
+    _Metric("operation_duration_seconds", "histogram", "Operation latency.");
+    const std::pair<const char *, const latency_snapshot *> _Latencies[] = {
+        {"get", &_Stats.get_latency}, {"put", &_Stats.put_latency}, {"remove", &_Stats.remove_latency}
+    };
+
+    for (const auto & _Entry : _Latencies) {
+        const std::string _Op = std::string("op=\"") + _Entry.first + "\"";
+        std::uint64_t _Cumulative = 0;
+
+        for (std::size_t _Bucket = 0; _Bucket + 1 < LATENCY_BUCKET_COUNT; ++_Bucket) {
+            _Cumulative += _Entry.second->buckets[_Bucket];
+
+            char _Bound[32];
+            std::snprintf(_Bound, sizeof(_Bound), "%.9g", static_cast<double>(latency_snapshot::upper_bound(_Bucket)) * 1e-9);
+            _Sample("operation_duration_seconds_bucket", _Op + ",le=\"" + _Bound + "\"", _Cumulative);
+        }
+
+        _Sample("operation_duration_seconds_bucket", _Op + ",le=\"+Inf\"", _Entry.second->count);
+
+        char _Sum[32];
+        std::snprintf(_Sum, sizeof(_Sum), "%.9g", static_cast<double>(_Entry.second->sum) * 1e-9);
+        _Out += _Prefix + "_operation_duration_seconds_sum{" + _Op + "} " + _Sum + "\n";
+        _Sample("operation_duration_seconds_count", _Op, _Entry.second->count);
+    }
+
+    return _Out;
+}
+
+} // namespace WW
@@ -0,0 +1,535 @@
+#pragma once
+
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <Checksum.h>
+#include <Codec.h>
+
+namespace WW
+{
+
+/**
+ * @brief 预写日志的持久化方式
+ */
+enum class wal_sync_mode
+{
+    none,           // 只写入操作系统缓冲区，不主动刷盘
+    periodic,       // 后台线程按固定间隔刷盘
+    batch           // 每批写入后刷盘，写操作返回时已经持久化
+};
+
+/**
+ * @brief 预写日志选项
+ */
+struct wal_options
+{
+    std::string path;                                                   // 日志文件路径
+    wal_sync_mode sync_mode = wal_sync_mode::batch;                     // 持久化方式
+    std::chrono::milliseconds sync_interval = std::chrono::milliseconds(100);   // periodic模式下的刷盘间隔
+};
+
+/**
+ * @brief 预写日志
+ * @details 只追加写入的日志文件，每条记录的格式为：
+ * `crc32c(4) | length(4) | type(1) | payload(length)`，校验和覆盖type和payload。
+ * 多个线程同时写入时采用组提交：先到达的线程成为领导者，把所有已缓冲的记录一次写入并刷盘，
+ * 其余线程等待领导者完成，从而把多次刷盘合并为一次。记录按持久化方式写入之后，
+ * 对内存结构的修改才按记录的顺序依次生效，写入失败时修改不会生效
+ */
+class _Write_ahead_log
+{
+public:
+    using size_type = std::size_t;
+    using sequence_type = std::uint64_t;
+
+    /**
+     * @brief 记录类型
+     */
+    enum record_type : unsigned char
+    {
+        set_record = 1,     // 设置键值对
+        erase_record = 2,   // 删除键
+        insert_record = 3,  // 键不存在时插入键值对
+        expire_record = 4   // 设置或清除键的过期时间
+    };
+
+    static constexpr size_type HEADER_SIZE = 9;                 // 记录头大小
+    static constexpr size_type MAX_RECORD_SIZE = 1u << 30;      // 单条记录的最大长度
+
+private:
+    wal_options _Options;                   // 选项
+    int _Fd;                                // 文件描述符
+
+    std::mutex _Mutex;                      // 保护以下成员
+    std::condition_variable _Written;       // 一批记录写入完成
+    std::string _Buffer;                    // 等待写入的记录
+    sequence_type _Appended;                // 已缓冲的最后一条记录的序号
+    sequence_type _Durable;                 // 已写入的最后一条记录的序号
+    sequence_type _Applied;                 // 修改已经生效的最后一条记录的序号
+    std::condition_variable _Applied_signal;    // 一条记录的修改生效
+    bool _Writing;                          // 是否有领导者正在写入
+    bool _Dirty;                            // 是否有写入尚未刷盘
+    int _Error;                             // 写入失败时的错误码
+
+    std::condition_variable _Stop_signal;   // 通知后台线程退出
+    bool _Stopping;                         // 后台线程是否需要退出
+    std::thread _Sync_thread;               // periodic模式下的后台刷盘线程
+
+public:
+    explicit _Write_ahead_log(const wal_options & _Options)
+        : _Options(_Options)
+        , _Fd(-1)
+        , _Appended(0)
+        , _Durable(0)
+        , _Applied(0)
+        , _Writing(false)
+        , _Dirty(false)
+        , _Error(0)
+        , _Stopping(false)
+    {
+    }
+
+    _Write_ahead_log(const _Write_ahead_log &) = delete;
+
+    _Write_ahead_log & operator=(const _Write_ahead_log &) = delete;
+
+    ~_Write_ahead_log()
+    {
+        close();
+    }
+
+public:
+    /**
+     * @brief 重放日志并打开文件用于追加
+     * @details 遇到不完整或校验失败的记录时停止重放，并截断从该记录开始的内容
+     * @param _Callback 回调，参数为记录类型、负载起始和末尾，返回false表示负载无法解析
+     * @return 重放的记录个数
+     */
+    template <typename _Fn>
+    size_type open(_Fn _Callback)
+    {
+        size_type _Count = 0;
+        off_t _Valid_size = 0;
+
+        std::FILE * _File = std::fopen(_Options.path.c_str(), "rb");
+        if (_File != nullptr) {
+            _Count = _Replay(_File, _Callback, _Valid_size);
+            std::fclose(_File);
+        }
+
+        _Fd = ::open(_Options.path.c_str(), O_WRONLY | O_CREAT, 0644);
+        if (_Fd < 0) {
+            _Throw_system_error("wal open");
+        }
+
+        // 丢弃末尾损坏的部分，之后的追加从有效位置开始
+        if (::ftruncate(_Fd, _Valid_size) != 0 || ::lseek(_Fd, _Valid_size, SEEK_SET) < 0) {
+            int _Code = errno;
+            ::close(_Fd);
+            _Fd = -1;
+            errno = _Code;
+            _Throw_system_error("wal truncate");
+        }
+
+        if (_Options.sync_mode == wal_sync_mode::periodic) {
+            _Sync_thread = std::thread(&_Write_ahead_log::_Periodic_sync, this);
+        }
+
+        return _Count;
+    }
+
+    /**
+     * @brief 关闭日志，写出缓冲的记录并刷盘
+     */
+    void close() noexcept
+    {
+        if (_Sync_thread.joinable()) {
+            {
+                std::lock_guard<std::mutex> _Lock(_Mutex);
+                _Stopping = true;
+            }
+            _Stop_signal.notify_all();
+            _Sync_thread.join();
+        }
+
+        if (_Fd >= 0) {
+            std::unique_lock<std::mutex> _Lock(_Mutex);
+            _Written.wait(_Lock, [this] { return !_Writing; });
+
+            if (!_Buffer.empty() && _Error == 0) {
+                _Write_all(_Buffer.data(), _Buffer.size());
+            }
+            _Buffer.clear();
+
+            if (_Options.sync_mode != wal_sync_mode::none) {
+                ::fdatasync(_Fd);
+            }
+
+            ::close(_Fd);
+            _Fd = -1;
+        }
+    }
+
+    /**
+     * @brief 判断日志是否已经打开
+     * @return 是否打开
+     */
+    bool is_open() const noexcept
+    {
+        return _Fd >= 0;
+    }
+
+    /**
+     * @brief 获取选项
+     * @return 选项
+     */
+    const wal_options & options() const noexcept
+    {
+        return _Options;
+    }
+
+    /**
+     * @brief 编码一条记录
+     * @param _Type 记录类型
+     * @param _Payload 负载
+     * @return 完整的记录
+     */
+    static std::string encode(record_type _Type, const std::string & _Payload)
+    {
+        std::string _Record(HEADER_SIZE, '\0');
+        _Record[8] = static_cast<char>(_Type);
+        _Record.append(_Payload);
+
+        std::uint32_t _Crc = _Crc32c(_Record.data() + 8, _Record.size() - 8);
+        std::uint32_t _Length = static_cast<std::uint32_t>(_Payload.size());
+        std::memcpy(&_Record[0], &_Crc, sizeof(_Crc));
+        std::memcpy(&_Record[4], &_Length, sizeof(_Length));
+
+        return _Record;
+    }
+
+    /**
+     * @brief 编码一条设置键值对的记录
+     * @param _Key 键
+     * @param _Value 值
+     * @return 完整的记录
+     */
+    template <typename _Ty_key, typename _Ty_value>
+    static std::string encode_set(const _Ty_key & _Key, const _Ty_value & _Value)
+    {
+        std::string _Payload;
+        _Codec<_Ty_key>::encode(_Payload, _Key);
+        _Codec<_Ty_value>::encode(_Payload, _Value);
+        return encode(set_record, _Payload);
+    }
+
+    /**
+     * @brief 编码一条键不存在时插入键值对的记录
+     * @details 用于无法预先确定插入能否成功的并发写入，重放时按相同的顺序得到相同的结果
+     * @param _Key 键
+     * @param _Value 值
+     * @return 完整的记录
+     */
+    template <typename _Ty_key, typename _Ty_value>
+    static std::string encode_insert(const _Ty_key & _Key, const _Ty_value & _Value)
+    {
+        std::string _Payload;
+        _Codec<_Ty_key>::encode(_Payload, _Key);
+        _Codec<_Ty_value>::encode(_Payload, _Value);
+        return encode(insert_record, _Payload);
+    }
+
+    /**
+     * @brief 编码一条删除键的记录
+     * @param _Key 键
+     * @return 完整的记录
+     */
+    template <typename _Ty_key>
+    static std::string encode_erase(const _Ty_key & _Key)
+    {
+        std::string _Payload;
+        _Codec<_Ty_key>::encode(_Payload, _Key);
+        return encode(erase_record, _Payload);
+    }
+
+    /**
+     * @brief 编码一条设置或清除过期时间的记录
+     * @param _Key 键
+     * @param _Wall_deadline 系统时钟的过期时间，自纪元起的纳秒数，为0时清除过期时间
+     * @return 完整的记录
+     */
+    template <typename _Ty_key>
+    static std::string encode_expire(const _Ty_key & _Key, std::uint64_t _Wall_deadline)
+    {
+        std::string _Payload;
+        _Codec<_Ty_key>::encode(_Payload, _Key);
+        _Codec<std::uint64_t>::encode(_Payload, _Wall_deadline);
+        return encode(expire_record, _Payload);
+    }
+
+    /**
+     * @brief 解析一条记录的负载并分发
+     * @param _Type 记录类型
+     * @param _First 负载起始
+     * @param _Last 负载末尾
+     * @param _Set 设置键值对的回调，参数为键和值
+     * @param _Insert 键不存在时插入键值对的回调，参数为键和值
+     * @param _Erase 删除键的回调，参数为键
+     * @param _Expire 设置过期时间的回调，参数为键和系统时钟的过期时间，为0时清除
+     * @return 是否解析成功
+     */
+    template <typename _Ty_key, typename _Ty_value, typename _Fn_set, typename _Fn_insert, typename _Fn_erase, typename _Fn_expire>
+    static bool decode(record_type _Type, const char * _First, const char * _Last,
+                       _Fn_set _Set, _Fn_insert _Insert, _Fn_erase _Erase, _Fn_expire _Expire)
+    {
+        _Ty_key _Key = _Ty_key();
+
+        if (!_Codec<_Ty_key>::decode(_First, _Last, _Key)) {
+            return false;
+        }
+
+        switch (_Type) {
+        case set_record:
+        case insert_record: {
+            _Ty_value _Value = _Ty_value();
+            if (!_Codec<_Ty_value>::decode(_First, _Last, _Value)) {
+                return false;
+            }
+
+            if (_Type == set_record) {
+                _Set(_Key, _Value);
+            } else {
+                _Insert(_Key, _Value);
+            }
+            return true;
+        }
+        case erase_record:
+            _Erase(_Key);
+            return true;
+        case expire_record: {
+            std::uint64_t _Wall_deadline = 0;
+            if (!_Codec<std::uint64_t>::decode(_First, _Last, _Wall_deadline)) {
+                return false;
+            }
+            _Expire(_Key, _Wall_deadline);
+            return true;
+        }
+        default:
+            return false;
+        }
+    }
+
+    /**
+     * @brief 追加记录，等待它们按持久化方式写入后再执行修改
+     * @details 写入失败时抛出异常，`_Apply`不会执行，内存结构与日志保持一致。
+     * 各次追加的`_Apply`按记录的顺序依次执行，保证重放得到相同的结果，但不持有日志的锁，
+     * 不妨碍其他线程缓冲记录。因此调用者需要在追加之前确定要写入的记录，
+     * 不产生修改的操作可以不追加
+     * @param _Record 由`encode`得到的一条或多条记录
+     * @param _Apply 对内存结构的修改
+     * @return `_Apply`的返回值
+     */
+    template <typename _Fn>
+    auto append(const std::string & _Record, _Fn _Apply) -> decltype(_Apply())
+    {
+        std::unique_lock<std::mutex> _Lock(_Mutex);
+        _Check_error();
+
+        _Buffer.append(_Record);
+        sequence_type _Sequence = ++_Appended;
+
+        while (_Durable < _Sequence) {
+            _Check_error();
+
+            if (_Writing) {
+                // 已经有领导者，等待它写完后再检查
+                _Written.wait(_Lock);
+                continue;
+            }
+
+            // 成为领导者，把当前缓冲的所有记录作为一批写出
+            _Writing = true;
+            std::string _Batch;
+            _Batch.swap(_Buffer);
+            sequence_type _Batch_end = _Appended;
+            _Lock.unlock();
+
+            int _Code = 0;
+            if (!_Write_all(_Batch.data(), _Batch.size())) {
+                _Code = errno;
+            } else if (_Options.sync_mode == wal_sync_mode::batch && ::fdatasync(_Fd) != 0) {
+                _Code = errno;
+            }
+
+            _Lock.lock();
+            _Writing = false;
+            _Dirty = true;
+            if (_Code != 0) {
+                _Error = _Code;
+            } else {
+                _Durable = _Batch_end;
+            }
+            _Written.notify_all();
+        }
+
+        // 之前的记录都已写入，等待它们的修改依次生效
+        _Applied_signal.wait(_Lock, [this, _Sequence] { return _Applied + 1 == _Sequence; });
+        _Lock.unlock();
+
+        // 修改抛出异常时同样轮到下一条记录
+        struct _Turn_guard
+        {
+            _Write_ahead_log * _Log;
+
+            ~_Turn_guard()
+            {
+                std::lock_guard<std::mutex> _Guard(_Log->_Mutex);
+                ++_Log->_Applied;
+                _Log->_Applied_signal.notify_all();
+            }
+        } _Guard{this};
+
+        return _Apply();
+    }
+
+    /**
+     * @brief 清空日志
+     * @details 调用者需要保证此时没有并发的`append`
+     */
+    void reset()
+    {
+        std::lock_guard<std::mutex> _Lock(_Mutex);
+        _Buffer.clear();
+
+        if (::ftruncate(_Fd, 0) != 0 || ::lseek(_Fd, 0, SEEK_SET) < 0 || ::fsync(_Fd) != 0) {
+            _Throw_system_error("wal reset");
+        }
+    }
+
+private:
+    /**
+     * @brief 逐条读取记录并回调
+     * @param _File 文件
+     * @param _Callback 回调
+     * @param _Valid_size 用于接收有效内容的长度
+     * @return 记录个数
+     */
+    template <typename _Fn>
+    static size_type _Replay(std::FILE * _File, _Fn & _Callback, off_t & _Valid_size)
+    {
+        size_type _Count = 0;
+        std::string _Payload;
+        unsigned char _Header[HEADER_SIZE];
+
+        while (std::fread(_Header, 1, HEADER_SIZE, _File) == HEADER_SIZE) {
+            std::uint32_t _Crc = 0;
+            std::uint32_t _Length = 0;
+            std::memcpy(&_Crc, _Header, sizeof(_Crc));
+            std::memcpy(&_Length, _Header + 4, sizeof(_Length));
+
+            if (_Length > MAX_RECORD_SIZE) {
+                break;
+            }
+
+            _Payload.resize(_Length);
+            if (_Length != 0 && std::fread(&_Payload[0], 1, _Length, _File) != _Length) {
+                // 记录不完整，通常是写入过程中崩溃
+                break;
+            }
+
+            std::uint32_t _Actual = _Crc32c(_Header + 8, 1);
+            _Actual = _Crc32c(_Payload.data(), _Payload.size(), _Actual);
+            if (_Actual != _Crc) {
+                break;
+            }
+
+            record_type _Type = static_cast<record_type>(_Header[8]);
+            if (!_Callback(_Type, _Payload.data(), _Payload.data() + _Payload.size())) {
+                break;
+            }
+
+            _Valid_size += static_cast<off_t>(HEADER_SIZE + _Length);
+            ++_Count;
+        }
+
+        return _Count;
+    }
+
+    /**
+     * @brief 写出全部数据
+     * @param _Data 数据
+     * @param _Size 字节数
+     * @return 是否成功
+     */
+    bool _Write_all(const char * _Data, size_type _Size) noexcept
+    {
+        while (_Size > 0) {
+            ssize_t _Written_size = ::write(_Fd, _Data, _Size);
+            if (_Written_size < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return false;
+            }
+
+            _Data += _Written_size;
+            _Size -= static_cast<size_type>(_Written_size);
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief periodic模式下的后台刷盘
+     */
+    void _Periodic_sync()
+    {
+        std::unique_lock<std::mutex> _Lock(_Mutex);
+
+        while (!_Stopping) {
+            _Stop_signal.wait_for(_Lock, _Options.sync_interval);
+
+            if (_Dirty) {
+                _Dirty = false;
+                _Lock.unlock();
+                ::fdatasync(_Fd);
+                _Lock.lock();
+            }
+        }
+    }
+
+    /**
+     * @brief 之前的写入失败时抛出异常
+     */
+    void _Check_error() const
+    {
+        if (_Error != 0) {
+            throw std::system_error(_Error, std::generic_category(), "wal write");
+        }
+    }
+
+    /**
+     * @brief 根据errno抛出异常
+     * @param _What 描述
+     */
+    [[noreturn]] static void _Throw_system_error(const char * _What)
+    {
+        throw std::system_error(errno, std::generic_category(), _What);
+    }
+};
+
+} // namespace WW
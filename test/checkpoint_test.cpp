@@ -0,0 +1,210 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+#include <KVStore.h>
+
+class CheckpointTest : public testing::Test
+{
+protected:
+    std::string path;
+    std::string wal_path;
+
+    void SetUp() override
+    {
+        std::string prefix = testing::TempDir() + "ww_kvstore_checkpoint_" + std::to_string(::getpid());
+        path = prefix + ".ckpt";
+        wal_path = prefix + ".log";
+        std::remove(path.c_str());
+        std::remove(wal_path.c_str());
+    }
+
+    void TearDown() override
+    {
+        std::remove(path.c_str());
+        std::remove(wal_path.c_str());
+    }
+};
+
+TEST_F(CheckpointTest, RoundTrip)
+{
+    WW::KVStore<std::string, std::string> store;
+    for (int i = 0; i < 10000; ++i) {
+        store.put("user:" + std::to_string(i), "value" + std::to_string(i));
+    }
+    EXPECT_EQ(store.checkpoint(path), 10000);
+
+    WW::KVStore<std::string, std::string> loaded;
+    loaded.put("stale", "x");
+    EXPECT_EQ(loaded.load(path), 10000);
+    EXPECT_FALSE(loaded.contains("stale"));
+    EXPECT_EQ(loaded.get("user:0"), "value0");
+    EXPECT_EQ(loaded.get("user:9999"), "value9999");
+
+    // 加载后的跳表可以继续修改
+    EXPECT_TRUE(loaded.put("user:10000", "value10000"));
+    EXPECT_TRUE(loaded.remove("user:5000"));
+    EXPECT_EQ(loaded.size(), 10000);
+}
+
+TEST_F(CheckpointTest, EmptyStore)
+{
+    WW::KVStore<int, int> store;
+    EXPECT_EQ(store.checkpoint(path), 0);
+
+    WW::KVStore<int, int> loaded;
+    EXPECT_EQ(loaded.load(path), 0);
+    EXPECT_TRUE(loaded.empty());
+}
+
+TEST_F(CheckpointTest, RejectCorruptedFile)
+{
+    {
+        WW::KVStore<int, int> store;
+        for (int i = 0; i < 5000; ++i) {
+            store.put(i, i);
+        }
+        store.checkpoint(path);
+    }
+
+    // 破坏第一个数据块
+    std::FILE * file = std::fopen(path.c_str(), "r+b");
+    ASSERT_NE(file, nullptr);
+    std::fseek(file, 16, SEEK_SET);
+    std::fputc(0x7F, file);
+    std::fclose(file);
+
+    WW::KVStore<int, int> loaded;
+    EXPECT_THROW(loaded.load(path), std::runtime_error);
+    EXPECT_THROW(loaded.load(path + ".missing"), std::system_error);
+}
+
+TEST_F(CheckpointTest, RecoverWithWriteAheadLog)
+{
+    WW::wal_options options;
+    options.path = wal_path;
+
+    {
+        WW::KVStore<std::string, std::string> store;
+        store.open(options);
+        store.put("a", "1");
+        store.put("b", "2");
+
+        // 检查点之后日志被清空，只保留之后的修改
+        store.checkpoint(path);
+        store.update("a", "3");
+        store.remove("b");
+    }
+
+    WW::KVStore<std::string, std::string> store;
+    EXPECT_EQ(store.load(path), 2);
+    EXPECT_EQ(store.open(options), 2);
+    EXPECT_EQ(store.get("a"), "3");
+    EXPECT_FALSE(store.contains("b"));
+}
+
+TEST_F(CheckpointTest, LockFreeRoundTrip)
+{
+    using lock_free_store = WW::KVStore<int, std::string, std::less<int>, std::allocator<std::pair<const int, std::string>>, WW::lock_free_policy>;
+
+    lock_free_store store;
+    for (int i = 0; i < 10000; ++i) {
+        store.put(i, std::to_string(i));
+    }
+    EXPECT_EQ(store.checkpoint(path), 10000);
+
+    lock_free_store loaded;
+    loaded.put(-1, "stale");
+    EXPECT_EQ(loaded.load(path), 10000);
+    EXPECT_FALSE(loaded.contains(-1));
+    EXPECT_EQ(loaded.get(1234), "1234");
+
+    EXPECT_TRUE(loaded.remove(0));
+    EXPECT_TRUE(loaded.put(10000, "10000"));
+    EXPECT_EQ(loaded.size(), 10000);
+
+    int expected = 1;
+    for (auto it = loaded.begin(); it != loaded.end(); ++it) {
+        EXPECT_EQ(it->first, expected++);
+    }
+    EXPECT_EQ(expected, 10001);
+}
+
+TEST_F(CheckpointTest, SequentialIntegerKeysCompress)
+{
+    // 键按大端序保存，相邻的键只有最后一个字节不同
+    const std::uint64_t count = 100000;
+    WW::KVStore<std::uint64_t, std::uint64_t> store;
+    for (std::uint64_t i = 0; i < count; ++i) {
+        store.put(i, i);
+    }
+    EXPECT_EQ(store.checkpoint(path), count);
+
+    struct stat file_stat;
+    ASSERT_EQ(::stat(path.c_str(), &file_stat), 0);
+    EXPECT_LT(static_cast<std::uint64_t>(file_stat.st_size), count * 2 * sizeof(std::uint64_t));
+
+    WW::KVStore<std::uint64_t, std::uint64_t> loaded;
+    EXPECT_EQ(loaded.load(path), count);
+    EXPECT_EQ(loaded.get(0), 0);
+    EXPECT_EQ(loaded.get(count - 1), count - 1);
+}
+
+TEST_F(CheckpointTest, SignedKeysKeepOrder)
+{
+    WW::KVStore<int, int> store;
+    for (int i = -5000; i < 5000; ++i) {
+        store.put(i, i);
+    }
+    store.checkpoint(path);
+
+    // 从只读快照中按块查找，依赖键的顺序
+    WW::KVStore<int, int, std::less<int>, std::allocator<std::pair<const int, int>>, WW::mapped_snapshot_policy> snapshot(path);
+    EXPECT_EQ(snapshot.get(-5000), -5000);
+    EXPECT_EQ(snapshot.get(-1), -1);
+    EXPECT_EQ(snapshot.get(4999), 4999);
+    EXPECT_FALSE(snapshot.contains(5000));
+
+    int expected = -5000;
+    snapshot.for_each([&expected](const int & key, const int & value) {
+        EXPECT_EQ(key, expected++);
+        EXPECT_EQ(value, key);
+    });
+    EXPECT_EQ(expected, 5000);
+}
+
+TEST_F(CheckpointTest, KeepDeadlines)
+{
+    using namespace std::chrono_literals;
+    WW::KVStore<std::string, std::string> store;
+    store.put("forever", "a");
+    store.put("later", "b", 1h);
+    store.put("soon", "c", 20ms);
+    EXPECT_EQ(store.checkpoint(path), 3);
+    std::this_thread::sleep_for(40ms);
+
+    WW::KVStore<std::string, std::string> loaded;
+    EXPECT_EQ(loaded.load(path), 2);
+    EXPECT_FALSE(loaded.ttl("forever").has_value());
+    EXPECT_TRUE(loaded.ttl("later").has_value());
+    EXPECT_GT(*loaded.ttl("later"), 59min);
+    EXPECT_FALSE(loaded.contains("soon"));
+
+    // 只读快照中过期的键不可见
+    using snapshot_type = WW::KVStore<std::string, std::string, std::less<std::string>,
+        std::allocator<std::pair<const std::string, std::string>>, WW::mapped_snapshot_policy>;
+    snapshot_type snapshot(path);
+    EXPECT_TRUE(snapshot.contains("later"));
+    EXPECT_FALSE(snapshot.contains("soon"));
+
+    int visible = 0;
+    snapshot.for_each([&visible](const std::string &, const std::string &) { ++visible; });
+    EXPECT_EQ(visible, 2);
+}
@@ -0,0 +1,212 @@
+#include <atomic>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <ConcurrentSkipList.h>
+#include <KVStore.h>
+
+class ConcurrentSkipListTest : public testing::Test {
+public:
+    WW::_Concurrent_skiplist<std::string, std::string> _Skiplist;
+};
+
+TEST_F(ConcurrentSkipListTest, InsertAndGet)
+{
+    EXPECT_TRUE(_Skiplist.insert("a", "b"));
+    EXPECT_TRUE(_Skiplist.insert("c", "d"));
+    EXPECT_FALSE(_Skiplist.insert("a", "e"));
+    EXPECT_EQ(_Skiplist.size(), 2);
+
+    std::string value;
+    EXPECT_TRUE(_Skiplist.get("a", value));
+    EXPECT_EQ(value, "b");
+    EXPECT_FALSE(_Skiplist.get("x", value));
+
+    // 替换值
+    EXPECT_FALSE(_Skiplist.insert_or_assign("a", "f"));
+    EXPECT_TRUE(_Skiplist.insert_or_assign("g", "h"));
+    EXPECT_TRUE(_Skiplist.assign("c", "i"));
+    EXPECT_FALSE(_Skiplist.assign("z", "i"));
+    EXPECT_TRUE(_Skiplist.get("a", value));
+    EXPECT_EQ(value, "f");
+    EXPECT_TRUE(_Skiplist.get("c", value));
+    EXPECT_EQ(value, "i");
+    EXPECT_EQ(_Skiplist.size(), 3);
+}
+
+TEST_F(ConcurrentSkipListTest, EraseAndContains)
+{
+    _Skiplist.insert("a", "b");
+    _Skiplist.insert("c", "d");
+
+    EXPECT_EQ(_Skiplist.erase("a"), 1);
+    EXPECT_EQ(_Skiplist.erase("a"), 0);
+    EXPECT_FALSE(_Skiplist.contains("a"));
+    EXPECT_TRUE(_Skiplist.contains("c"));
+    EXPECT_EQ(_Skiplist.size(), 1);
+
+    // 删除后可以重新插入
+    EXPECT_TRUE(_Skiplist.insert("a", "e"));
+    EXPECT_TRUE(_Skiplist.contains("a"));
+}
+
+TEST_F(ConcurrentSkipListTest, Iterator)
+{
+    _Skiplist.insert("e", "f");
+    _Skiplist.insert("a", "b");
+    _Skiplist.insert("c", "d");
+    _Skiplist.erase("c");
+
+    auto it = _Skiplist.begin();
+    EXPECT_EQ(it->first, "a");
+    EXPECT_EQ(it->second, "b");
+    ++it;
+    EXPECT_EQ((*it).first, "e");
+    ++it;
+    EXPECT_EQ(it, _Skiplist.end());
+}
+
+TEST(ConcurrentSkipListStressTest, DisjointInsertAndErase)
+{
+    WW::_Concurrent_skiplist<int, int> skiplist;
+    const int threads = 8;
+    const int per_thread = 5000;
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&skiplist, t, threads, per_thread] {
+            for (int i = 0; i < per_thread; ++i) {
+                EXPECT_TRUE(skiplist.insert(i * threads + t, t));
+            }
+            // 删除自己插入的偶数键
+            for (int i = 0; i < per_thread; i += 2) {
+                EXPECT_EQ(skiplist.erase(i * threads + t), 1);
+            }
+        });
+    }
+
+    for (auto & worker : workers) {
+        worker.join();
+    }
+
+    EXPECT_EQ(skiplist.size(), static_cast<std::size_t>(threads * per_thread / 2));
+
+    // 剩余的键有序且完整
+    int previous = -1;
+    std::size_t count = 0;
+    for (auto it = skiplist.begin(); it != skiplist.end(); ++it) {
+        EXPECT_LT(previous, it->first);
+        EXPECT_EQ((it->first / threads) % 2, 1);
+        previous = it->first;
+        ++count;
+    }
+    EXPECT_EQ(count, skiplist.size());
+}
+
+TEST(ConcurrentSkipListStressTest, ContendedKeys)
+{
+    WW::_Concurrent_skiplist<int, std::string> skiplist;
+    const int threads = 8;
+    const int keys = 64;
+    const int rounds = 20000;
+    std::atomic<bool> stop(false);
+
+    // 写线程在少量键上竞争插入、更新和删除
+    std::vector<std::thread> writers;
+    for (int t = 0; t < threads; ++t) {
+        writers.emplace_back([&skiplist, t, keys, rounds] {
+            for (int i = 0; i < rounds; ++i) {
+                int key = (i * 7 + t) % keys;
+                switch ((i + t) % 3) {
+                case 0:
+                    skiplist.insert(key, std::to_string(key));
+                    break;
+                case 1:
+                    skiplist.insert_or_assign(key, std::to_string(key));
+                    break;
+                default:
+                    skiplist.erase(key);
+                    break;
+                }
+            }
+        });
+    }
+
+    // 读线程在修改期间遍历，检查有序并且值与键一致
+    std::thread reader([&skiplist, &stop] {
+        while (!stop.load()) {
+            int previous = -1;
+            for (auto it = skiplist.begin(); it != skiplist.end(); ++it) {
+                EXPECT_LT(previous, it->first);
+                EXPECT_EQ(it->second, std::to_string(it->first));
+                previous = it->first;
+            }
+
+            std::string value;
+            if (skiplist.get(7, value)) {
+                EXPECT_EQ(value, "7");
+            }
+        }
+    });
+
+    for (auto & writer : writers) {
+        writer.join();
+    }
+    stop.store(true);
+    reader.join();
+
+    // 静止后大小与遍历结果一致
+    std::size_t count = 0;
+    for (auto it = skiplist.begin(); it != skiplist.end(); ++it) {
+        EXPECT_TRUE(skiplist.contains(it->first));
+        ++count;
+    }
+    EXPECT_EQ(count, skiplist.size());
+}
+
+TEST(LockFreeKVStoreTest, Basic)
+{
+    WW::KVStore<std::string, std::string, std::less<std::string>, std::allocator<std::pair<const std::string, std::string>>, WW::lock_free_policy> store;
+
+    EXPECT_TRUE(store.put("name", "Alice"));
+    EXPECT_FALSE(store.put("name", "Bob"));
+    EXPECT_EQ(store.get("name"), "Alice");
+    EXPECT_EQ(store.get("unknown"), std::nullopt);
+    EXPECT_EQ(store.get_or_default("unknown", "none"), "none");
+    EXPECT_FALSE(store.contains("unknown"));
+
+    EXPECT_TRUE(store.update("name", "Bob"));
+    EXPECT_EQ(store.get("name"), "Bob");
+    EXPECT_EQ(store.size(), 1);
+
+    EXPECT_TRUE(store.remove("name"));
+    EXPECT_FALSE(store.remove("name"));
+    EXPECT_TRUE(store.empty());
+}
+
+TEST(LockFreeKVStoreTest, Scan)
+{
+    WW::KVStore<std::string, std::string, std::less<std::string>, std::allocator<std::pair<const std::string, std::string>>, WW::lock_free_policy> store;
+
+    for (int i = 0; i < 10; ++i) {
+        store.put("key" + std::to_string(i), std::to_string(i));
+    }
+    store.put("other", "x");
+    store.remove("key5");
+
+    std::string visited;
+    auto collect = [&visited](const std::string &, const std::string & value) { visited += value; };
+
+    EXPECT_EQ(store.scan("key3", "key7", 100, collect), 3);
+    EXPECT_EQ(visited, "346");
+
+    visited.clear();
+    EXPECT_EQ(store.prefix_scan("key", 100, collect), 9);
+    EXPECT_EQ(visited, "012346789");
+
+    EXPECT_EQ(store.lower_bound("key55")->first, "key6");
+    EXPECT_EQ(store.lower_bound("zzz"), store.end());
+}
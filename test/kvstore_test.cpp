@@ -1,4 +1,11 @@
+#include <chrono>
+#include <functional>
+#include <numeric>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
 
 #include <gtest/gtest.h>
 #include <KVStore.h>
@@ -22,8 +29,27 @@ TEST_F(KVStoreTest, PutAndGet)
     EXPECT_EQ(store.get("name"), "Alice");
     EXPECT_EQ(store.get("city"), "NYC");
 
-    // 获取不存在的值返回默认值
-    EXPECT_EQ(store.get("unknown"), "");
+    // 获取不存在的值返回空，且不会插入
+    EXPECT_EQ(store.get("unknown"), std::nullopt);
+    EXPECT_FALSE(store.contains("unknown"));
+    EXPECT_EQ(store.size(), 2);
+}
+
+TEST_F(KVStoreTest, GetOrDefaultAndGetInto)
+{
+    store.put("name", "Alice");
+
+    EXPECT_EQ(store.get_or_default("name"), "Alice");
+    EXPECT_EQ(store.get_or_default("unknown"), "");
+    EXPECT_EQ(store.get_or_default("unknown", "none"), "none");
+
+    std::string value = "old";
+    EXPECT_FALSE(store.get_into("unknown", value));
+    EXPECT_EQ(value, "old");
+    EXPECT_TRUE(store.get_into("name", value));
+    EXPECT_EQ(value, "Alice");
+
+    EXPECT_EQ(store.size(), 1);
 }
 
 TEST_F(KVStoreTest, Update)
@@ -71,3 +97,339 @@ TEST_F(KVStoreTest, SizeAndEmpty)
     EXPECT_TRUE(store.empty());
     EXPECT_EQ(store.size(), 0);
 }
+
+TEST(KVStoreCompareTest, TransparentContains)
+{
+    WW::KVStore<std::string, std::string, std::less<>> store;
+    store.put("name", "Alice");
+
+    EXPECT_TRUE(store.contains(std::string_view("name")));
+    EXPECT_FALSE(store.contains(std::string_view("city")));
+    EXPECT_TRUE(store.contains("name"));
+}
+
+TEST_F(KVStoreTest, Scan)
+{
+    for (int i = 0; i < 10; ++i) {
+        store.put("key" + std::to_string(i), std::to_string(i));
+    }
+
+    std::string visited;
+    auto collect = [&visited](const std::string &, const std::string & value) { visited += value; };
+
+    EXPECT_EQ(store.scan("key3", "key7", 100, collect), 4);
+    EXPECT_EQ(visited, "3456");
+
+    visited.clear();
+    EXPECT_EQ(store.scan("key35", "zzz", 2, collect), 2);
+    EXPECT_EQ(visited, "45");
+
+    visited.clear();
+    EXPECT_EQ(store.scan("key9", "key0", 100, collect), 0);
+    EXPECT_EQ(visited, "");
+}
+
+TEST_F(KVStoreTest, PrefixScan)
+{
+    store.put("user:1", "a");
+    store.put("user:2", "b");
+    store.put("user:10", "c");
+    store.put("users", "d");
+    store.put("video:1", "e");
+    store.put(std::string("\xff\xff", 2), "f");
+
+    std::string visited;
+    auto collect = [&visited](const std::string &, const std::string & value) { visited += value; };
+
+    EXPECT_EQ(store.prefix_scan("user:", 100, collect), 3);
+    EXPECT_EQ(visited, "acb");
+
+    visited.clear();
+    EXPECT_EQ(store.prefix_scan("user", 100, collect), 4);
+    EXPECT_EQ(visited, "acbd");
+
+    // 前缀没有后继时一直遍历到末尾
+    visited.clear();
+    EXPECT_EQ(store.prefix_scan(std::string("\xff", 1), 100, collect), 1);
+    EXPECT_EQ(visited, "f");
+
+    visited.clear();
+    EXPECT_EQ(store.prefix_scan("", 2, collect), 2);
+    EXPECT_EQ(visited, "ac");
+}
+
+TEST_F(KVStoreTest, ReverseScan)
+{
+    for (int i = 0; i < 10; ++i) {
+        store.put("key" + std::to_string(i), std::to_string(i));
+    }
+
+    std::string visited;
+    auto collect = [&visited](const std::string &, const std::string & value) { visited += value; };
+
+    EXPECT_EQ(store.reverse_scan("key3", "key7", 100, collect), 4);
+    EXPECT_EQ(visited, "6543");
+
+    // 终点之前的最后两个键
+    visited.clear();
+    EXPECT_EQ(store.reverse_scan("", "key55", 2, collect), 2);
+    EXPECT_EQ(visited, "54");
+
+    visited.clear();
+    EXPECT_EQ(store.reverse_scan("", "zzz", 100, collect), 10);
+    EXPECT_EQ(visited, "9876543210");
+
+    visited.clear();
+    EXPECT_EQ(store.reverse_scan("key5", "key5", 100, collect), 0);
+    EXPECT_EQ(store.reverse_scan("", "a", 100, collect), 0);
+    EXPECT_EQ(visited, "");
+}
+
+TEST_F(KVStoreTest, RankAndSelect)
+{
+    for (int i = 0; i < 10; ++i) {
+        store.put("key" + std::to_string(i), std::to_string(i));
+    }
+
+    EXPECT_EQ(store.rank("key0"), 0);
+    EXPECT_EQ(store.rank("key35"), 4);
+    EXPECT_EQ(store.rank("zzz"), 10);
+    EXPECT_EQ(store.count_range("key2", "key5"), 3);
+    EXPECT_EQ(store.count_range("key5", "key2"), 0);
+
+    std::string key;
+    std::string value;
+    EXPECT_TRUE(store.select(7, key, value));
+    EXPECT_EQ(key, "key7");
+    EXPECT_EQ(value, "7");
+    EXPECT_FALSE(store.select(10, key, value));
+
+    // 分页
+    std::string visited;
+    auto collect = [&visited](const std::string &, const std::string & value) { visited += value; };
+    EXPECT_EQ(store.scan(4, 3, collect), 3);
+    EXPECT_EQ(visited, "456");
+
+    visited.clear();
+    EXPECT_EQ(store.scan(8, 5, collect), 2);
+    EXPECT_EQ(visited, "89");
+    EXPECT_EQ(store.scan(10, 5, collect), 0);
+}
+
+TEST_F(KVStoreTest, MultiOperations)
+{
+    // 乱序且包含重复键，重复时先出现的生效
+    EXPECT_EQ(store.multi_put({{"d", "4"}, {"a", "1"}, {"c", "3"}, {"a", "x"}, {"b", "2"}}), 4);
+    EXPECT_EQ(store.multi_put({{"a", "y"}, {"e", "5"}}), 1);
+    EXPECT_EQ(store.size(), 5);
+
+    std::vector<std::string> values;
+    EXPECT_EQ(store.multi_get({"e", "missing", "a", "c", "a"}, values), 4);
+    EXPECT_EQ(values, (std::vector<std::string>{"5", "", "1", "3", "1"}));
+
+    EXPECT_EQ(store.multi_remove({"c", "zz", "a", "c"}), 2);
+    EXPECT_EQ(store.size(), 3);
+    EXPECT_FALSE(store.contains("a"));
+    EXPECT_FALSE(store.contains("c"));
+
+    EXPECT_EQ(store.multi_get({}, values), 0);
+    EXPECT_TRUE(values.empty());
+}
+
+TEST_F(KVStoreTest, MoveValues)
+{
+    std::string key = "name";
+    std::string value(1000, 'a');
+
+    EXPECT_TRUE(store.put(key, std::move(value)));
+    EXPECT_EQ(store.get_or_default("name"), std::string(1000, 'a'));
+
+    // 插入失败时值保持不变
+    value.assign(1000, 'b');
+    EXPECT_FALSE(store.put(std::string("name"), std::move(value)));
+    EXPECT_EQ(value, std::string(1000, 'b'));
+
+    EXPECT_TRUE(store.update(key, std::move(value)));
+    EXPECT_EQ(store.get_or_default("name"), std::string(1000, 'b'));
+    EXPECT_TRUE(store.update(std::string("city"), std::string("NYC")));
+    EXPECT_EQ(store.get("city"), "NYC");
+}
+
+TEST_F(KVStoreTest, Expire)
+{
+    using namespace std::chrono_literals;
+
+    EXPECT_TRUE(store.put("session", "a", 1h));
+    EXPECT_TRUE(store.put("short", "b", 20ms));
+    EXPECT_TRUE(store.put("gone", "c", 0ms));
+    EXPECT_TRUE(store.put("plain", "d"));
+
+    // 立即过期的键不可见，重复插入仍然失败
+    EXPECT_FALSE(store.put("session", "x", 1h));
+    EXPECT_EQ(store.get("gone"), std::nullopt);
+    EXPECT_FALSE(store.contains("gone"));
+
+    EXPECT_EQ(store.get("session"), "a");
+    EXPECT_GT(*store.ttl("session"), 59min);
+    EXPECT_EQ(store.ttl("plain"), std::nullopt);
+    EXPECT_EQ(store.ttl("gone"), std::nullopt);
+    EXPECT_EQ(store.ttl("unknown"), std::nullopt);
+
+    // 设置、清除过期时间
+    EXPECT_TRUE(store.expire("plain", 1h));
+    EXPECT_TRUE(store.ttl("plain").has_value());
+    EXPECT_TRUE(store.persist("plain"));
+    EXPECT_FALSE(store.persist("plain"));
+    EXPECT_EQ(store.ttl("plain"), std::nullopt);
+    EXPECT_FALSE(store.expire("unknown", 1h));
+    EXPECT_FALSE(store.expire("gone", 1h));
+
+    std::this_thread::sleep_for(60ms);
+    EXPECT_EQ(store.get_or_default("short", "none"), "none");
+
+    // 遍历跳过过期键
+    std::vector<std::string> keys;
+    store.scan("a", "z", 10, [&](const std::string & key, const std::string &) {
+        keys.push_back(key);
+    });
+    EXPECT_EQ(keys, (std::vector<std::string>{"plain", "session"}));
+
+    // 过期的键可以重新插入，新值没有过期时间
+    EXPECT_TRUE(store.put("short", "e"));
+    EXPECT_EQ(store.get("short"), "e");
+    EXPECT_EQ(store.ttl("short"), std::nullopt);
+
+    // 更新清除过期时间
+    EXPECT_TRUE(store.update("session", "f"));
+    EXPECT_EQ(store.ttl("session"), std::nullopt);
+
+    // 删除已过期的键返回false
+    EXPECT_FALSE(store.remove("gone"));
+    EXPECT_EQ(store.size(), 3);
+}
+
+TEST_F(KVStoreTest, Sweep)
+{
+    using namespace std::chrono_literals;
+
+    // 插入会顺带清理，先插入再设置过期
+    for (int i = 0; i < 100; ++i) {
+        store.put("key" + std::to_string(i), "value", 1h);
+    }
+    for (int i = 0; i < 100; i += 2) {
+        store.expire("key" + std::to_string(i), 0ms);
+    }
+
+    EXPECT_EQ(store.size(), 100);
+
+    // 每次最多清理给定个数
+    EXPECT_EQ(store.sweep(10), 10);
+    EXPECT_EQ(store.size(), 90);
+    EXPECT_EQ(store.sweep(), 40);
+    EXPECT_EQ(store.sweep(), 0);
+    EXPECT_EQ(store.size(), 50);
+
+    // 写操作顺带清理
+    for (int i = 0; i < 50; ++i) {
+        store.expire("key" + std::to_string(i * 2 + 1), 0ms);
+    }
+    store.put("other", "value");
+    EXPECT_EQ(store.size(), (51 - WW::KVStore<std::string, std::string>::EXPIRE_STEP));
+
+    std::vector<std::string> keys{"key1", "key3", "other"};
+    EXPECT_EQ(store.multi_remove(keys), 1);
+}
+
+TEST_F(KVStoreTest, MemoryLimit)
+{
+    const std::string value(100, 'v');
+
+    // 每个键值对约200字节，预算约容纳50个
+    store.set_memory_limit(10000);
+    EXPECT_EQ(store.memory_usage(), 0);
+
+    for (int i = 0; i < 1000; ++i) {
+        store.put("key" + std::to_string(i), value);
+        store.update("key" + std::to_string(i / 2), value + value);
+        if (i % 7 == 0) {
+            store.remove("key" + std::to_string(i - 1));
+        }
+        EXPECT_LE(store.memory_usage(), store.memory_limit());
+    }
+
+    EXPECT_GT(store.evictions(), 0);
+    EXPECT_GT(store.size(), 10);
+    EXPECT_LT(store.size(), 100);
+
+    // 增量统计与重新统计一致
+    std::size_t usage = store.memory_usage();
+    store.set_memory_limit(10000);
+    EXPECT_EQ(store.memory_usage(), usage);
+
+    // 取消预算后不再统计
+    store.set_memory_limit(0);
+    EXPECT_EQ(store.memory_usage(), 0);
+}
+
+TEST(KVStoreEvictionTest, KeepsHotKey)
+{
+    for (WW::eviction_policy policy : {WW::eviction_policy::lru, WW::eviction_policy::lfu}) {
+        WW::KVStore<std::string, std::string> store;
+        const std::string value(100, 'v');
+
+        store.set_memory_limit(10000, policy);
+        store.put("hot", value);
+
+        for (int i = 0; i < 2000; ++i) {
+            store.put("key" + std::to_string(i), value);
+            EXPECT_TRUE(store.get("hot").has_value()) << i;
+        }
+
+        EXPECT_GE(store.evictions(), 1900);
+    }
+}
+
+TEST(KVStoreEvictionTest, PutWithTtlReportsEviction)
+{
+    using namespace std::chrono_literals;
+    WW::KVStore<std::string, std::string> store;
+    const std::string value(100, 'v');
+
+    store.set_memory_limit(10000, WW::eviction_policy::lfu);
+    for (int i = 0; i < 100; ++i) {
+        store.put("key" + std::to_string(i), value);
+    }
+
+    // 立即过期的键最先被淘汰，不能留下过期时间
+    EXPECT_FALSE(store.put("doomed", std::string(1000, 'v'), 0ms));
+    EXPECT_FALSE(store.contains("doomed"));
+    EXPECT_EQ(store.sweep(), 0);
+
+    // 返回值与键是否存在一致
+    for (int i = 0; i < 1000; ++i) {
+        std::string key = "ttl" + std::to_string(i);
+        if (store.put(key, value, 1h)) {
+            EXPECT_TRUE(store.ttl(key).has_value()) << i;
+        } else {
+            EXPECT_FALSE(store.contains(key)) << i;
+        }
+    }
+}
+
+// 打开WWSTATS时由stats_test覆盖
+#ifndef WW_KVSTORE_STATS
+TEST_F(KVStoreTest, StatsWithoutCounters)
+{
+    store.put("name", "Alice");
+    store.get("name");
+
+    // 未定义WW_KVSTORE_STATS时不记录操作，但结构信息仍然可用
+    WW::kvstore_stats stats = store.stats();
+    EXPECT_FALSE(stats.enabled);
+    EXPECT_EQ(stats.gets, 0);
+    EXPECT_EQ(stats.searches, 0);
+    EXPECT_EQ(stats.size, 1);
+    EXPECT_EQ(std::accumulate(stats.tower_heights.begin(), stats.tower_heights.end(), std::uint64_t(0)), 1);
+    EXPECT_GT(stats.key_bytes, 0);
+}
+#endif
@@ -0,0 +1,137 @@
+#include <cstdio>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+#include <KVStore.h>
+
+using snapshot_store = WW::KVStore<std::string, std::string, std::less<std::string>, std::allocator<std::pair<const std::string, std::string>>,
+                                   WW::mapped_snapshot_policy>;
+
+class MappedSnapshotTest : public testing::Test
+{
+protected:
+    std::string path;
+
+    void SetUp() override
+    {
+        path = testing::TempDir() + "ww_kvstore_snapshot_" + std::to_string(::getpid()) + ".ckpt";
+
+        WW::KVStore<std::string, std::string> store;
+        for (int i = 0; i < 10000; i += 2) {
+            char key[16];
+            std::snprintf(key, sizeof(key), "key%05d", i);
+            store.put(key, "value" + std::to_string(i));
+        }
+        store.checkpoint(path);
+    }
+
+    void TearDown() override
+    {
+        std::remove(path.c_str());
+    }
+};
+
+TEST_F(MappedSnapshotTest, GetAndContains)
+{
+    snapshot_store store(path);
+    EXPECT_EQ(store.size(), 5000);
+    EXPECT_FALSE(store.empty());
+
+    EXPECT_EQ(store.get("key00000"), "value0");
+    EXPECT_EQ(store.get("key09998"), "value9998");
+    EXPECT_EQ(store.get("key04242"), "value4242");
+    EXPECT_TRUE(store.contains("key01000"));
+
+    // 不存在的键：小于所有键、位于中间、大于所有键
+    EXPECT_EQ(store.get("a"), std::nullopt);
+    EXPECT_EQ(store.get_or_default("key00001", "none"), "none");
+    EXPECT_FALSE(store.contains("key00001"));
+    EXPECT_FALSE(store.contains("key09999"));
+    EXPECT_FALSE(store.contains("z"));
+}
+
+TEST_F(MappedSnapshotTest, Scan)
+{
+    snapshot_store store(path);
+
+    std::vector<std::string> keys;
+    auto collect = [&keys](const std::string & key, const std::string &) { keys.push_back(key); };
+
+    EXPECT_EQ(store.scan("key00009", "key00020", 100, collect), 5);
+    EXPECT_EQ(keys, (std::vector<std::string>{"key00010", "key00012", "key00014", "key00016", "key00018"}));
+
+    keys.clear();
+    EXPECT_EQ(store.scan("key09000", "z", 3, collect), 3);
+    EXPECT_EQ(keys.front(), "key09000");
+
+    std::size_t count = 0;
+    std::string last;
+    bool sorted = true;
+    store.for_each([&](const std::string & key, const std::string &) {
+        sorted = sorted && last < key;
+        last = key;
+        ++count;
+    });
+    EXPECT_EQ(count, 5000);
+    EXPECT_TRUE(sorted);
+}
+
+TEST_F(MappedSnapshotTest, PrefixScan)
+{
+    snapshot_store store(path);
+
+    std::vector<std::string> keys;
+    auto collect = [&keys](const std::string & key, const std::string &) { keys.push_back(key); };
+
+    EXPECT_EQ(store.prefix_scan("key0012", 100, collect), 5);
+    EXPECT_EQ(keys.front(), "key00120");
+    EXPECT_EQ(keys.back(), "key00128");
+
+    keys.clear();
+    EXPECT_EQ(store.prefix_scan("nothing", 100, collect), 0);
+    EXPECT_TRUE(keys.empty());
+}
+
+TEST_F(MappedSnapshotTest, ConcurrentReaders)
+{
+    snapshot_store store(path);
+
+    std::vector<std::thread> readers;
+    std::vector<int> hits(4, 0);
+    for (int t = 0; t < 4; ++t) {
+        readers.emplace_back([&store, &hits, t] {
+            for (int i = 0; i < 10000; ++i) {
+                char key[16];
+                std::snprintf(key, sizeof(key), "key%05d", i);
+                hits[t] += store.contains(key) ? 1 : 0;
+            }
+        });
+    }
+    for (auto & reader : readers) {
+        reader.join();
+    }
+
+    for (int t = 0; t < 4; ++t) {
+        EXPECT_EQ(hits[t], 5000);
+    }
+}
+
+TEST_F(MappedSnapshotTest, DetectCorruptedBlock)
+{
+    std::FILE * file = std::fopen(path.c_str(), "r+b");
+    ASSERT_NE(file, nullptr);
+    std::fseek(file, 16, SEEK_SET);
+    std::fputc(0x7F, file);
+    std::fclose(file);
+
+    // 打开时只校验索引，数据块在第一次访问时校验
+    snapshot_store store(path);
+    EXPECT_THROW(store.contains("key00002"), std::runtime_error);
+    EXPECT_THROW(snapshot_store(path + ".missing"), std::system_error);
+}
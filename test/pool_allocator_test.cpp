@@ -0,0 +1,148 @@
+#include <array>
+#include <string>
+
+#include <gtest/gtest.h>
+#include <PoolAllocator.h>
+#include <KVStore.h>
+
+TEST(PoolResourceTest, ReuseFreedBlock)
+{
+    WW::_Pool_resource resource;
+
+    void * a = resource.allocate(40);
+    void * b = resource.allocate(40);
+    EXPECT_NE(a, b);
+    EXPECT_EQ(resource.chunk_count(), 1);
+    EXPECT_EQ(resource.bytes_in_use(), 96);
+
+    // 同一大小等级的内存会被复用
+    resource.deallocate(a, 40);
+    void * c = resource.allocate(33);
+    EXPECT_EQ(a, c);
+
+    resource.deallocate(b, 40);
+    resource.deallocate(c, 33);
+    EXPECT_EQ(resource.bytes_in_use(), 0);
+}
+
+TEST(PoolResourceTest, LargeBlock)
+{
+    WW::_Pool_resource resource;
+
+    // 大块内存不经过内存页
+    void * p = resource.allocate(WW::_Pool_resource::MAX_BLOCK_SIZE + 1);
+    void * q = resource.allocate(WW::_Pool_resource::MAX_BLOCK_SIZE * 2);
+    void * r = resource.allocate(WW::_Pool_resource::MAX_BLOCK_SIZE * 3);
+    EXPECT_EQ(resource.chunk_count(), 0);
+    EXPECT_EQ(resource.large_block_count(), 3);
+
+    // 从链表中间、头部和尾部摘除
+    resource.deallocate(q, WW::_Pool_resource::MAX_BLOCK_SIZE * 2);
+    resource.deallocate(r, WW::_Pool_resource::MAX_BLOCK_SIZE * 3);
+    resource.deallocate(p, WW::_Pool_resource::MAX_BLOCK_SIZE + 1);
+    EXPECT_EQ(resource.large_block_count(), 0);
+
+    // 未归还的大块内存由release释放
+    resource.allocate(WW::_Pool_resource::MAX_BLOCK_SIZE + 1);
+    resource.allocate(WW::_Pool_resource::MAX_BLOCK_SIZE + 1);
+    resource.release();
+    EXPECT_EQ(resource.large_block_count(), 0);
+}
+
+TEST(PoolResourceTest, Release)
+{
+    WW::_Pool_resource resource;
+
+    for (int i = 0; i < 10000; ++i) {
+        resource.allocate(64);
+    }
+    EXPECT_GT(resource.chunk_count(), 1);
+
+    resource.release();
+    EXPECT_EQ(resource.chunk_count(), 0);
+    EXPECT_EQ(resource.bytes_in_use(), 0);
+}
+
+TEST(PoolAllocatorTest, RebindSharesResource)
+{
+    WW::_Pool_allocator<int> a;
+    WW::_Pool_allocator<double> b(a);
+    WW::_Pool_allocator<int> c;
+
+    EXPECT_TRUE(a == b);
+    EXPECT_FALSE(a == c);
+    EXPECT_FALSE(a.exclusive());
+    EXPECT_TRUE(c.exclusive());
+}
+
+TEST(PoolAllocatorTest, Skiplist)
+{
+    using allocator = WW::_Pool_allocator<std::pair<const std::string, std::string>>;
+    WW::_Skiplist<std::string, std::string, std::less<std::string>, allocator> skiplist;
+
+    for (int i = 0; i < 1000; ++i) {
+        skiplist.insert({std::to_string(i), std::to_string(i)});
+    }
+    EXPECT_EQ(skiplist.size(), 1000);
+    EXPECT_GT(skiplist.get_allocator().resource().bytes_in_use(), 0);
+
+    skiplist.erase("500");
+    EXPECT_FALSE(skiplist.contains("500"));
+
+    // 独占内存池时批量释放
+    skiplist.clear();
+    EXPECT_TRUE(skiplist.empty());
+    EXPECT_EQ(skiplist.get_allocator().resource().chunk_count(), 0);
+
+    skiplist.insert({"a", "b"});
+    EXPECT_EQ(skiplist.at("a"), "b");
+}
+
+TEST(PoolAllocatorTest, SkiplistLargeNodes)
+{
+    // 节点超过MAX_BLOCK_SIZE，批量释放时也要归还
+    using value_type = std::array<char, 600>;
+    using allocator = WW::_Pool_allocator<std::pair<const int, value_type>>;
+    WW::_Skiplist<int, value_type, std::less<int>, allocator> skiplist;
+
+    for (int i = 0; i < 100; ++i) {
+        skiplist.insert({i, value_type()});
+    }
+    EXPECT_EQ(skiplist.get_allocator().resource().large_block_count(), 100);
+
+    skiplist.erase(50);
+    EXPECT_EQ(skiplist.get_allocator().resource().large_block_count(), 99);
+
+    skiplist.clear();
+    EXPECT_EQ(skiplist.get_allocator().resource().large_block_count(), 0);
+
+    skiplist.insert({1, value_type()});
+    EXPECT_TRUE(skiplist.contains(1));
+}
+
+TEST(PoolAllocatorTest, SharedResourceIsNotReleased)
+{
+    using allocator = WW::_Pool_allocator<std::pair<const int, int>>;
+    allocator shared;
+    WW::_Skiplist<int, int, std::less<int>, allocator> first(shared);
+    WW::_Skiplist<int, int, std::less<int>, allocator> second(shared);
+
+    first.insert({1, 1});
+    second.insert({2, 2});
+
+    // 内存池被共享，clear只能逐个归还节点
+    first.clear();
+    EXPECT_TRUE(first.empty());
+    EXPECT_EQ(second.at(2), 2);
+}
+
+TEST(PoolAllocatorTest, KVStore)
+{
+    using allocator = WW::_Pool_allocator<std::pair<const std::string, std::string>>;
+    WW::KVStore<std::string, std::string, std::less<std::string>, allocator> store;
+
+    EXPECT_TRUE(store.put("name", "Alice"));
+    EXPECT_EQ(store.get("name"), "Alice");
+    EXPECT_TRUE(store.remove("name"));
+    EXPECT_TRUE(store.empty());
+}
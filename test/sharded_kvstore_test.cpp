@@ -0,0 +1,153 @@
+#include <algorithm>
+#include <cstdio>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <PoolAllocator.h>
+#include <ShardedKVStore.h>
+
+class ShardedKVStoreTest : public testing::Test
+{
+protected:
+    WW::ShardedKVStore<std::string, std::string> store{8};
+};
+
+TEST_F(ShardedKVStoreTest, PointOperations)
+{
+    EXPECT_EQ(store.shard_count(), 8);
+
+    EXPECT_TRUE(store.put("name", "Alice"));
+    EXPECT_FALSE(store.put("name", "Bob"));
+    EXPECT_EQ(store.get("name"), "Alice");
+    EXPECT_EQ(store.get("unknown"), std::nullopt);
+    EXPECT_FALSE(store.contains("unknown"));
+
+    EXPECT_EQ(store.get_or_default("name"), "Alice");
+    EXPECT_EQ(store.get_or_default("unknown", "none"), "none");
+
+    std::string value = "old";
+    EXPECT_FALSE(store.get_into("unknown", value));
+    EXPECT_EQ(value, "old");
+    EXPECT_TRUE(store.get_into("name", value));
+    EXPECT_EQ(value, "Alice");
+
+    EXPECT_TRUE(store.update("name", "Bob"));
+    EXPECT_EQ(store.get("name"), "Bob");
+
+    EXPECT_TRUE(store.remove("name"));
+    EXPECT_FALSE(store.remove("name"));
+    EXPECT_TRUE(store.empty());
+}
+
+TEST_F(ShardedKVStoreTest, OrderedIteration)
+{
+    for (int i = 99; i >= 0; --i) {
+        char key[16];
+        std::snprintf(key, sizeof(key), "k%02d", i);
+        store.put(key, std::to_string(i));
+    }
+    EXPECT_EQ(store.size(), 100);
+
+    // 跨分片归并后仍然有序
+    std::vector<std::string> keys;
+    store.for_each([&keys](const std::string & key, const std::string &) {
+        keys.push_back(key);
+    });
+    ASSERT_EQ(keys.size(), 100);
+    EXPECT_TRUE(std::is_sorted(keys.begin(), keys.end()));
+}
+
+TEST_F(ShardedKVStoreTest, Scan)
+{
+    for (int i = 0; i < 100; ++i) {
+        char key[16];
+        std::snprintf(key, sizeof(key), "k%02d", i);
+        store.put(key, std::to_string(i));
+    }
+
+    std::vector<std::string> values;
+    auto collect = [&values](const std::string &, const std::string & value) {
+        values.push_back(value);
+    };
+
+    // [k10, k20)
+    EXPECT_EQ(store.scan("k10", "k20", 100, collect), 10);
+    ASSERT_EQ(values.size(), 10);
+    EXPECT_EQ(values.front(), "10");
+    EXPECT_EQ(values.back(), "19");
+
+    // 限制个数
+    values.clear();
+    EXPECT_EQ(store.scan("k50", "k99", 3, collect), 3);
+    EXPECT_EQ(values, (std::vector<std::string>{"50", "51", "52"}));
+
+    // 空范围
+    values.clear();
+    EXPECT_EQ(store.scan("x", "z", 10, collect), 0);
+}
+
+TEST(ShardedKVStoreConcurrencyTest, ConcurrentWriters)
+{
+    WW::ShardedKVStore<int, int> store(4);
+    const int threads = 8;
+    const int per_thread = 2000;
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&store, t, threads, per_thread] {
+            for (int i = 0; i < per_thread; ++i) {
+                store.put(i * threads + t, t);
+                store.get(i);
+            }
+        });
+    }
+
+    // 写入期间做有序遍历
+    std::thread reader([&store] {
+        for (int round = 0; round < 20; ++round) {
+            int previous = -1;
+            store.for_each([&previous](const int & key, const int &) {
+                EXPECT_LT(previous, key);
+                previous = key;
+            });
+        }
+    });
+
+    for (auto & worker : workers) {
+        worker.join();
+    }
+    reader.join();
+
+    EXPECT_EQ(store.size(), static_cast<std::size_t>(threads * per_thread));
+}
+
+TEST(ShardedKVStoreConcurrencyTest, PoolAllocatorPerShard)
+{
+    // 内存池不是线程安全的，每个分片要有自己的内存池
+    using allocator = WW::_Pool_allocator<std::pair<const int, std::string>>;
+    WW::ShardedKVStore<int, std::string, std::hash<int>, allocator> store(4);
+    const int threads = 8;
+    const int per_thread = 2000;
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&store, t, threads, per_thread] {
+            for (int i = 0; i < per_thread; ++i) {
+                store.put(i * threads + t, std::string(64, 'v'));
+                store.update(i * threads + t, std::string(32, 'w'));
+                if (i % 3 == 0) {
+                    store.remove(i * threads + t);
+                }
+            }
+        });
+    }
+    for (auto & worker : workers) {
+        worker.join();
+    }
+
+    EXPECT_EQ(store.size(), static_cast<std::size_t>(threads * (per_thread - (per_thread + 2) / 3)));
+    EXPECT_EQ(store.get(threads + 1), std::string(32, 'w'));
+}
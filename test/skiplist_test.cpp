@@ -1,4 +1,13 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <random>
 #include <string>
+#include <string_view>
+#include <vector>
 
 #include <gtest/gtest.h>
 #include <SkipList.h>
@@ -127,4 +136,705 @@ TEST_F(SkipListTest, FindAndContains)
     EXPECT_TRUE(_Skiplist.contains("c"));
     EXPECT_TRUE(_Skiplist.contains("e"));
     EXPECT_FALSE(_Skiplist.contains("g"));
-}
\ No newline at end of file
+}
+TEST(SkipListLevelTest, MaxLevelLimit)
+{
+    // 超过上限的最大层级会被限制，插入时前驱数组不会越界
+    WW::_Skiplist<int, int> skiplist(WW::MAX_LEVEL_LIMIT * 2);
+    for (int i = 0; i < 10000; ++i) {
+        skiplist.insert({i, i});
+    }
+    EXPECT_EQ(skiplist.size(), 10000);
+    EXPECT_EQ(skiplist.at(9999), 9999);
+
+    WW::_Skiplist<int, int> single(0);
+    single.insert({1, 1});
+    single.insert({2, 2});
+    EXPECT_EQ(single.erase(1), 1);
+    EXPECT_EQ(single.at(2), 2);
+}
+
+TEST_F(SkipListTest, SortedBuilder)
+{
+    _Skiplist.insert({"z", "z"});
+
+    {
+        // 构建器会清空已有内容
+        WW::_Skiplist<std::string, std::string>::sorted_builder builder(_Skiplist);
+        builder.append({"a", "1"});
+        builder.append({"b", "2"});
+        builder.append({"c", "3"});
+        EXPECT_THROW(builder.append({"b", "4"}), std::invalid_argument);
+    }
+
+    EXPECT_EQ(_Skiplist.size(), 3);
+    EXPECT_FALSE(_Skiplist.contains("z"));
+    EXPECT_EQ(_Skiplist.at("b"), "2");
+
+    // 构建后可以正常插入和删除
+    _Skiplist.insert({"bb", "5"});
+    EXPECT_EQ(_Skiplist.erase("a"), 1);
+
+    std::string keys;
+    for (const auto & pair : _Skiplist) {
+        keys += pair.first;
+    }
+    EXPECT_EQ(keys, "bbbc");
+
+    keys.clear();
+    for (auto it = _Skiplist.rbegin(); it != _Skiplist.rend(); ++it) {
+        keys += it->first;
+    }
+    EXPECT_EQ(keys, "cbbb");
+}
+
+TEST(SkipListCompareTest, CustomCompare)
+{
+    // 降序排列
+    WW::_Skiplist<int, int, std::greater<int>> skiplist;
+    for (int i = 0; i < 10; ++i) {
+        skiplist.insert({i, i * 10});
+    }
+    EXPECT_FALSE(skiplist.insert({5, 0}).second);
+
+    int expected = 9;
+    for (const auto & pair : skiplist) {
+        EXPECT_EQ(pair.first, expected--);
+    }
+    EXPECT_EQ(skiplist.lower_bound(4)->first, 4);
+    EXPECT_EQ(skiplist.erase(4), 1);
+    EXPECT_EQ(skiplist.lower_bound(4)->first, 3);
+}
+
+TEST(SkipListCompareTest, TransparentLookup)
+{
+    WW::_Skiplist<std::string, int, std::less<>> skiplist;
+    skiplist.insert({"apple", 1});
+    skiplist.insert({"banana", 2});
+    skiplist.insert({"cherry", 3});
+
+    // 使用string_view和C字符串查找，不构造临时的std::string
+    std::string_view key = "banana split";
+    EXPECT_EQ(skiplist.find(key.substr(0, 6))->second, 2);
+    EXPECT_TRUE(skiplist.contains("cherry"));
+    EXPECT_FALSE(skiplist.contains(std::string_view("durian")));
+    EXPECT_EQ(skiplist.lower_bound(std::string_view("b"))->first, "banana");
+
+    EXPECT_EQ(skiplist.erase(std::string_view("apple")), 1);
+    EXPECT_EQ(skiplist.erase("apple"), 0);
+    EXPECT_EQ(skiplist.size(), 2);
+
+    // 按迭代器删除仍然可用
+    skiplist.erase(skiplist.begin());
+    EXPECT_EQ(skiplist.begin()->first, "cherry");
+}
+
+TEST(SkipListRangeTest, Bounds)
+{
+    WW::_Skiplist<int, int> skiplist;
+    for (int i = 0; i < 100; i += 10) {
+        skiplist.insert({i, i});
+    }
+
+    EXPECT_EQ(skiplist.lower_bound(20)->first, 20);
+    EXPECT_EQ(skiplist.upper_bound(20)->first, 30);
+    EXPECT_EQ(skiplist.lower_bound(25)->first, 30);
+    EXPECT_EQ(skiplist.upper_bound(25)->first, 30);
+    EXPECT_EQ(skiplist.lower_bound(-1)->first, 0);
+    EXPECT_EQ(skiplist.upper_bound(90), skiplist.end());
+    EXPECT_EQ(skiplist.lower_bound(91), skiplist.end());
+
+    auto range = skiplist.equal_range(40);
+    EXPECT_EQ(range.first->first, 40);
+    EXPECT_EQ(range.second->first, 50);
+
+    range = skiplist.equal_range(45);
+    EXPECT_EQ(range.first, range.second);
+    EXPECT_EQ(range.first->first, 50);
+
+    range = skiplist.equal_range(100);
+    EXPECT_EQ(range.first, skiplist.end());
+    EXPECT_EQ(range.second, skiplist.end());
+}
+
+TEST(SkipListEraseTest, EraseWhileIterating)
+{
+    WW::_Skiplist<int, int> skiplist;
+    for (int i = 0; i < 1000; ++i) {
+        skiplist.insert({i, i});
+    }
+
+    for (auto it = skiplist.begin(); it != skiplist.end();) {
+        if (it->first % 3 == 0) {
+            it = skiplist.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    EXPECT_EQ(skiplist.size(), 666);
+    for (int i = 0; i < 1000; ++i) {
+        EXPECT_EQ(skiplist.contains(i), i % 3 != 0);
+    }
+
+    // 删除后仍然可以正常插入
+    skiplist.insert({3, 3});
+    EXPECT_EQ(skiplist.find(3)->second, 3);
+}
+
+TEST(SkipListEraseTest, EraseRange)
+{
+    WW::_Skiplist<int, int> skiplist;
+    for (int i = 0; i < 1000; ++i) {
+        skiplist.insert({i, i});
+    }
+
+    auto it = skiplist.erase(skiplist.lower_bound(100), skiplist.lower_bound(900));
+    EXPECT_EQ(it->first, 900);
+    EXPECT_EQ(skiplist.size(), 200);
+    EXPECT_FALSE(skiplist.contains(100));
+    EXPECT_FALSE(skiplist.contains(899));
+    EXPECT_TRUE(skiplist.contains(99));
+    EXPECT_EQ((++skiplist.find(99))->first, 900);
+
+    // 空范围
+    it = skiplist.erase(skiplist.find(50), skiplist.find(50));
+    EXPECT_EQ(it->first, 50);
+    EXPECT_EQ(skiplist.size(), 200);
+
+    // 删除到末尾
+    it = skiplist.erase(skiplist.find(950), skiplist.end());
+    EXPECT_EQ(it, skiplist.end());
+    EXPECT_EQ(skiplist.size(), 150);
+
+    skiplist.erase(skiplist.begin(), skiplist.end());
+    EXPECT_TRUE(skiplist.empty());
+    EXPECT_EQ(skiplist.begin(), skiplist.end());
+
+    skiplist.insert({1, 1});
+    EXPECT_EQ(skiplist.size(), 1);
+}
+
+template <typename _Key, typename _Make>
+void check_erase_range_keeps_ranks(_Make make)
+{
+    WW::_Skiplist<_Key, int> skiplist;
+    std::map<_Key, int> expected;
+    std::mt19937 random(7);
+
+    for (int i = 0; i < 5000; ++i) {
+        skiplist.insert({make(i), i});
+        expected.emplace(make(i), i);
+    }
+
+    while (expected.size() > 10) {
+        auto first = std::next(expected.begin(), random() % expected.size());
+        auto last = first;
+        for (std::size_t count = random() % 200; count > 0 && last != expected.end(); --count) {
+            ++last;
+        }
+
+        auto it = skiplist.erase(skiplist.find(first->first), last == expected.end() ? skiplist.end() : skiplist.find(last->first));
+        expected.erase(first, last);
+        EXPECT_EQ(it == skiplist.end(), last == expected.end());
+        ASSERT_EQ(skiplist.size(), expected.size());
+
+        // 拼接后每一层的跨度和向后指针都要正确
+        std::size_t index = 0;
+        for (const auto & pair : expected) {
+            ASSERT_EQ(skiplist.rank(pair.first), index);
+            ASSERT_EQ(skiplist.select(index)->first, pair.first);
+            ++index;
+        }
+        EXPECT_TRUE(std::equal(skiplist.rbegin(), skiplist.rend(), expected.rbegin(), expected.rend()));
+    }
+}
+
+TEST(SkipListEraseTest, EraseRangeKeepsRanks)
+{
+    check_erase_range_keeps_ranks<int>([](int i) { return i; });
+    check_erase_range_keeps_ranks<std::string>([](int i) { return "key" + std::to_string(i); });
+}
+
+TEST(SkipListIteratorTest, Bidirectional)
+{
+    WW::_Skiplist<int, int> skiplist;
+    EXPECT_EQ(skiplist.rbegin(), skiplist.rend());
+
+    for (int i = 0; i < 100; ++i) {
+        skiplist.insert({(i * 37) % 100, i});
+    }
+
+    int expected = 99;
+    for (auto it = skiplist.rbegin(); it != skiplist.rend(); ++it) {
+        EXPECT_EQ(it->first, expected--);
+    }
+    EXPECT_EQ(expected, -1);
+
+    auto it = skiplist.end();
+    --it;
+    EXPECT_EQ(it->first, 99);
+    EXPECT_EQ((it--)->first, 99);
+    EXPECT_EQ(it->first, 98);
+    EXPECT_EQ((--skiplist.find(50))->first, 49);
+
+    // 删除首尾后向后指针仍然正确
+    skiplist.erase(99);
+    skiplist.erase(skiplist.begin());
+    skiplist.erase(skiplist.find(10), skiplist.find(90));
+    EXPECT_EQ(skiplist.rbegin()->first, 98);
+    EXPECT_EQ((--skiplist.find(90))->first, 9);
+    EXPECT_EQ(std::prev(skiplist.end(), skiplist.size())->first, 1);
+
+    skiplist.clear();
+    EXPECT_EQ(skiplist.rbegin(), skiplist.rend());
+    skiplist.insert({1, 1});
+    EXPECT_EQ(skiplist.rbegin()->first, 1);
+}
+
+TEST(SkipListRankTest, RankAndSelect)
+{
+    WW::_Skiplist<int, int> skiplist;
+    std::map<int, int> reference;
+
+    // 随机插入和删除，与有序容器逐个对比排名
+    std::srand(7);
+    for (int i = 0; i < 5000; ++i) {
+        int key = std::rand() % 2000;
+        if (std::rand() % 3 == 0) {
+            EXPECT_EQ(skiplist.erase(key), reference.erase(key));
+        } else {
+            skiplist.insert({key, i});
+            reference.insert({key, i});
+        }
+    }
+
+    // 范围删除
+    skiplist.erase(skiplist.lower_bound(500), skiplist.lower_bound(700));
+    reference.erase(reference.lower_bound(500), reference.lower_bound(700));
+    ASSERT_EQ(skiplist.size(), reference.size());
+
+    std::size_t index = 0;
+    for (const auto & pair : reference) {
+        EXPECT_EQ(skiplist.rank(pair.first), index);
+        EXPECT_EQ(skiplist.select(index)->first, pair.first);
+        ++index;
+    }
+    EXPECT_EQ(skiplist.select(index), skiplist.end());
+    EXPECT_EQ(skiplist.rank(-1), 0);
+    EXPECT_EQ(skiplist.rank(5000), reference.size());
+
+    auto expected = std::distance(reference.lower_bound(100), reference.lower_bound(1500));
+    EXPECT_EQ(skiplist.count_range(100, 1500), static_cast<std::size_t>(expected));
+    EXPECT_EQ(skiplist.count_range(1500, 100), 0);
+}
+
+TEST(SkipListRankTest, SortedBuilder)
+{
+    WW::_Skiplist<int, int> skiplist;
+
+    {
+        WW::_Skiplist<int, int>::sorted_builder builder(skiplist);
+        for (int i = 0; i < 1000; ++i) {
+            builder.append({i * 2, i});
+        }
+    }
+
+    for (int i = 0; i < 1000; ++i) {
+        EXPECT_EQ(skiplist.rank(i * 2), i);
+        EXPECT_EQ(skiplist.select(i)->first, i * 2);
+    }
+
+    // 构建后插入和删除仍然维护跨度
+    skiplist.insert({1, 0});
+    skiplist.erase(10);
+    EXPECT_EQ(skiplist.rank(1), 1);
+    EXPECT_EQ(skiplist.rank(12), 6);
+    EXPECT_EQ(skiplist.select(6)->first, 12);
+    EXPECT_EQ(skiplist.select(999)->first, 1998);
+}
+
+TEST(SkipListFingerTest, MatchesPlainSearch)
+{
+    WW::_Skiplist<int, int> skiplist;
+    WW::_Skiplist<int, int>::finger insert_finger;
+
+    // 升序批次中穿插已存在的键
+    for (int i = 0; i < 3000; i += 3) {
+        skiplist.insert({i, i}, insert_finger);
+    }
+    for (int i = 0; i < 3000; i += 2) {
+        skiplist.insert({i, -i}, insert_finger);
+    }
+
+    EXPECT_EQ(skiplist.size(), 2000);
+    std::size_t index = 0;
+    for (const auto & pair : skiplist) {
+        EXPECT_EQ(skiplist.rank(pair.first), index++);
+        EXPECT_EQ(pair.second, pair.first % 3 == 0 ? pair.first : -pair.first);
+    }
+
+    // 键不是升序时仍然正确
+    WW::_Skiplist<int, int>::finger find_finger;
+    for (int key : {2998, 10, 11, 12, 5, 3000, 0, 0}) {
+        EXPECT_EQ(skiplist.find(key, find_finger), skiplist.find(key));
+    }
+
+    WW::_Skiplist<int, int>::finger erase_finger;
+    std::size_t erased = 0;
+    for (int i = 0; i < 3000; ++i) {
+        erased += skiplist.erase(i * 7 % 3000 < 1500 ? i : -1, erase_finger);
+    }
+
+    EXPECT_EQ(skiplist.size(), 2000 - erased);
+    index = 0;
+    for (const auto & pair : skiplist) {
+        EXPECT_EQ(skiplist.select(index++)->first, pair.first);
+        EXPECT_GE(pair.first * 7 % 3000, 1500);
+    }
+}
+
+namespace
+{
+
+/**
+ * @brief 记录拷贝次数的值
+ */
+struct tracked
+{
+    static int copies;
+
+    int value;
+
+    tracked(int value = 0) : value(value) {}
+    tracked(const tracked & other) : value(other.value) { ++copies; }
+    tracked(tracked && other) noexcept : value(other.value) {}
+    tracked & operator=(const tracked & other) { value = other.value; ++copies; return *this; }
+    tracked & operator=(tracked && other) noexcept { value = other.value; return *this; }
+};
+
+int tracked::copies = 0;
+
+} // namespace
+
+TEST(SkipListEmplaceTest, ConstructInPlace)
+{
+    WW::_Skiplist<int, tracked> skiplist;
+    tracked::copies = 0;
+
+    auto result = skiplist.emplace(1, 10);
+    EXPECT_TRUE(result.second);
+    EXPECT_EQ(result.first->second.value, 10);
+
+    EXPECT_FALSE(skiplist.emplace(1, 11).second);
+    EXPECT_EQ(skiplist.find(1)->second.value, 10);
+
+    EXPECT_TRUE(skiplist.try_emplace(2, 20).second);
+    EXPECT_FALSE(skiplist.try_emplace(2, 21).second);
+    EXPECT_EQ(skiplist.find(2)->second.value, 20);
+
+    EXPECT_TRUE(skiplist.insert_or_assign(3, tracked(30)).second);
+    EXPECT_FALSE(skiplist.insert_or_assign(3, tracked(31)).second);
+    EXPECT_EQ(skiplist.find(3)->second.value, 31);
+
+    EXPECT_TRUE(skiplist.insert({4, tracked(40)}).second);
+    skiplist[5].value = 50;
+
+    EXPECT_EQ(tracked::copies, 0);
+    EXPECT_EQ(skiplist.size(), 5);
+    EXPECT_EQ(skiplist.rank(5), 4);
+
+    // 键已经存在时不会移动参数
+    std::string value(100, 'x');
+    WW::_Skiplist<std::string, std::string> strings;
+    strings.try_emplace("a", std::move(value));
+    value.assign(100, 'y');
+    EXPECT_FALSE(strings.try_emplace("a", std::move(value)).second);
+    EXPECT_EQ(value, std::string(100, 'y'));
+    EXPECT_EQ(strings.find("a")->second, std::string(100, 'x'));
+}
+
+TEST(SkipListLevelTest, Distribution)
+{
+    // 末尾0的个数除以k
+    EXPECT_EQ(WW::level_distribution::half()(0b1000, 15), 3);
+    EXPECT_EQ(WW::level_distribution::quarter()(0b1000, 15), 1);
+    EXPECT_EQ(WW::level_distribution::quarter()(0b10000, 15), 2);
+    EXPECT_EQ(WW::level_distribution::half()(0, 15), 15);
+
+    for (const WW::level_distribution & distribution : {
+             WW::level_distribution::half(),
+             WW::level_distribution::quarter(),
+             WW::level_distribution::inverse_e(),
+             WW::level_distribution(0.3)}) {
+        WW::_Xorshift_random random(42);
+        const int samples = 200000;
+        int promoted = 0;
+        int twice = 0;
+
+        for (int i = 0; i < samples; ++i) {
+            int level = distribution(random(), 15);
+            EXPECT_LE(level, 15);
+            promoted += level >= 1;
+            twice += level >= 2;
+        }
+
+        double p = distribution.probability();
+        EXPECT_NEAR(static_cast<double>(promoted) / samples, p, 0.01);
+        EXPECT_NEAR(static_cast<double>(twice) / samples, p * p, 0.01);
+    }
+}
+
+TEST(SkipListLevelTest, SeededSequence)
+{
+    WW::seed_level_random(7);
+    std::vector<std::uint64_t> first;
+    for (int i = 0; i < 16; ++i) {
+        first.push_back(WW::_Xorshift_random::local()());
+    }
+
+    WW::seed_level_random(7);
+    for (int i = 0; i < 16; ++i) {
+        EXPECT_EQ(WW::_Xorshift_random::local()(), first[i]);
+    }
+}
+
+TEST(SkipListLevelTest, TunedProbability)
+{
+    for (double p : {0.25, 0.36787944117144233}) {
+        WW::_Skiplist<int, int> skiplist;
+        skiplist.set_level_distribution(WW::level_distribution(p));
+        EXPECT_EQ(skiplist.get_level_distribution().probability(), p);
+
+        std::map<int, int> expected;
+        for (int i = 0; i < 5000; ++i) {
+            int key = i * 7919 % 3001;
+            if (i % 4 == 3) {
+                EXPECT_EQ(skiplist.erase(key), expected.erase(key));
+            } else {
+                EXPECT_EQ(skiplist.insert({key, i}).second, expected.insert({key, i}).second);
+            }
+        }
+
+        ASSERT_EQ(skiplist.size(), expected.size());
+        std::size_t index = 0;
+        for (const auto & pair : expected) {
+            EXPECT_EQ(skiplist.rank(pair.first), index);
+            EXPECT_EQ(skiplist.select(index)->second, pair.second);
+            ++index;
+        }
+
+        // 非1/2^k的概率下批量构建随机生成层级
+        WW::_Skiplist<int, int> built;
+        built.set_level_distribution(WW::level_distribution(p));
+        {
+            WW::_Skiplist<int, int>::sorted_builder builder(built);
+            for (const auto & pair : expected) {
+                builder.append(pair);
+            }
+        }
+        EXPECT_EQ(built.size(), expected.size());
+        EXPECT_EQ(built.rank(expected.rbegin()->first), expected.size() - 1);
+    }
+}
+
+TEST(SkipListLevelTest, LimitGrowsWithSize)
+{
+    WW::_Skiplist<int, int> skiplist;
+    EXPECT_EQ(skiplist.level_limit(), 2);
+
+    // floor(log2(n)) + 2
+    for (int i = 0; i < 1000; ++i) {
+        skiplist.insert({i, i});
+    }
+    EXPECT_EQ(skiplist.level_limit(), 11);
+
+    // 删除时不降低
+    for (int i = 0; i < 990; ++i) {
+        skiplist.erase(i);
+    }
+    EXPECT_EQ(skiplist.level_limit(), 11);
+
+    skiplist.set_level_distribution(WW::level_distribution::quarter());
+    EXPECT_EQ(skiplist.level_limit(), 3);
+
+    skiplist.clear();
+    EXPECT_EQ(skiplist.level_limit(), 2);
+
+    // 不超过构造时指定的最大层级
+    WW::_Skiplist<int, int> bounded(4);
+    for (int i = 0; i < 1000; ++i) {
+        bounded.insert({i, i});
+    }
+    EXPECT_EQ(bounded.level_limit(), 4);
+
+    // 批量构建同样增长
+    WW::_Skiplist<int, int> built;
+    {
+        WW::_Skiplist<int, int>::sorted_builder builder(built);
+        for (int i = 0; i < 1024; ++i) {
+            builder.append({i, i});
+        }
+    }
+    EXPECT_EQ(built.level_limit(), 12);
+}
+
+/**
+ * @brief 与std::less等价但不是std::less，跳表按通用方式比较
+ */
+struct plain_less
+{
+    template <typename _Ty>
+    bool operator()(const _Ty & _Left, const _Ty & _Right) const
+    {
+        return _Left < _Right;
+    }
+};
+
+TEST(SkipListKeyCacheTest, MatchesMap)
+{
+    // 缓存的键以最大值表示没有向前节点，最大值本身也要能正确查找
+    WW::_Skiplist<std::uint64_t, int> skiplist;
+    std::map<std::uint64_t, int> expected;
+    std::srand(7);
+
+    auto random_key = []() -> std::uint64_t {
+        std::uint64_t key = (static_cast<std::uint64_t>(std::rand()) << 33) ^ static_cast<std::uint64_t>(std::rand());
+        switch (std::rand() % 8) {
+        case 0: return std::uint64_t(0);
+        case 1: return UINT64_MAX;
+        case 2: return key | (1ull << 63);
+        default: return key % 5000;
+        }
+    };
+
+    for (int i = 0; i < 20000; ++i) {
+        std::uint64_t key = random_key();
+
+        if (std::rand() % 3 == 0) {
+            EXPECT_EQ(skiplist.erase(key), expected.erase(key));
+        } else {
+            EXPECT_EQ(skiplist.insert({key, i}).second, expected.insert({key, i}).second);
+        }
+
+        std::uint64_t probe = random_key();
+        auto it = skiplist.lower_bound(probe);
+        auto map_it = expected.lower_bound(probe);
+        if (map_it == expected.end()) {
+            EXPECT_EQ(it, skiplist.end());
+        } else {
+            ASSERT_NE(it, skiplist.end());
+            EXPECT_EQ(it->first, map_it->first);
+        }
+
+        EXPECT_EQ(skiplist.contains(probe), expected.count(probe) == 1);
+    }
+
+    ASSERT_EQ(skiplist.size(), expected.size());
+    EXPECT_TRUE(std::equal(skiplist.begin(), skiplist.end(), expected.begin()));
+
+    // 插入时记录的排名保持跨度正确
+    std::size_t rank = 0;
+    for (const auto & pair : expected) {
+        EXPECT_EQ(skiplist.rank(pair.first), rank);
+        EXPECT_EQ(skiplist.select(rank)->first, pair.first);
+        ++rank;
+    }
+}
+
+TEST(SkipListKeyCacheTest, SignedKeys)
+{
+    WW::_Skiplist<std::int64_t, int> cached;
+    WW::_Skiplist<std::int64_t, int, plain_less> generic;
+
+    for (std::int64_t key = -3000; key <= 3000; key += 3) {
+        cached.insert({key, 0});
+        generic.insert({key, 0});
+    }
+    cached.insert({INT64_MIN, 0});
+    cached.insert({INT64_MAX, 0});
+    generic.insert({INT64_MIN, 0});
+    generic.insert({INT64_MAX, 0});
+
+    for (std::int64_t probe = -3010; probe <= 3010; ++probe) {
+        auto it = cached.lower_bound(probe);
+        auto generic_it = generic.lower_bound(probe);
+        ASSERT_NE(it, cached.end());
+        EXPECT_EQ(it->first, generic_it->first);
+        EXPECT_EQ(cached.rank(probe), generic.rank(probe));
+    }
+
+    EXPECT_EQ(cached.lower_bound(INT64_MIN)->first, INT64_MIN);
+    EXPECT_EQ(cached.lower_bound(INT64_MAX)->first, INT64_MAX);
+}
+
+TEST(SkipListKeyCacheTest, BuilderAndClear)
+{
+    WW::_Skiplist<std::uint32_t, int> skiplist;
+    {
+        WW::_Skiplist<std::uint32_t, int>::sorted_builder builder(skiplist);
+        for (std::uint32_t key = 0; key < 4096; key += 2) {
+            builder.append({key, 0});
+        }
+    }
+
+    for (std::uint32_t key = 0; key < 4096; ++key) {
+        EXPECT_EQ(skiplist.contains(key), key % 2 == 0);
+    }
+
+    skiplist.clear();
+    EXPECT_FALSE(skiplist.contains(0));
+
+    skiplist.insert({5, 0});
+    EXPECT_EQ(skiplist.lower_bound(1)->first, 5);
+    EXPECT_EQ(skiplist.lower_bound(6), skiplist.end());
+}
+
+TEST(SkipListKeyCacheTest, StringPrefixes)
+{
+    // 前缀相同、短于8个字节以及包含'\0'和'\xff'的键，缓存的前缀相等时要比较完整的键
+    WW::_Skiplist<std::string, int> skiplist;
+    std::map<std::string, int> expected;
+    std::srand(11);
+
+    const std::string alphabet("\0\x01\x7f\x80\xff" "ab", 7);
+    auto random_key = [&alphabet]() {
+        std::string key;
+        switch (std::rand() % 3) {
+        case 0: key = "prefix__"; break;
+        case 1: key = std::string(8, '\xff'); break;
+        default: break;
+        }
+
+        for (int length = std::rand() % 12; length > 0; --length) {
+            key.push_back(alphabet[std::rand() % alphabet.size()]);
+        }
+        return key;
+    };
+
+    for (int i = 0; i < 20000; ++i) {
+        std::string key = random_key();
+
+        if (std::rand() % 3 == 0) {
+            EXPECT_EQ(skiplist.erase(key), expected.erase(key));
+        } else {
+            EXPECT_EQ(skiplist.insert({key, i}).second, expected.insert({key, i}).second);
+        }
+
+        std::string probe = random_key();
+        auto it = skiplist.lower_bound(probe);
+        auto map_it = expected.lower_bound(probe);
+        if (map_it == expected.end()) {
+            EXPECT_EQ(it, skiplist.end());
+        } else {
+            ASSERT_NE(it, skiplist.end());
+            EXPECT_EQ(it->first, map_it->first);
+        }
+
+        EXPECT_EQ(skiplist.contains(probe), expected.count(probe) == 1);
+        EXPECT_EQ(skiplist.rank(probe), static_cast<std::size_t>(std::distance(expected.begin(), map_it)));
+    }
+
+    ASSERT_EQ(skiplist.size(), expected.size());
+    EXPECT_TRUE(std::equal(skiplist.begin(), skiplist.end(), expected.begin()));
+}
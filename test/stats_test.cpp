@@ -0,0 +1,139 @@
+// 整个测试程序都打开统计，与其他测试程序互不影响
+#ifndef WW_KVSTORE_STATS
+#define WW_KVSTORE_STATS
+#endif
+
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <KVStore.h>
+
+using lock_free_store = WW::KVStore<std::string, std::string, std::less<std::string>,
+                                    std::allocator<std::pair<const std::string, std::string>>, WW::lock_free_policy>;
+
+TEST(StatsTest, CountsOperations)
+{
+    WW::KVStore<std::string, std::string> store;
+
+    store.put("a", "1");
+    store.put("b", "2");
+    store.update("a", "3");
+    store.get("a");
+    store.get("missing");
+    store.remove("b");
+
+    WW::kvstore_stats stats = store.stats();
+    EXPECT_TRUE(stats.enabled);
+    EXPECT_EQ(stats.gets, 2);
+    EXPECT_EQ(stats.puts, 3);
+    EXPECT_EQ(stats.removes, 1);
+    EXPECT_EQ(stats.hits, 1);
+    EXPECT_EQ(stats.misses, 1);
+
+    EXPECT_EQ(stats.get_latency.count, 2);
+    EXPECT_EQ(stats.put_latency.count, 3);
+    EXPECT_EQ(stats.remove_latency.count, 1);
+}
+
+TEST(StatsTest, SearchCost)
+{
+    WW::KVStore<int, int> store;
+    for (int i = 0; i < 1000; ++i) {
+        store.put(i, i);
+    }
+
+    WW::kvstore_stats before = store.stats();
+    for (int i = 0; i < 1000; ++i) {
+        store.get(i);
+    }
+    WW::kvstore_stats after = store.stats();
+
+    // 每次查询一次查找，平均比较次数约为O(log n)
+    std::uint64_t searches = after.searches - before.searches;
+    std::uint64_t comparisons = after.search_comparisons - before.search_comparisons;
+    EXPECT_EQ(searches, 1000);
+    EXPECT_GE(after.search_levels - before.search_levels, searches);
+    EXPECT_GT(comparisons, searches);
+    EXPECT_LT(comparisons / searches, 100);
+}
+
+TEST(StatsTest, StructureSnapshot)
+{
+    WW::KVStore<std::string, std::string> store;
+    for (int i = 0; i < 500; ++i) {
+        store.put("key" + std::to_string(i), std::string(100, 'v'));
+    }
+
+    WW::kvstore_stats stats = store.stats();
+    EXPECT_EQ(stats.size, 500);
+    EXPECT_EQ(std::accumulate(stats.tower_heights.begin(), stats.tower_heights.end(), std::uint64_t(0)), 500);
+
+    // 大约一半的节点只有一层
+    EXPECT_GT(stats.tower_heights[0], 150);
+    EXPECT_LT(stats.tower_heights[0], 350);
+
+    EXPECT_GE(stats.key_bytes, 500 * sizeof(std::string));
+    EXPECT_GE(stats.value_bytes, 500 * (sizeof(std::string) + 100));
+    EXPECT_GT(stats.tower_bytes, 0);
+}
+
+TEST(StatsTest, Percentile)
+{
+    WW::latency_snapshot latency;
+    latency.buckets[3] = 90;      // [4, 8)
+    latency.buckets[10] = 10;     // [512, 1024)
+    latency.count = 100;
+
+    EXPECT_EQ(latency.percentile(50), 8);
+    EXPECT_EQ(latency.percentile(90), 8);
+    EXPECT_EQ(latency.percentile(99), 1024);
+    EXPECT_EQ(WW::latency_snapshot().percentile(99), 0);
+}
+
+TEST(StatsTest, Prometheus)
+{
+    WW::KVStore<std::string, std::string> store;
+    store.put("a", "1");
+    store.get("a");
+    store.get("b");
+
+    std::string text = WW::to_prometheus(store.stats());
+
+    EXPECT_NE(text.find("# TYPE ww_kvstore_operations_total counter\n"), std::string::npos);
+    EXPECT_NE(text.find("ww_kvstore_operations_total{op=\"get\"} 2\n"), std::string::npos);
+    EXPECT_NE(text.find("ww_kvstore_get_results_total{result=\"miss\"} 1\n"), std::string::npos);
+    EXPECT_NE(text.find("ww_kvstore_keys 1\n"), std::string::npos);
+    EXPECT_NE(text.find("ww_kvstore_operation_duration_seconds_bucket{op=\"get\",le=\"+Inf\"} 2\n"), std::string::npos);
+    EXPECT_NE(text.find("ww_kvstore_operation_duration_seconds_count{op=\"put\"} 1\n"), std::string::npos);
+}
+
+TEST(StatsTest, ConcurrentCounters)
+{
+    lock_free_store store;
+    const int threads = 4;
+    const int per_thread = 2000;
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&store, t] {
+            for (int i = 0; i < per_thread; ++i) {
+                std::string key = std::to_string(t) + ":" + std::to_string(i);
+                store.put(key, "v");
+                store.get_into(key, key);
+            }
+        });
+    }
+
+    for (std::thread & worker : workers) {
+        worker.join();
+    }
+
+    WW::kvstore_stats stats = store.stats();
+    EXPECT_EQ(stats.puts, threads * per_thread);
+    EXPECT_EQ(stats.gets, threads * per_thread);
+    EXPECT_EQ(stats.hits, threads * per_thread);
+    EXPECT_EQ(stats.size, threads * per_thread);
+}
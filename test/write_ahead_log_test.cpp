@@ -0,0 +1,351 @@
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <csignal>
+#include <sys/resource.h>
+#include <system_error>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+#include <KVStore.h>
+
+class WriteAheadLogTest : public testing::Test
+{
+protected:
+    std::string path;
+
+    void SetUp() override
+    {
+        path = testing::TempDir() + "ww_kvstore_wal_" + std::to_string(::getpid()) + ".log";
+        std::remove(path.c_str());
+    }
+
+    void TearDown() override
+    {
+        std::remove(path.c_str());
+    }
+
+    WW::wal_options options(WW::wal_sync_mode mode = WW::wal_sync_mode::batch) const
+    {
+        WW::wal_options result;
+        result.path = path;
+        result.sync_mode = mode;
+        return result;
+    }
+};
+
+TEST_F(WriteAheadLogTest, ReplayAfterReopen)
+{
+    {
+        WW::KVStore<std::string, std::string> store;
+        EXPECT_EQ(store.open(options()), 0);
+
+        EXPECT_TRUE(store.put("name", "Alice"));
+        EXPECT_TRUE(store.put("city", "NYC"));
+        EXPECT_FALSE(store.put("name", "Carol"));
+        EXPECT_TRUE(store.update("name", "Bob"));
+        EXPECT_TRUE(store.remove("city"));
+        EXPECT_FALSE(store.remove("unknown"));
+    }
+
+    // 没有产生修改的操作不写入日志
+    WW::KVStore<std::string, std::string> store;
+    EXPECT_EQ(store.open(options()), 4);
+    EXPECT_EQ(store.size(), 1);
+    EXPECT_EQ(store.get("name"), "Bob");
+    EXPECT_FALSE(store.contains("city"));
+}
+
+TEST_F(WriteAheadLogTest, ReplayBatch)
+{
+    {
+        WW::KVStore<int, int> store;
+        store.open(options());
+
+        EXPECT_EQ(store.multi_put({{3, 30}, {1, 10}, {2, 20}, {1, 11}}), 3);
+        EXPECT_EQ(store.multi_put({{1, 12}}), 0);
+        EXPECT_EQ(store.multi_remove({2, 4}), 1);
+    }
+
+    // 整批只记录实际生效的修改
+    WW::KVStore<int, int> store;
+    EXPECT_EQ(store.open(options()), 4);
+    EXPECT_EQ(store.size(), 2);
+    EXPECT_EQ(store.get(1), 10);
+    EXPECT_EQ(store.get(3), 30);
+}
+
+TEST_F(WriteAheadLogTest, TruncateTornTail)
+{
+    {
+        WW::KVStore<int, int> store;
+        store.open(options(WW::wal_sync_mode::none));
+        store.put(1, 10);
+        store.put(2, 20);
+    }
+
+    // 模拟写入一半时崩溃
+    std::FILE * file = std::fopen(path.c_str(), "ab");
+    ASSERT_NE(file, nullptr);
+    std::string record = WW::_Write_ahead_log::encode_set(3, 30);
+    std::fwrite(record.data(), 1, record.size() - 2, file);
+    std::fclose(file);
+
+    {
+        WW::KVStore<int, int> store;
+        EXPECT_EQ(store.open(options()), 2);
+        EXPECT_FALSE(store.contains(3));
+
+        // 截断后可以继续追加
+        store.put(4, 40);
+    }
+
+    WW::KVStore<int, int> store;
+    EXPECT_EQ(store.open(options()), 3);
+    EXPECT_EQ(store.get(4), 40);
+}
+
+TEST_F(WriteAheadLogTest, RejectCorruptedRecord)
+{
+    {
+        WW::KVStore<int, int> store;
+        store.open(options());
+        store.put(1, 10);
+        store.put(2, 20);
+    }
+
+    // 破坏第二条记录的负载
+    std::FILE * file = std::fopen(path.c_str(), "r+b");
+    ASSERT_NE(file, nullptr);
+    std::size_t record_size = WW::_Write_ahead_log::encode_set(1, 10).size();
+    std::fseek(file, static_cast<long>(record_size + WW::_Write_ahead_log::HEADER_SIZE), SEEK_SET);
+    std::fputc(0x7F, file);
+    std::fclose(file);
+
+    WW::KVStore<int, int> store;
+    EXPECT_EQ(store.open(options()), 1);
+    EXPECT_TRUE(store.contains(1));
+    EXPECT_FALSE(store.contains(2));
+}
+
+TEST_F(WriteAheadLogTest, GroupCommit)
+{
+    const int threads = 8;
+    const int per_thread = 200;
+
+    {
+        WW::KVStore<int, int, std::less<int>, std::allocator<std::pair<const int, int>>, WW::lock_free_policy> store;
+        store.open(options());
+
+        std::vector<std::thread> writers;
+        for (int t = 0; t < threads; ++t) {
+            writers.emplace_back([&store, t, threads, per_thread] {
+                for (int i = 0; i < per_thread; ++i) {
+                    store.put(i * threads + t, t);
+                }
+            });
+        }
+        for (auto & writer : writers) {
+            writer.join();
+        }
+    }
+
+    WW::KVStore<int, int> store;
+    EXPECT_EQ(store.open(options()), static_cast<std::size_t>(threads * per_thread));
+    EXPECT_EQ(store.size(), static_cast<std::size_t>(threads * per_thread));
+}
+
+TEST_F(WriteAheadLogTest, ContendedPutAndRemove)
+{
+    using lock_free_store = WW::KVStore<int, int, std::less<int>, std::allocator<std::pair<const int, int>>, WW::lock_free_policy>;
+    const int threads = 8;
+    const int keys = 2;
+    std::vector<std::optional<int>> live(keys);
+
+    {
+        lock_free_store store;
+        store.open(options(WW::wal_sync_mode::none));
+
+        // 所有线程争用相同的几个键，插入和删除交替进行
+        std::vector<std::thread> writers;
+        for (int t = 0; t < threads; ++t) {
+            writers.emplace_back([&store, t] {
+                for (int i = 0; i < 2000; ++i) {
+                    int key = (i + t) % keys;
+                    if ((i + t) % 3 == 0) {
+                        store.remove(key);
+                    } else {
+                        store.put(key, t);
+                    }
+                }
+            });
+        }
+        for (auto & writer : writers) {
+            writer.join();
+        }
+
+        for (int key = 0; key < keys; ++key) {
+            live[key] = store.get(key);
+        }
+    }
+
+    // 重放后与重启前的内容完全一致
+    lock_free_store store;
+    store.open(options());
+    for (int key = 0; key < keys; ++key) {
+        EXPECT_EQ(store.get(key), live[key]) << key;
+    }
+}
+
+/**
+ * @brief 在指定线程的第`pause_at`次比较中暂停，直到被放行
+ */
+struct pausing_less
+{
+    static thread_local int compares;
+    static thread_local int pause_at;
+    static std::atomic<bool> paused;
+    static std::atomic<bool> released;
+
+    bool operator()(int left, int right) const
+    {
+        if (++compares == pause_at) {
+            paused = true;
+            while (!released) {
+                std::this_thread::yield();
+            }
+        }
+        return left < right;
+    }
+};
+
+thread_local int pausing_less::compares = 0;
+thread_local int pausing_less::pause_at = 0;
+std::atomic<bool> pausing_less::paused{false};
+std::atomic<bool> pausing_less::released{false};
+
+TEST_F(WriteAheadLogTest, RemoveDuringPut)
+{
+    using lock_free_store = WW::KVStore<int, int, pausing_less, std::allocator<std::pair<const int, int>>, WW::lock_free_policy>;
+    bool live = false;
+
+    {
+        lock_free_store store;
+        store.open(options());
+        store.put(1, 1);
+
+        // 插入在确认键已存在的最后一次比较中暂停，期间另一个线程删除同一个键
+        std::atomic<bool> put_done{false};
+        std::thread writer([&store, &put_done] {
+            pausing_less::compares = 0;
+            store.contains(1);
+            pausing_less::pause_at = pausing_less::compares;
+            pausing_less::compares = 0;
+            store.put(1, 2);
+            put_done = true;
+        });
+        while (!pausing_less::paused && !put_done) {
+            std::this_thread::yield();
+        }
+
+        std::atomic<bool> removed{false};
+        std::thread remover([&store, &removed] {
+            store.remove(1);
+            removed = true;
+        });
+
+        // 插入已经进入日志的顺序执行时，删除要等插入完成，超时后放行
+        for (int i = 0; i < 100 && !removed; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        pausing_less::released = true;
+        writer.join();
+        remover.join();
+
+        live = store.contains(1);
+    }
+
+    lock_free_store store;
+    store.open(options());
+    EXPECT_EQ(store.contains(1), live);
+}
+
+TEST_F(WriteAheadLogTest, PeriodicSync)
+{
+    WW::wal_options periodic = options(WW::wal_sync_mode::periodic);
+    periodic.sync_interval = std::chrono::milliseconds(1);
+
+    {
+        WW::KVStore<std::string, std::string> store;
+        store.open(periodic);
+        for (int i = 0; i < 100; ++i) {
+            store.put(std::to_string(i), std::to_string(i));
+        }
+    }
+
+    WW::KVStore<std::string, std::string> store;
+    EXPECT_EQ(store.open(periodic), 100);
+    EXPECT_EQ(store.get("42"), "42");
+}
+
+TEST_F(WriteAheadLogTest, FailedWriteIsNotApplied)
+{
+    WW::KVStore<int, int> store;
+    store.open(options());
+    ASSERT_TRUE(store.put(1, 10));
+
+    // 限制文件大小，之后的写入失败
+    std::size_t record_size = WW::_Write_ahead_log::encode_set(1, 10).size();
+    rlimit old_limit;
+    ASSERT_EQ(::getrlimit(RLIMIT_FSIZE, &old_limit), 0);
+    auto old_handler = std::signal(SIGXFSZ, SIG_IGN);
+    rlimit limit = old_limit;
+    limit.rlim_cur = static_cast<rlim_t>(record_size);
+    ASSERT_EQ(::setrlimit(RLIMIT_FSIZE, &limit), 0);
+
+    EXPECT_THROW(store.put(2, 20), std::system_error);
+    EXPECT_THROW(store.update(1, 11), std::system_error);
+
+    ::setrlimit(RLIMIT_FSIZE, &old_limit);
+    std::signal(SIGXFSZ, old_handler);
+
+    // 写入失败的修改没有生效
+    EXPECT_FALSE(store.contains(2));
+    EXPECT_EQ(store.get(1), 10);
+}
+
+TEST_F(WriteAheadLogTest, ReplayExpiry)
+{
+    using namespace std::chrono_literals;
+    {
+        WW::KVStore<std::string, std::string> store;
+        store.open(options());
+
+        for (int i = 0; i < 100; ++i) {
+            EXPECT_TRUE(store.put("k" + std::to_string(i), "v", 10ms));
+        }
+        EXPECT_TRUE(store.put("kept", "v", 1h));
+        EXPECT_TRUE(store.put("persisted", "v", 10ms));
+        EXPECT_TRUE(store.persist("persisted"));
+        EXPECT_TRUE(store.put("extended", "v"));
+        EXPECT_TRUE(store.expire("extended", 1h));
+        std::this_thread::sleep_for(30ms);
+
+        // 已过期但尚未清理的键被删除，同样要写入日志
+        EXPECT_FALSE(store.remove("k99"));
+    }
+
+    WW::KVStore<std::string, std::string> store;
+    store.open(options());
+    EXPECT_FALSE(store.contains("k99"));
+    EXPECT_FALSE(store.contains("k0"));
+    EXPECT_TRUE(store.ttl("kept").has_value());
+    EXPECT_TRUE(store.ttl("extended").has_value());
+    EXPECT_TRUE(store.contains("persisted"));
+    EXPECT_FALSE(store.ttl("persisted").has_value());
+}